@@ -1,12 +1,26 @@
 #include <iostream>
 #include <fstream>
+#include <cstdio>
 #include <algorithm>
 #include <numeric>
 #include <chrono>
 #include <random>
 #include <list>
+#include <forward_list>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <atomic>
 #include <cw/list.h>
-//#include <cw/list_algorithm.h>
+#include <cw/list_algorithm.h>
+#include <cw/forward_list.h>
+#include <cw/xor_list.h>
+#include <cw/adaptive_list.h>
+#include <cw/unrolled_list.h>
+#include <cw/concurrent_queue.h>
+#include <cw/snapshot_list.h>
+#include <cw/mapped_list.h>
+#include <cw/list_io.h>
 #include "logarithmic_range.h"
 
 using namespace std;
@@ -30,6 +44,9 @@ struct preallocate_enable {
 	// can't reserve a std::list
 	template<typename T>
 	void operator()( std::list<T>&, size_t ) {}
+
+	template<typename T>
+	void operator()( std::forward_list<T>&, size_t ) {}
 };
 
 struct preallocate_disable {
@@ -103,6 +120,20 @@ struct fill_mid {
 	}
 };
 
+// After -- create by insert_after at the midpoint, for forward lists.
+
+struct fill_after {
+	template<typename L>
+	void operator()( L& v, size_t N ) {
+		using T = L::value_type;
+		auto it = v.before_begin();
+		for(size_t i=0;i<N;++i) {
+			auto x = v.insert_after( it, T(i) );
+			if( i % 2 == 0 ) it = x;
+		}
+	}
+};
+
 // Back Random -- random values inserted at the back.
 
 struct fill_back_random {
@@ -137,6 +168,17 @@ struct fill_fb_random {
 	}
 };
 
+// Shuffled -- random values inserted at the back, then sorted by relinking,
+// so that list order is a random walk through memory.
+
+struct fill_shuffled {
+	template<typename L>
+	void operator()( L& v, size_t N ) {
+		fill_back_random()( v, N );
+		v.sort();
+	}
+};
+
 // Random Sorted -- insert random values, keeping list sorted.
 
 struct fill_random_sorted {
@@ -153,6 +195,69 @@ struct fill_random_sorted {
 	}
 };
 
+// Arena -- a bump allocator over a list of blocks.
+// Deallocation is a no-op, all memory is released at once by reset().
+
+struct arena {
+	vector<pair<unique_ptr<char[]>,size_t>> blocks;
+	size_t block_size = 1 << 24;
+	size_t current = 0;
+	size_t used = 0;
+
+	void* allocate( size_t bytes, size_t align ) {
+		while( current < blocks.size() ) {
+			size_t offset = ( used + align - 1 ) & ~( align - 1 );
+			if( offset + bytes <= blocks[current].second ) {
+				used = offset + bytes;
+				return blocks[current].first.get() + offset;
+			}
+			++current;
+			used = 0;
+		}
+		size_t size = max( block_size, bytes + align );
+		blocks.emplace_back( unique_ptr<char[]>( new char[size] ), size );
+		return allocate( bytes, align );
+	}
+
+	void reset() {
+		current = 0;
+		used = 0;
+	}
+};
+
+arena& default_arena() {
+	static arena a;
+	return a;
+}
+
+template<typename T>
+struct arena_allocator {
+	using value_type = T;
+
+	arena* a = &default_arena();
+
+	arena_allocator() = default;
+
+	template<typename T2>
+	arena_allocator( const arena_allocator<T2>& rhs ) : a(rhs.a) {}
+
+	T* allocate( size_t n ) {
+		return static_cast<T*>( a->allocate( n * sizeof(T), alignof(T) ) );
+	}
+
+	void deallocate( T*, size_t ) {}
+};
+
+template<typename T1,typename T2>
+bool operator==( const arena_allocator<T1>& lhs, const arena_allocator<T2>& rhs ) {
+	return lhs.a == rhs.a;
+}
+
+template<typename T1,typename T2>
+bool operator!=( const arena_allocator<T1>& lhs, const arena_allocator<T2>& rhs ) {
+	return !(lhs == rhs);
+}
+
 template<typename F>
 double time( F&& f ) {
 	auto t1 = hrc::now();
@@ -266,6 +371,58 @@ void test_list( vector<double>& times, size_t N, int repeat ) {
 
 }
 
+// erase every other element with erase_after
+template<typename L>
+double test_erase_after( L& v ) {
+	return time( [&]{
+		auto it = v.before_begin();
+		while( std::next(it) != end(v) ) {
+			it = v.erase_after( it );
+			if( it == end(v) ) break;
+		}
+	});
+}
+
+// push then pop n elements at the front
+template<typename L>
+double test_stack( L& v, size_t n, int N = 1 ) {
+	using T = typename L::value_type;
+	return time( [&]{
+		for(int i=0;i<N;++i) {
+			for(size_t j=0;j<n;++j) {
+				v.push_front( T(j) );
+			}
+			for(size_t j=0;j<n;++j) {
+				v.pop_front();
+			}
+		}
+	});
+}
+
+template<typename L,typename P>
+void test_forward( vector<double>& times, size_t N, int repeat ) {
+	L v;
+	double scale = 1.0e6;
+	double factor = scale / repeat;
+	times.push_back( time([&]{
+		v = create<L,fill_front,P>(N);
+	}) * scale );
+	times.push_back( test_accumulate( v, repeat ) * factor );
+	times.push_back( test_traversal( v, repeat ) * factor );
+	times.push_back( test_reverse( v, repeat ) * factor );
+	times.push_back( test_erase_after( v ) * scale );
+
+	times.push_back( time([&]{
+		v = create<L,fill_after,P>(N);
+	}) * scale );
+	times.push_back( test_accumulate( v, repeat ) * factor );
+	times.push_back( test_traversal( v, repeat ) * factor );
+	times.push_back( test_erase_after( v ) * scale );
+
+	L w;
+	times.push_back( test_stack( w, N, repeat ) * factor );
+}
+
 template<typename L,typename P>
 void test_random( vector<double>& times, size_t N ) {
 	L v;
@@ -275,6 +432,122 @@ void test_random( vector<double>& times, size_t N ) {
 	}) * scale );
 }
 
+template<typename L>
+void sort_container( L& v ) {
+	v.sort();
+}
+
+template<typename T>
+void sort_container( vector<T>& v ) {
+	sort( begin(v), end(v) );
+}
+
+template<typename L,typename P>
+void test_sort( vector<double>& times, size_t N ) {
+	L v = create<L,fill_back_random,P>(N);
+	double scale = 1.0e3;
+	times.push_back( time([&]{
+		sort_container( v );
+	}) * scale );
+}
+
+// radix sort through a key projection
+template<typename L,typename P>
+void test_sort_by_key( vector<double>& times, size_t N ) {
+	using T = typename L::value_type;
+	L v = create<L,fill_back_random,P>(N);
+	double scale = 1.0e3;
+	times.push_back( time([&]{
+		v.sort_by_key( []( const T& x ){ return uint64_t(x); } );
+	}) * scale );
+}
+
+// sort into sequential storage, then traverse
+template<typename L,typename P>
+void test_sort_compact( vector<double>& times, size_t N ) {
+	L v = create<L,fill_back_random,P>(N);
+	double scale = 1.0e3;
+	times.push_back( time([&]{
+		v.sort_compact();
+	}) * scale );
+	times.push_back( test_traversal( v ) * scale );
+}
+
+// create and destroy, then release any arena memory
+template<typename L,typename F,typename P>
+double test_create_destroy( size_t N, int repeat ) {
+	return time( [&]{
+		for(int i=0;i<repeat;++i) {
+			{
+				L v = create<L,F,P>(N);
+			}
+			default_arena().reset();
+		}
+	});
+}
+
+template<typename L,typename P>
+void test_alloc( vector<double>& times, size_t N, int repeat ) {
+	double factor = 1.0e6 / repeat;
+	times.push_back( test_create_destroy<L,fill_back,P>( N, repeat ) * factor );
+	times.push_back( test_create_destroy<L,fill_mid,P>( N, repeat ) * factor );
+	times.push_back( test_create_destroy<L,fill_fb_random,P>( N, repeat ) * factor );
+}
+
+// order-independent algorithms on the values, under an execution policy
+template<typename L,typename Policy>
+void test_scan( vector<double>& times, const L& v, const Policy& policy, int repeat ) {
+	using T = typename L::value_type;
+	double factor = 1.0e6 / repeat;
+	times.push_back( time([&]{
+		for(int i=0;i<repeat;++i) {
+			volatile uint64_t dont_optimize_me = cw::accumulate( policy, v, uint64_t(0) );
+		}
+	}) * factor );
+	times.push_back( time([&]{
+		for(int i=0;i<repeat;++i) {
+			volatile auto dont_optimize_me = cw::count_if( policy, v, []( T x ){ return x % 3 == 0; } );
+		}
+	}) * factor );
+	times.push_back( time([&]{
+		for(int i=0;i<repeat;++i) {
+			volatile T dont_optimize_me = *cw::min_element( policy, v );
+		}
+	}) * factor );
+}
+
+// bytes scanned per nanosecond by each value-scan kernel
+template<typename L,typename F>
+void test_kernel( vector<double>& times, const L& v, int repeat, F&& f ) {
+	double bytes = double( v.size() * sizeof( typename L::value_type ) ) * repeat;
+	times.push_back( bytes / ( time([&]{
+		for(int i=0;i<repeat;++i) {
+			f();
+		}
+	}) * 1.0e9 ) );
+}
+
+template<typename L>
+void test_kernels( vector<double>& times, const L& v, int repeat ) {
+	using T = typename L::value_type;
+	T absent = T(1);
+	test_kernel( times, v, repeat, [&]{ volatile auto dont_optimize_me = cw::count( v, absent ); } );
+	test_kernel( times, v, repeat, [&]{ volatile bool dont_optimize_me = cw::find( v, absent ) == v.end(); } );
+	test_kernel( times, v, repeat, [&]{ volatile T dont_optimize_me = *cw::min_element( v ); } );
+	test_kernel( times, v, repeat, [&]{ volatile auto dont_optimize_me = cw::accumulate( v, T(0) ); } );
+}
+
+template<typename L>
+void test_kernels_std( vector<double>& times, const L& v, int repeat ) {
+	using T = typename L::value_type;
+	T absent = T(1);
+	auto first = v.data(), last = v.data() + v.size();
+	test_kernel( times, v, repeat, [&]{ volatile auto dont_optimize_me = std::count( first, last, absent ); } );
+	test_kernel( times, v, repeat, [&]{ volatile bool dont_optimize_me = std::find( first, last, absent ) == last; } );
+	test_kernel( times, v, repeat, [&]{ volatile T dont_optimize_me = *std::min_element( first, last ); } );
+	test_kernel( times, v, repeat, [&]{ volatile auto dont_optimize_me = std::accumulate( first, last, T(0) ); } );
+}
+
 template<typename T,typename U,typename P>
 void benchmark( ofstream& out ) {
 	size_t maxN = numeric_limits<U>::max();
@@ -313,14 +586,16 @@ void benchmark( ofstream& out ) {
 
 }
 
+// std::forward_list against cw::forward_list
 template<typename T,typename U,typename P>
-void benchmark_random( ofstream& out ) {
-	size_t maxN = numeric_limits<U>::max();
+void benchmark_forward( ofstream& out ) {
+	size_t maxN = numeric_limits<U>::max() - 1;
 	size_t bits = sizeof(U) * 8;
 	size_t minN = ( bits > 8 ) ? ( 1 << (bits / 2) ) : 1;
-	size_t maxBytes = 1 << 20;
-	maxN = min( maxN, maxBytes / ( 2 * sizeof(void*) + (size_t)sqrt( 0.6 * sizeof(T) ) ) );
+	size_t maxBytes = 1 << 27;
+	maxN = min( maxN, maxBytes / ( sizeof(void*) + sizeof(T) ) );
 
+	size_t M = 6000000;
 	size_t maxIts = 1000;
 
 	vector<double> times;
@@ -329,114 +604,1250 @@ void benchmark_random( ofstream& out ) {
 	for( auto i : log_range( minN, maxN, maxIts, size_t(1) ) ) {
 		times.clear();
 		cout << i << endl;
-		test_random<vector<T>,P>( times, i );
-		test_random<std::list<T>,P>( times, i );
-		test_random<cw::list<T,U>,P>( times, i );
-		out << i << ",";
+		int repeat = int( max( M / i , size_t(1) ) );
+		test_forward<std::forward_list<T>,P>( times, i, repeat );
+		test_forward<cw::forward_list<T,U>,P>( times, i, repeat );
+
+		out << i << "," << repeat << ",";
 		for( auto t : times )
 			out << t << ",";
-
-		out << times[1] / times[2] << ",";
-		out << times[0] / times[1] << ",";
-		out << times[0] / times[2] << ",";
+		size_t nTests = times.size() / 2;
+		for(size_t j=0;j<nTests;++j)
+			out << times[j] / times[nTests + j] << ",";
 
 		out << endl;
 	}
-
 }
 
-void print_header( ofstream& out ) {
-	out << "size,"
-	       "repeat,"
+// std::list and cw::list against cw::xor_list.
+// the budget is that of benchmark(), spent on one link per element.
+template<typename T,typename U,typename P>
+void benchmark_xor( ofstream& out ) {
+	size_t maxN = numeric_limits<U>::max() - 1;
+	size_t bits = sizeof(U) * 8;
+	size_t minN = ( bits > 8 ) ? ( 1 << (bits / 2) ) : 1;
+	size_t maxBytes = 1 << 27;
+	maxN = min( maxN, maxBytes / ( sizeof(U) + sizeof(T) ) );
 
-		   "create_back vector,"
-		   "accumulate,"
-		   "adjacent_difference,"
+	size_t M = 6000000;
+	size_t maxIts = 1000;
 
-		   "create_back stdlist,"
-		   "accumulate,"
-		   "adjacent_difference,"
-		   "traversal,"
-		   "reverse,"
-		   "create_mid stdlist,"
-		   "accumulate,"
-		   "adjacent_difference,"
-		   "traversal,"
-		   "reverse,"
-		   "create_fb stdlist,"
-		   "accumulate,"
-		   "adjacent_difference,"
-		   "traversal,"
-		   "reverse,"
+	vector<double> times;
+	times.reserve(100);
 
-		   "create_back cwlist,"
-		   "accumulate,"
-		   "adjacent_difference,"
-		   "traversal,"
-		   "reverse,"
-		   "create_mid cwlist,"
-		   "accumulate,"
-		   "adjacent_difference,"
-		   "traversal,"
-		   "reverse,"
-		   "create_fb cwlist,"
-		   "accumulate,"
-		   "adjacent_difference,"
-		   "traversal,"
-		   "reverse,"
+	for( auto i : log_range( minN, maxN, maxIts, size_t(1) ) ) {
+		times.clear();
+		cout << i << endl;
+		int repeat = int( max( M / i , size_t(1) ) );
+		test_list<std::list<T>,P>( times, i, repeat );
+		test_list<cw::list<T,U>,P>( times, i, repeat );
+		test_list<cw::xor_list<T,U>,P>( times, i, repeat );
 
-		   "create_back ratio,"
-		   "accumulate ratio,"
-		   "adjacent_difference ratio,"
-		   "traversal ratio,"
-		   "reverse ratio,"
-		   "create_mid ratio,"
-		   "accumulate ratio,"
-		   "adjacent_difference ratio,"
-		   "traversal ratio,"
-		   "reverse ratio,"
-		   "create_fb ratio,"
-		   "accumulate ratio,"
-		   "adjacent_difference ratio,"
-		   "traversal ratio,"
-		   "reverse ratio,"
+		out << i << "," << repeat << ",";
+		for( auto t : times )
+			out << t << ",";
+		size_t nTests = times.size() / 3;
+		for(size_t j=0;j<nTests;++j)
+			out << times[j] / times[2 * nTests + j] << ",";
+		for(size_t j=0;j<nTests;++j)
+			out << times[nTests + j] / times[2 * nTests + j] << ",";
 
-		   "create_back vec ratio,"
-		   "accumulate vec ratio,"
-		   "adjacent_difference vec ratio,"
-	<< endl;
+		out << endl;
+	}
 }
 
-int main1() {
-
-	using P = preallocate_enable;
-	{
-		ofstream out("output/results1.csv");
-		print_header(out);
+// cw::list with 64 and 32-bit links against cw::adaptive_list, growing from
+// empty so the adaptive list pays for its re-encodes.
+template<typename T,typename P>
+void benchmark_adaptive( ofstream& out ) {
+	size_t minN = 1;
+	size_t maxBytes = 1 << 27;
+	size_t maxN = maxBytes / ( 2 * sizeof(uint64_t) + sizeof(T) );
 
-		using T = uint8_t;
+	size_t M = 6000000;
+	size_t maxIts = 1000;
 
-		benchmark<T,uint8_t,P>( out );
-		benchmark<T,uint16_t,P>( out );
-		benchmark<T,uint32_t,P>( out );
-	}
+	vector<double> times;
+	times.reserve(100);
 
-	{
-		ofstream out("output/results2.csv");
-		print_header(out);
+	for( auto i : log_range( minN, maxN, maxIts, size_t(1) ) ) {
+		times.clear();
+		cout << i << endl;
+		int repeat = int( max( M / i , size_t(1) ) );
+		test_list<cw::list<T,uint64_t>,P>( times, i, repeat );
+		test_list<cw::list<T,uint32_t>,P>( times, i, repeat );
+		test_list<cw::adaptive_list<T>,P>( times, i, repeat );
 
-		using T = uint16_t;
+		out << i << "," << repeat << ",";
+		for( auto t : times )
+			out << t << ",";
+		size_t nTests = times.size() / 3;
+		for(size_t j=0;j<nTests;++j)
+			out << times[j] / times[2 * nTests + j] << ",";
+		for(size_t j=0;j<nTests;++j)
+			out << times[nTests + j] / times[2 * nTests + j] << ",";
 
-		benchmark<T,uint8_t,P>( out );
-		benchmark<T,uint16_t,P>( out );
-		benchmark<T,uint32_t,P>( out );
+		out << endl;
 	}
+}
 
-	{
-		ofstream out("output/results4.csv");
-		print_header(out);
+// create with the fill strategy F, then walk the list in order
+template<typename L,typename F,typename P>
+void test_unrolled( vector<double>& times, size_t N, int repeat ) {
+	L v;
+	double scale = 1.0e6;
+	double factor = scale / repeat;
+	times.push_back( time([&]{
+		v = create<L,F,P>(N);
+	}) * scale );
+	times.push_back( test_accumulate( v, repeat ) * factor );
+	times.push_back( test_traversal( v, repeat ) * factor );
+}
 
-		using T = uint32_t;
+// std::list and cw::list against cw::unrolled_list, on midpoint insertion and
+// on sorted insertion at random positions. the sorted fill searches linearly,
+// so N is kept small as in benchmark_random.
+template<typename T,typename U,typename P>
+void benchmark_unrolled( ofstream& out ) {
+	size_t maxN = min<size_t>( numeric_limits<U>::max() - 1, 1 << 16 );
+	size_t minN = 16;
+
+	size_t M = 6000000;
+	size_t maxIts = 1000;
+
+	vector<double> times;
+	times.reserve(100);
+
+	for( auto i : log_range( minN, maxN, maxIts, size_t(1) ) ) {
+		times.clear();
+		cout << i << endl;
+		int repeat = int( max( M / i , size_t(1) ) );
+		test_unrolled<std::list<T>,fill_mid,P>( times, i, repeat );
+		test_unrolled<std::list<T>,fill_random_sorted,P>( times, i, repeat );
+		test_unrolled<cw::list<T,U>,fill_mid,P>( times, i, repeat );
+		test_unrolled<cw::list<T,U>,fill_random_sorted,P>( times, i, repeat );
+		test_unrolled<cw::unrolled_list<T,U>,fill_mid,P>( times, i, repeat );
+		test_unrolled<cw::unrolled_list<T,U>,fill_random_sorted,P>( times, i, repeat );
+
+		out << i << "," << repeat << ",";
+		for( auto t : times )
+			out << t << ",";
+		size_t nTests = times.size() / 3;
+		for(size_t j=0;j<nTests;++j)
+			out << times[j] / times[2 * nTests + j] << ",";
+		for(size_t j=0;j<nTests;++j)
+			out << times[nTests + j] / times[2 * nTests + j] << ",";
+
+		out << endl;
+	}
+}
+
+// A list behind a mutex, as a work queue.
+
+template<typename L>
+struct locked_queue {
+	using value_type = typename L::value_type;
+
+	L list;
+	std::mutex m;
+
+	bool push_back( const value_type& x ) {
+		std::lock_guard<std::mutex> lock( m );
+		list.push_back( x );
+		return true;
+	}
+
+	bool pop_front( value_type& x ) {
+		std::lock_guard<std::mutex> lock( m );
+		if( list.empty() ) return false;
+		x = list.front();
+		list.pop_front();
+		return true;
+	}
+};
+
+// threads producers each push N timestamps through the queue to threads consumers.
+// pushes throughput in millions of values per second, and the mean time from
+// push to pop in microseconds.
+template<typename Q>
+void test_queue( vector<double>& times, Q& q, size_t threads, size_t N ) {
+	size_t total = threads * N;
+	std::atomic<size_t> popped( 0 );
+	std::atomic<uint64_t> latency( 0 );
+	auto stamp = []{
+		using namespace std::chrono;
+		return uint64_t( duration_cast<nanoseconds>( hrc::now().time_since_epoch() ).count() );
+	};
+
+	double t = time([&]{
+		vector<std::thread> workers;
+		for(size_t p=0;p<threads;++p) {
+			workers.emplace_back( [&]{
+				for(size_t i=0;i<N;++i) {
+					while( !q.push_back( stamp() ) ) {
+						std::this_thread::yield();
+					}
+				}
+			});
+		}
+		for(size_t c=0;c<threads;++c) {
+			workers.emplace_back( [&]{
+				uint64_t x, sum = 0;
+				size_t count = 0;
+				while( popped.load( std::memory_order_relaxed ) < total ) {
+					if( !q.pop_front( x ) ) {
+						std::this_thread::yield();
+						continue;
+					}
+					sum += stamp() - x;
+					++count;
+					popped.fetch_add( 1, std::memory_order_relaxed );
+				}
+				latency += sum;
+			});
+		}
+		for( auto& w : workers ) w.join();
+	});
+
+	times.push_back( total / t * 1.0e-6 );
+	times.push_back( latency / double(total) * 1.0e-3 );
+}
+
+// cw::concurrent_queue against a mutex around cw::list and std::list, from one
+// producer and one consumer up to a producer and a consumer per core
+template<typename U>
+void benchmark_queue( ofstream& out ) {
+	size_t cores = max<size_t>( std::thread::hardware_concurrency(), 1 );
+	size_t N = 1 << 20;
+	size_t capacity = 1 << 12;
+
+	vector<double> times;
+	times.reserve(100);
+
+	for( size_t threads = 1; ; threads = min( threads * 2, cores ) ) {
+		times.clear();
+		cout << threads << endl;
+		{
+			locked_queue<std::list<uint64_t>> q;
+			test_queue( times, q, threads, N / threads );
+		}
+		{
+			locked_queue<cw::list<uint64_t,U>> q;
+			test_queue( times, q, threads, N / threads );
+		}
+		{
+			cw::concurrent_queue<uint64_t,U> q( capacity );
+			test_queue( times, q, threads, N / threads );
+		}
+
+		out << threads << ",";
+		for( auto t : times )
+			out << t << ",";
+		out << times[4] / times[0] << ",";
+		out << times[4] / times[2] << ",";
+		out << endl;
+
+		if( threads >= cores ) break;
+	}
+}
+
+// A list behind a mutex that every reader takes, as a shared table.
+
+template<typename L>
+struct locked_table {
+	using list_type = L;
+
+	L list;
+	std::mutex m;
+
+	template<typename F>
+	void read( F&& f ) {
+		std::lock_guard<std::mutex> lock( m );
+		f( list );
+	}
+
+	template<typename F>
+	void update( F&& f ) {
+		std::lock_guard<std::mutex> lock( m );
+		f( list );
+	}
+};
+
+// cw::snapshot_list in the interface of locked_table
+template<typename S>
+struct snapshot_table {
+	using list_type = typename S::list_type;
+
+	S list;
+
+	snapshot_table( list_type l, size_t readers ) : list( std::move(l), readers ) {}
+
+	template<typename F>
+	void read( F&& f ) {
+		auto s = list.read();
+		f( *s );
+	}
+
+	template<typename F>
+	void update( F&& f ) {
+		list.update( std::forward<F>(f) );
+	}
+};
+
+// threads readers each sum the table N times while one writer rewrites a value
+// in it until they finish. pushes reads per second in millions, and updates
+// per second in thousands.
+template<typename Q>
+void test_table( vector<double>& times, Q& q, size_t threads, size_t N ) {
+	std::atomic<size_t> done( 0 );
+	std::atomic<uint64_t> checksum( 0 );
+	size_t updates = 0;
+
+	double t = time([&]{
+		vector<std::thread> readers;
+		for(size_t r=0;r<threads;++r) {
+			readers.emplace_back( [&]{
+				uint64_t sum = 0;
+				for(size_t i=0;i<N;++i) {
+					q.read( [&sum]( const typename Q::list_type& l ) {
+						for( auto x : l ) sum += x;
+					});
+				}
+				checksum += sum;
+				++done;
+			});
+		}
+		while( done.load() < threads ) {
+			q.update( [updates]( typename Q::list_type& l ) {
+				l.front() = updates;
+			});
+			++updates;
+		}
+		for( auto& r : readers ) r.join();
+	});
+
+	times.push_back( threads * N / t * 1.0e-6 );
+	times.push_back( updates / t * 1.0e-3 );
+}
+
+// cw::snapshot_list against a mutex around cw::list, from one reader up to a
+// reader per core, with a table of M values
+template<typename U>
+void benchmark_snapshot( ofstream& out ) {
+	size_t cores = max<size_t>( std::thread::hardware_concurrency(), 1 );
+	size_t N = 1 << 16;
+	size_t M = 64;
+
+	vector<double> times;
+	times.reserve(100);
+
+	for( size_t threads = 1; ; threads = min( threads * 2, cores ) ) {
+		times.clear();
+		cout << threads << endl;
+		cw::list<uint64_t,U> table;
+		table.assign( M, uint64_t(1) );
+		{
+			locked_table<cw::list<uint64_t,U>> q;
+			q.list = table;
+			test_table( times, q, threads, N );
+		}
+		{
+			snapshot_table<cw::snapshot_list<uint64_t,U>> q( table, threads );
+			test_table( times, q, threads, N );
+		}
+
+		out << threads << ",";
+		for( auto t : times )
+			out << t << ",";
+		out << times[2] / times[0] << ",";
+		out << endl;
+
+		if( threads >= cores ) break;
+	}
+}
+
+// Restart -- the time to get a list of N values back from disk. cw::list is
+// rebuilt by reading the values and pushing them back one by one; the mapped
+// list is reopened, then walked once, which pages it in.
+template<typename T,typename U>
+void benchmark_mapped( ofstream& out ) {
+	size_t minN = 1 << 10;
+	size_t maxN = min<size_t>( numeric_limits<U>::max() - 1, 1 << 24 );
+	size_t maxIts = 40;
+	const char* values_path = "output/mapped_values.bin";
+	const char* list_path = "output/mapped_list.bin";
+
+	vector<double> times;
+	times.reserve(100);
+
+	for( auto i : log_range( minN, maxN, maxIts, size_t(1) ) ) {
+		times.clear();
+		cout << i << endl;
+		double scale = 1.0e6;
+
+		std::remove( list_path );
+		{
+			cw::mapped_list<T,U> m( list_path );
+			ofstream f( values_path, ios::binary );
+			for(size_t j=0;j<i;++j) {
+				T x = T(j);
+				m.push_back( x );
+				f.write( reinterpret_cast<const char*>(&x), sizeof(T) );
+			}
+			m.sync();
+		}
+
+		times.push_back( time([&]{
+			cw::list<T,U> v;
+			ifstream f( values_path, ios::binary );
+			T x;
+			while( f.read( reinterpret_cast<char*>(&x), sizeof(T) ) ) {
+				v.push_back( x );
+			}
+			volatile auto dont_optimize_me = v.size();
+		}) * scale );
+		times.push_back( time([&]{
+			cw::mapped_list<T,U> m( list_path );
+			volatile auto dont_optimize_me = m.size();
+		}) * scale );
+		times.push_back( time([&]{
+			cw::mapped_list<T,U> m( list_path );
+			volatile auto dont_optimize_me = accumulate( begin(m), end(m), uint64_t(0) );
+		}) * scale );
+
+		out << i << ",";
+		for( auto t : times )
+			out << t << ",";
+		out << times[0] / times[1] << ",";
+		out << times[0] / times[2] << ",";
+		out << endl;
+	}
+	std::remove( values_path );
+	std::remove( list_path );
+}
+
+// Checkpoint -- writing a list to a file and reading it back. The element by
+// element baseline writes each value in list order and reloads by push_back.
+// save/load write the raw storage with its nodes, or the values in list order.
+template<typename T,typename U>
+void benchmark_list_io( ofstream& out ) {
+	size_t minN = 1 << 10;
+	size_t maxN = min<size_t>( numeric_limits<U>::max() - 1, 1 << 24 );
+	size_t maxIts = 40;
+	const char* path = "output/list_io.bin";
+
+	vector<double> times;
+	times.reserve(100);
+
+	for( auto i : log_range( minN, maxN, maxIts, size_t(1) ) ) {
+		times.clear();
+		cout << i << endl;
+		double scale = 1.0e6;
+
+		// scattered, as a list is after a while in use
+		cw::list<T,U> v;
+		for(size_t j=0;j<i;++j) {
+			if( j % 2 ) {
+				v.push_back( T(j) );
+			} else {
+				v.push_front( T(j) );
+			}
+		}
+
+		times.push_back( time([&]{
+			ofstream f( path, ios::binary );
+			for( const auto& x : v ) {
+				f.write( reinterpret_cast<const char*>(&x), sizeof(T) );
+			}
+		}) * scale );
+		times.push_back( time([&]{
+			cw::list<T,U> w;
+			ifstream f( path, ios::binary );
+			T x;
+			while( f.read( reinterpret_cast<char*>(&x), sizeof(T) ) ) {
+				w.push_back( x );
+			}
+			volatile auto dont_optimize_me = w.size();
+		}) * scale );
+
+		for( auto order : { cw::save_order::storage, cw::save_order::list } ) {
+			times.push_back( time([&]{
+				ofstream f( path, ios::binary );
+				cw::save( f, v, order );
+			}) * scale );
+			times.push_back( time([&]{
+				cw::list<T,U> w;
+				ifstream f( path, ios::binary );
+				cw::load( f, w );
+				volatile auto dont_optimize_me = w.size();
+			}) * scale );
+		}
+
+		out << i << ",";
+		for( auto t : times )
+			out << t << ",";
+		for(size_t j=2;j<times.size();++j)
+			out << times[j % 2] / times[j] << ",";
+		out << endl;
+	}
+	std::remove( path );
+}
+
+template<typename T,typename U,typename P>
+void benchmark_random( ofstream& out ) {
+	size_t maxN = numeric_limits<U>::max();
+	size_t bits = sizeof(U) * 8;
+	size_t minN = ( bits > 8 ) ? ( 1 << (bits / 2) ) : 1;
+	size_t maxBytes = 1 << 20;
+	maxN = min( maxN, maxBytes / ( 2 * sizeof(void*) + (size_t)sqrt( 0.6 * sizeof(T) ) ) );
+
+	size_t maxIts = 1000;
+
+	vector<double> times;
+	times.reserve(100);
+
+	for( auto i : log_range( minN, maxN, maxIts, size_t(1) ) ) {
+		times.clear();
+		cout << i << endl;
+		test_random<vector<T>,P>( times, i );
+		test_random<std::list<T>,P>( times, i );
+		test_random<cw::list<T,U>,P>( times, i );
+		out << i << ",";
+		for( auto t : times )
+			out << t << ",";
+
+		out << times[1] / times[2] << ",";
+		out << times[0] / times[1] << ",";
+		out << times[0] / times[2] << ",";
+
+		out << endl;
+	}
+
+}
+
+template<typename T,typename U,typename P>
+void benchmark_sort( ofstream& out ) {
+	size_t maxN = numeric_limits<U>::max();
+	size_t bits = sizeof(U) * 8;
+	size_t minN = ( bits > 8 ) ? ( 1 << (bits / 2) ) : 1;
+	size_t maxBytes = 1 << 27;
+	maxN = min( maxN, maxBytes / ( 2 * sizeof(void*) + sizeof(T) ) );
+
+	size_t maxIts = 1000;
+
+	vector<double> times;
+	times.reserve(100);
+
+	for( auto i : log_range( minN, maxN, maxIts, size_t(1) ) ) {
+		times.clear();
+		cout << i << endl;
+		test_sort<vector<T>,P>( times, i );
+		test_sort<std::list<T>,P>( times, i );
+		test_sort<cw::list<T,U>,P>( times, i );
+		test_sort_by_key<cw::list<T,U>,P>( times, i );
+		test_sort_compact<cw::list<T,U>,P>( times, i );
+		out << i << ",";
+		for( auto t : times )
+			out << t << ",";
+
+		out << times[1] / times[2] << ",";
+		out << times[1] / times[3] << ",";
+		out << times[1] / times[4] << ",";
+		out << times[0] / times[1] << ",";
+		out << times[0] / times[2] << ",";
+		out << times[0] / times[3] << ",";
+
+		out << endl;
+	}
+
+}
+
+template<typename T,typename U,typename P>
+void benchmark_alloc( ofstream& out ) {
+	size_t maxN = numeric_limits<U>::max();
+	size_t bits = sizeof(U) * 8;
+	size_t minN = ( bits > 8 ) ? ( 1 << (bits / 2) ) : 1;
+	size_t maxBytes = 1 << 27;
+	maxN = min( maxN, maxBytes / ( 2 * sizeof(void*) + sizeof(T) ) );
+
+	size_t M = 6000000;
+	size_t maxIts = 1000;
+
+	vector<double> times;
+	times.reserve(100);
+
+	for( auto i : log_range( minN, maxN, maxIts, size_t(1) ) ) {
+		times.clear();
+		cout << i << endl;
+		int repeat = int( max( M / i , size_t(1) ) );
+		test_alloc<std::list<T>,P>( times, i, repeat );
+		test_alloc<cw::list<T,U>,P>( times, i, repeat );
+		test_alloc<cw::list<T,U,arena_allocator<T>>,P>( times, i, repeat );
+
+		out << i << "," << repeat << ",";
+		for( auto t : times )
+			out << t << ",";
+
+		int nTests = 3;
+		for(int j=0;j<nTests;++j)
+			out << times[nTests + j] / times[2 * nTests + j] << ",";
+
+		for(int j=0;j<nTests;++j)
+			out << times[j] / times[2 * nTests + j] << ",";
+
+		out << endl;
+	}
+
+}
+
+template<typename T,typename U>
+void benchmark_parallel( ofstream& out ) {
+	size_t minN = 1 << 10;
+	size_t maxN = min( size_t( numeric_limits<U>::max() ), size_t(1 << 30) / ( sizeof(T) + 2 * sizeof(U) ) );
+
+	size_t M = 100000000;
+	size_t maxIts = 100;
+
+	vector<double> times;
+	times.reserve(100);
+
+	for( auto i : log_range( minN, maxN, maxIts, size_t(1) ) ) {
+		times.clear();
+		cout << i << endl;
+		int repeat = int( max( M / i , size_t(1) ) );
+		auto v = create<cw::list<T,U>,fill_back_random,preallocate_enable>(i);
+		test_scan( times, v, cw::seq, repeat );
+		test_scan( times, v, cw::par, repeat );
+
+		out << i << "," << repeat << ",";
+		for( auto t : times )
+			out << t << ",";
+
+		int nTests = 3;
+		for(int j=0;j<nTests;++j)
+			out << times[j] / times[nTests + j] << ",";
+
+		out << endl;
+	}
+
+}
+
+// ordered traversal, in nanoseconds per element
+template<typename L>
+double test_iterate( const L& v, int repeat ) {
+	uint64_t sum = 0;
+	double t = time([&]{
+		for(int i=0;i<repeat;++i) {
+			std::for_each( begin(v), end(v), [&]( const typename L::value_type& x ){ sum += x; } );
+		}
+	});
+	volatile uint64_t dont_optimize_me = sum;
+	return t * 1.0e9 / ( double(repeat) * v.size() );
+}
+
+template<typename L>
+double test_ordered( const L& v, int repeat, size_t distance ) {
+	uint64_t sum = 0;
+	double t = time([&]{
+		for(int i=0;i<repeat;++i) {
+			cw::for_each_ordered( v, [&]( const typename L::value_type& x ){ sum += x; }, distance );
+		}
+	});
+	volatile uint64_t dont_optimize_me = sum;
+	return t * 1.0e9 / ( double(repeat) * v.size() );
+}
+
+template<typename T,typename U,typename F>
+void test_layout( vector<double>& times, size_t N, int repeat ) {
+	auto s = create<std::list<T>,F,preallocate_disable>(N);
+	auto c = create<cw::list<T,U>,F,preallocate_enable>(N);
+	times.push_back( test_iterate( s, repeat ) );
+	times.push_back( test_iterate( c, repeat ) );
+	for( size_t d : { 4, 16, 64 } ) {
+		times.push_back( test_ordered( c, repeat, d ) );
+	}
+}
+
+// for_each_ordered against iterating, over layouts from local to random
+template<typename T,typename U>
+void benchmark_ordered( ofstream& out ) {
+	size_t minN = 1 << 10;
+	size_t maxN = min( size_t( numeric_limits<U>::max() ), size_t(1 << 28) / ( sizeof(T) + 2 * sizeof(U) ) );
+	size_t maxIts = 30;
+	size_t M = 1 << 24;
+
+	out << "size,repeat,";
+	for( auto layout : { "fb_random", "mid", "shuffled" } ) {
+		out << "stdlist " << layout << ",cwlist " << layout << ",ordered4 " << layout << ",ordered16 " << layout << ",ordered64 " << layout << ",";
+	}
+	out << endl;
+
+	vector<double> times;
+	for( auto i : log_range( minN, maxN, maxIts, size_t(1) ) ) {
+		cout << i << endl;
+		int repeat = int( max( M / i, size_t(1) ) );
+		times.clear();
+		test_layout<T,U,fill_fb_random>( times, i, repeat );
+		test_layout<T,U,fill_mid>( times, i, repeat );
+		test_layout<T,U,fill_shuffled>( times, i, repeat );
+
+		out << i << "," << repeat << ",";
+		for( auto t : times )
+			out << t << ",";
+		out << endl;
+	}
+}
+
+template<typename L>
+double test_iterate_reverse( const L& v, int repeat ) {
+	uint64_t sum = 0;
+	double t = time([&]{
+		for(int i=0;i<repeat;++i) {
+			std::for_each( v.rbegin(), v.rend(), [&]( const typename L::value_type& x ){ sum += x; } );
+		}
+	});
+	volatile uint64_t dont_optimize_me = sum;
+	return t * 1.0e9 / ( double(repeat) * v.size() );
+}
+
+// relinking sort, in nanoseconds per element
+template<typename L>
+double test_sort( const L& v ) {
+	L w( v );
+	double t = time([&]{
+		w.sort();
+	});
+	return t * 1.0e9 / v.size();
+}
+
+template<typename T,typename U,typename F,typename Layout>
+void test_storage( vector<double>& times, size_t N, int repeat ) {
+	using L = cw::list<T,U,std::allocator<T>,cw::erase_swap,Layout>;
+	auto c = create<L,F,preallocate_enable>(N);
+	times.push_back( test_iterate( c, repeat ) );
+	times.push_back( test_iterate_reverse( c, repeat ) );
+	times.push_back( test_sort( c ) );
+}
+
+// the storage layouts -- SoA, AoS and split links -- over local and random link orders
+template<typename T,typename U>
+void benchmark_storage( ofstream& out ) {
+	size_t minN = 1 << 10;
+	size_t maxN = min( size_t( numeric_limits<U>::max() ), size_t(1 << 28) / ( sizeof(T) + 2 * sizeof(U) ) );
+	size_t maxIts = 30;
+	size_t M = 1 << 24;
+
+	out << "size,repeat,";
+	for( auto order : { "fb_random", "shuffled" } ) {
+		for( auto layout : { "soa", "aos", "split" } ) {
+			out << layout << " iterate " << order << "," << layout << " reverse " << order << "," << layout << " sort " << order << ",";
+		}
+	}
+	out << endl;
+
+	vector<double> times;
+	for( auto i : log_range( minN, maxN, maxIts, size_t(1) ) ) {
+		cout << i << endl;
+		int repeat = int( max( M / i, size_t(1) ) );
+		times.clear();
+		test_storage<T,U,fill_fb_random,cw::layout_soa>( times, i, repeat );
+		test_storage<T,U,fill_fb_random,cw::layout_aos>( times, i, repeat );
+		test_storage<T,U,fill_fb_random,cw::layout_split>( times, i, repeat );
+		test_storage<T,U,fill_shuffled,cw::layout_soa>( times, i, repeat );
+		test_storage<T,U,fill_shuffled,cw::layout_aos>( times, i, repeat );
+		test_storage<T,U,fill_shuffled,cw::layout_split>( times, i, repeat );
+
+		out << i << "," << repeat << ",";
+		for( auto t : times )
+			out << t << ",";
+		out << endl;
+	}
+}
+
+template<typename T,typename U,typename F>
+void test_packed( vector<double>& times, size_t N, int repeat ) {
+	using L = cw::list<T,U>;
+	auto c = create<L,F,preallocate_enable>(N);
+	times.push_back( test_iterate( c, repeat ) );
+}
+
+// packed link widths against the power-of-two widths either side -- iteration
+// cost in nanoseconds per element, next to the bytes per element
+template<typename T>
+void benchmark_packed( ofstream& out ) {
+	size_t minN = 1 << 10;
+	size_t maxN = min( size_t( index_traits<uint24_index>::max ), size_t(1 << 28) / ( sizeof(T) + 2 * sizeof(uint64_t) ) );
+	size_t maxIts = 30;
+	size_t M = 1 << 24;
+
+	const char* names[] = { "list32", "list24", "list64", "list48", "list40" };
+	size_t bytes[] = {
+		sizeof(T) + sizeof( cw::list_node<uint32_t> ),
+		sizeof(T) + sizeof( cw::list_node<uint24_index> ),
+		sizeof(T) + sizeof( cw::list_node<uint64_t> ),
+		sizeof(T) + sizeof( cw::list_node<uint48_index> ),
+		sizeof(T) + sizeof( cw::list_node<uint40_index> ),
+	};
+
+	out << "size,repeat,";
+	for( auto name : names ) {
+		out << name << " bytes," << name << " iterate fb_random," << name << " iterate shuffled,";
+	}
+	out << endl;
+
+	vector<double> times;
+	for( auto i : log_range( minN, maxN, maxIts, size_t(1) ) ) {
+		cout << i << endl;
+		int repeat = int( max( M / i, size_t(1) ) );
+		times.clear();
+		test_packed<T,uint32_t,fill_fb_random>( times, i, repeat );
+		test_packed<T,uint32_t,fill_shuffled>( times, i, repeat );
+		test_packed<T,uint24_index,fill_fb_random>( times, i, repeat );
+		test_packed<T,uint24_index,fill_shuffled>( times, i, repeat );
+		test_packed<T,uint64_t,fill_fb_random>( times, i, repeat );
+		test_packed<T,uint64_t,fill_shuffled>( times, i, repeat );
+		test_packed<T,uint48_index,fill_fb_random>( times, i, repeat );
+		test_packed<T,uint48_index,fill_shuffled>( times, i, repeat );
+		test_packed<T,uint40_index,fill_fb_random>( times, i, repeat );
+		test_packed<T,uint40_index,fill_shuffled>( times, i, repeat );
+
+		out << i << "," << repeat << ",";
+		for(size_t j=0;j<5;++j)
+			out << bytes[j] << "," << times[2 * j] << "," << times[2 * j + 1] << ",";
+		out << endl;
+	}
+}
+
+// append total elements in batches of batch.size(), in nanoseconds per element
+template<typename L,typename T>
+double test_append_loop( const vector<T>& batch, size_t total ) {
+	L v;
+	double t = time([&]{
+		for(size_t n=0;n<total;n+=batch.size()) {
+			for( auto&& x : batch ) {
+				v.push_back( x );
+			}
+		}
+	});
+	return t * 1.0e9 / total;
+}
+
+template<typename L,typename T>
+double test_append_range( const vector<T>& batch, size_t total ) {
+	L v;
+	double t = time([&]{
+		for(size_t n=0;n<total;n+=batch.size()) {
+			v.insert( end(v), begin(batch), end(batch) );
+		}
+	});
+	return t * 1.0e9 / total;
+}
+
+// batched ingest into the middle of a list
+template<typename L,typename T>
+double test_insert_range( const vector<T>& batch, size_t total ) {
+	L v( begin(batch), end(batch) );
+	double t = time([&]{
+		auto it = begin(v);
+		for(size_t n=0;n<total;n+=batch.size()) {
+			it = v.insert( it, begin(batch), end(batch) );
+		}
+	});
+	return t * 1.0e9 / total;
+}
+
+template<typename T,typename U>
+void benchmark_append( ofstream& out ) {
+	size_t total = min( size_t( numeric_limits<U>::max() ), size_t(1 << 22) );
+
+	out << "batch,"
+	       "append stdlist,"
+	       "push_back cwlist,"
+	       "append cwlist,"
+	       "insert stdlist,"
+	       "insert cwlist,"
+	       "append ratio,"
+	       "insert ratio,"
+	    << endl;
+
+	for( auto b : log_range( size_t(16), size_t(1 << 17), size_t(30), size_t(1) ) ) {
+		cout << b << endl;
+		vector<T> batch;
+		for(size_t i=0;i<b;++i) {
+			batch.push_back( T(i) );
+		}
+
+		double sa = test_append_range<std::list<T>>( batch, total );
+		double cl = test_append_loop<cw::list<T,U>>( batch, total );
+		double ca = test_append_range<cw::list<T,U>>( batch, total );
+		double si = test_insert_range<std::list<T>>( batch, total );
+		double ci = test_insert_range<cw::list<T,U>>( batch, total );
+
+		out << b << ","
+		    << sa << "," << cl << "," << ca << "," << si << "," << ci << ","
+		    << cl / ca << "," << si / ci << ","
+		    << endl;
+	}
+}
+
+// trim a quarter of copies of v from the front, then a quarter from the back,
+// in microseconds per trim
+template<typename L>
+double test_trim( const L& v, int repeat ) {
+	size_t k = v.size() / 4;
+	double t = 0;
+	for(int i=0;i<repeat;++i) {
+		L c = v;
+		t += time([&]{
+			auto it = begin(c);
+			std::advance( it, k );
+			c.erase( begin(c), it );
+			c.resize( c.size() - k );
+		});
+	}
+	return t * 1.0e6 / ( 2 * repeat );
+}
+
+template<typename T,typename U>
+void benchmark_trim( ofstream& out ) {
+	size_t minN = 1 << 6;
+	size_t maxN = min( size_t( numeric_limits<U>::max() ), size_t(1 << 22) );
+	size_t maxIts = 50;
+	size_t M = 1 << 24;
+
+	out << "size,"
+	       "repeat,"
+	       "trim stdlist,"
+	       "trim cwlist,"
+	       "trim stable,"
+	       "cwlist ratio,"
+	       "stable ratio,"
+	    << endl;
+
+	for( auto i : log_range( minN, maxN, maxIts, size_t(1) ) ) {
+		cout << i << endl;
+		int repeat = int( max( M / i, size_t(1) ) );
+
+		auto s = create<std::list<T>,fill_back,preallocate_disable>(i);
+		auto a = create<cw::list<T,U>,fill_back,preallocate_disable>(i);
+		auto b = create<cw::stable_list<T,U>,fill_back,preallocate_disable>(i);
+
+		double ts = test_trim( s, repeat );
+		double ta = test_trim( a, repeat );
+		double tb = test_trim( b, repeat );
+
+		out << i << "," << repeat << ","
+		    << ts << "," << ta << "," << tb << ","
+		    << ts / ta << "," << ts / tb << ","
+		    << endl;
+	}
+}
+
+// remove every odd value from copies of v, in microseconds per removal pass
+template<typename L>
+double test_remove_odd( const L& v, int repeat ) {
+	using T = typename L::value_type;
+	double t = 0;
+	for(int i=0;i<repeat;++i) {
+		L c = v;
+		t += time([&]{ c.remove_if( []( const T& x ){ return x % 2 == 1; } ); });
+	}
+	return t * 1.0e6 / repeat;
+}
+
+// remove_if on lists built by midpoint insertion, so the links are scattered
+template<typename T,typename U>
+void benchmark_remove( ofstream& out ) {
+	size_t minN = 1 << 6;
+	size_t maxN = min( size_t( numeric_limits<U>::max() ), size_t(1 << 22) );
+	size_t maxIts = 50;
+	size_t M = 1 << 24;
+
+	out << "size,"
+	       "repeat,"
+	       "remove_if stdlist,"
+	       "remove_if cwlist,"
+	       "remove_if stable,"
+	       "cwlist ratio,"
+	       "stable ratio,"
+	    << endl;
+
+	for( auto i : log_range( minN, maxN, maxIts, size_t(1) ) ) {
+		cout << i << endl;
+		int repeat = int( max( M / i, size_t(1) ) );
+
+		auto s = create<std::list<T>,fill_mid,preallocate_disable>(i);
+		auto a = create<cw::list<T,U>,fill_mid,preallocate_disable>(i);
+		auto b = create<cw::stable_list<T,U>,fill_mid,preallocate_disable>(i);
+
+		double ts = test_remove_odd( s, repeat );
+		double ta = test_remove_odd( a, repeat );
+		double tb = test_remove_odd( b, repeat );
+
+		out << i << "," << repeat << ","
+		    << ts << "," << ta << "," << tb << ","
+		    << ts / ta << "," << ts / tb << ","
+		    << endl;
+	}
+}
+
+// random positional lookups, in microseconds per lookup
+template<typename L>
+double test_lookup( const L& v, size_t lookups ) {
+	mt19937 mt;
+	size_t N = v.size();
+	uint64_t sum = 0;
+	double t = time([&]{
+		for(size_t i=0;i<lookups;++i) {
+			auto it = begin(v);
+			std::advance( it, mt() % N );
+			sum += *it;
+		}
+	});
+	volatile uint64_t dont_optimize_me = sum;
+	return t * 1.0e6 / lookups;
+}
+
+template<typename T,typename U>
+double test_lookup_at( const cw::list<T,U>& v, size_t lookups ) {
+	mt19937 mt;
+	size_t N = v.size();
+	uint64_t sum = 0;
+	double t = time([&]{
+		for(size_t i=0;i<lookups;++i) {
+			sum += v[ mt() % N ];
+		}
+	});
+	volatile uint64_t dont_optimize_me = sum;
+	return t * 1.0e6 / lookups;
+}
+
+// positional access on a list built by midpoint insertion, so the links are scattered
+template<typename T,typename U>
+void benchmark_positions( ofstream& out ) {
+	size_t minN = 1 << 6;
+	size_t maxN = min( size_t( numeric_limits<U>::max() ), size_t(1 << 20) );
+	size_t maxIts = 50;
+	size_t M = 1 << 24;
+
+	out << "size,"
+	       "create_mid cwlist,"
+	       "create_mid indexed,"
+	       "advance stdlist,"
+	       "at cwlist,"
+	       "at indexed,"
+	       "at ratio,"
+	    << endl;
+
+	for( auto i : log_range( minN, maxN, maxIts, size_t(1) ) ) {
+		cout << i << endl;
+		size_t lookups = max( M / i, size_t(100) );
+
+		cw::list<T,U> a, b;
+		b.index_positions( true );
+		double create_a = time([&]{ fill_mid()( a, i ); });
+		double create_b = time([&]{ fill_mid()( b, i ); });
+		auto s = create<std::list<T>,fill_mid,preallocate_disable>(i);
+
+		double std_lookup = test_lookup( s, lookups );
+		double lookup_a = test_lookup_at( a, lookups );
+		double lookup_b = test_lookup_at( b, lookups );
+
+		out << i << ","
+		    << create_a << "," << create_b << ","
+		    << std_lookup << "," << lookup_a << "," << lookup_b << ","
+		    << lookup_a / lookup_b << ","
+		    << endl;
+	}
+}
+
+// even values only, so that 1 is never found
+template<typename T>
+cw::list<T> create_even( size_t N ) {
+	mt19937 mt;
+	cw::list<T> v;
+	v.reserve( N );
+	for(size_t i=0;i<N;++i) {
+		v.push_back( T( ( mt() % 64 ) * 2 ) );
+	}
+	return v;
+}
+
+template<typename T>
+void benchmark_simd( ofstream& out ) {
+	size_t minN = 1 << 6;
+	size_t maxN = size_t(1 << 26) / sizeof(T);
+
+	size_t M = 100000000;
+	size_t maxIts = 100;
+
+	auto supported = cw::simd::supported_isa();
+
+	out << "size,repeat,";
+	for( int k = int( supported ); k >= 0; --k ) {
+		out << "count isa" << k << ",find isa" << k << ",min isa" << k << ",accumulate isa" << k << ",";
+	}
+	out << "count std,find std,min std,accumulate std," << endl;
+
+	vector<double> times;
+	times.reserve(100);
+
+	for( auto i : log_range( minN, maxN, maxIts, size_t(1) ) ) {
+		times.clear();
+		cout << i << endl;
+		int repeat = int( max( M / i , size_t(1) ) );
+		auto v = create_even<T>(i);
+		for( int k = int( supported ); k >= 0; --k ) {
+			cw::simd::set_isa( cw::simd::isa(k) );
+			test_kernels( times, v, repeat );
+		}
+		cw::simd::set_isa( supported );
+		test_kernels_std( times, v, repeat );
+
+		out << i << "," << repeat << ",";
+		for( auto t : times )
+			out << t << ",";
+		out << endl;
+	}
+}
+
+void print_header( ofstream& out ) {
+	out << "size,"
+	       "repeat,"
+
+		   "create_back vector,"
+		   "accumulate,"
+		   "adjacent_difference,"
+
+		   "create_back stdlist,"
+		   "accumulate,"
+		   "adjacent_difference,"
+		   "traversal,"
+		   "reverse,"
+		   "create_mid stdlist,"
+		   "accumulate,"
+		   "adjacent_difference,"
+		   "traversal,"
+		   "reverse,"
+		   "create_fb stdlist,"
+		   "accumulate,"
+		   "adjacent_difference,"
+		   "traversal,"
+		   "reverse,"
+
+		   "create_back cwlist,"
+		   "accumulate,"
+		   "adjacent_difference,"
+		   "traversal,"
+		   "reverse,"
+		   "create_mid cwlist,"
+		   "accumulate,"
+		   "adjacent_difference,"
+		   "traversal,"
+		   "reverse,"
+		   "create_fb cwlist,"
+		   "accumulate,"
+		   "adjacent_difference,"
+		   "traversal,"
+		   "reverse,"
+
+		   "create_back ratio,"
+		   "accumulate ratio,"
+		   "adjacent_difference ratio,"
+		   "traversal ratio,"
+		   "reverse ratio,"
+		   "create_mid ratio,"
+		   "accumulate ratio,"
+		   "adjacent_difference ratio,"
+		   "traversal ratio,"
+		   "reverse ratio,"
+		   "create_fb ratio,"
+		   "accumulate ratio,"
+		   "adjacent_difference ratio,"
+		   "traversal ratio,"
+		   "reverse ratio,"
+
+		   "create_back vec ratio,"
+		   "accumulate vec ratio,"
+		   "adjacent_difference vec ratio,"
+	<< endl;
+}
+
+void print_forward_header( ofstream& out ) {
+	out << "size,repeat,";
+	for( auto name : { "stdforward", "cwforward", "ratio" } ) {
+		out << "create_front " << name << ","
+		       "accumulate,"
+		       "traversal,"
+		       "reverse,"
+		       "erase_after,"
+		       "create_after " << name << ","
+		       "accumulate,"
+		       "traversal,"
+		       "erase_after,"
+		       "stack,";
+	}
+	out << endl;
+}
+
+// the columns of test_list for each of the named lists and ratios
+void print_list_header( ofstream& out, std::initializer_list<const char*> names ) {
+	out << "size,repeat,";
+	for( auto name : names ) {
+		for( auto fill : { "create_back ", "create_mid ", "create_fb " } ) {
+			out << fill << name << ","
+			       "accumulate,"
+			       "adjacent_difference,"
+			       "traversal,"
+			       "reverse,";
+		}
+	}
+	out << endl;
+}
+
+// the columns of benchmark_unrolled
+void print_unrolled_header( ofstream& out ) {
+	out << "size,repeat,";
+	for( auto name : { "stdlist", "cwlist", "unrolled", "stdlist ratio", "cwlist ratio" } ) {
+		for( auto fill : { "create_mid ", "create_random_sorted " } ) {
+			out << fill << name << ","
+			       "accumulate,"
+			       "traversal,";
+		}
+	}
+	out << endl;
+}
+
+int main1() {
+
+	using P = preallocate_enable;
+	{
+		ofstream out("output/results1.csv");
+		print_header(out);
+
+		using T = uint8_t;
+
+		benchmark<T,uint8_t,P>( out );
+		benchmark<T,uint16_t,P>( out );
+		benchmark<T,uint32_t,P>( out );
+	}
+
+	{
+		ofstream out("output/results2.csv");
+		print_header(out);
+
+		using T = uint16_t;
+
+		benchmark<T,uint8_t,P>( out );
+		benchmark<T,uint16_t,P>( out );
+		benchmark<T,uint32_t,P>( out );
+	}
+
+	{
+		ofstream out("output/results4.csv");
+		print_header(out);
+
+		using T = uint32_t;
 
 		benchmark<T,uint8_t,P>( out );
 		benchmark<T,uint16_t,P>( out );
@@ -618,7 +2029,402 @@ int main2() {
 	return 0;
 }
 
+int main3() {
+
+	using P = preallocate_enable;
+	{
+		ofstream out("output/sort1.csv");
+
+		using T = uint8_t;
+
+		benchmark_sort<T,uint8_t,P>( out );
+		benchmark_sort<T,uint16_t,P>( out );
+		benchmark_sort<T,uint32_t,P>( out );
+	}
+	{
+		ofstream out("output/sort2.csv");
+
+		using T = uint16_t;
+
+		benchmark_sort<T,uint8_t,P>( out );
+		benchmark_sort<T,uint16_t,P>( out );
+		benchmark_sort<T,uint32_t,P>( out );
+	}
+	{
+		ofstream out("output/sort4.csv");
+
+		using T = uint32_t;
+
+		benchmark_sort<T,uint8_t,P>( out );
+		benchmark_sort<T,uint16_t,P>( out );
+		benchmark_sort<T,uint32_t,P>( out );
+	}
+	{
+		ofstream out("output/sort8.csv");
+
+		using T = uint64_t;
+
+		benchmark_sort<T,uint8_t,P>( out );
+		benchmark_sort<T,uint16_t,P>( out );
+		benchmark_sort<T,uint32_t,P>( out );
+	}
+	{
+		ofstream out("output/sort16.csv");
+
+		using T = data_array<uint64_t,2>;
+
+		benchmark_sort<T,uint8_t,P>( out );
+		benchmark_sort<T,uint16_t,P>( out );
+		benchmark_sort<T,uint32_t,P>( out );
+	}
+	{
+		ofstream out("output/sort32.csv");
+
+		using T = data_array<uint64_t,4>;
+
+		benchmark_sort<T,uint8_t,P>( out );
+		benchmark_sort<T,uint16_t,P>( out );
+		benchmark_sort<T,uint32_t,P>( out );
+	}
+	{
+		ofstream out("output/sort64.csv");
+
+		using T = data_array<uint64_t,8>;
+
+		benchmark_sort<T,uint8_t,P>( out );
+		benchmark_sort<T,uint16_t,P>( out );
+		benchmark_sort<T,uint32_t,P>( out );
+	}
+	{
+		ofstream out("output/sort128.csv");
+
+		using T = data_array<uint64_t,16>;
+
+		benchmark_sort<T,uint8_t,P>( out );
+		benchmark_sort<T,uint16_t,P>( out );
+		benchmark_sort<T,uint32_t,P>( out );
+	}
+
+	return 0;
+}
+
+int main4() {
+
+	using P = preallocate_disable;
+	{
+		ofstream out("output/alloc1.csv");
+
+		using T = uint8_t;
+
+		benchmark_alloc<T,uint8_t,P>( out );
+		benchmark_alloc<T,uint16_t,P>( out );
+		benchmark_alloc<T,uint32_t,P>( out );
+	}
+	{
+		ofstream out("output/alloc4.csv");
+
+		using T = uint32_t;
+
+		benchmark_alloc<T,uint8_t,P>( out );
+		benchmark_alloc<T,uint16_t,P>( out );
+		benchmark_alloc<T,uint32_t,P>( out );
+	}
+	{
+		ofstream out("output/alloc8.csv");
+
+		using T = uint64_t;
+
+		benchmark_alloc<T,uint8_t,P>( out );
+		benchmark_alloc<T,uint16_t,P>( out );
+		benchmark_alloc<T,uint32_t,P>( out );
+	}
+	{
+		ofstream out("output/alloc64.csv");
+
+		using T = data_array<uint64_t,8>;
+
+		benchmark_alloc<T,uint8_t,P>( out );
+		benchmark_alloc<T,uint16_t,P>( out );
+		benchmark_alloc<T,uint32_t,P>( out );
+	}
+
+	return 0;
+}
+
+int main5() {
+	{
+		ofstream out("output/parallel1.csv");
+		benchmark_parallel<uint8_t,uint32_t>( out );
+	}
+	{
+		ofstream out("output/parallel4.csv");
+		benchmark_parallel<uint32_t,uint32_t>( out );
+	}
+	{
+		ofstream out("output/parallel8.csv");
+		benchmark_parallel<uint64_t,uint32_t>( out );
+	}
+
+	return 0;
+}
+
+int main6() {
+	{
+		ofstream out("output/simd1.csv");
+		benchmark_simd<uint8_t>( out );
+	}
+	{
+		ofstream out("output/simd2.csv");
+		benchmark_simd<uint16_t>( out );
+	}
+	{
+		ofstream out("output/simd4.csv");
+		benchmark_simd<uint32_t>( out );
+	}
+	{
+		ofstream out("output/simd8.csv");
+		benchmark_simd<uint64_t>( out );
+	}
+	{
+		ofstream out("output/simd4f.csv");
+		benchmark_simd<float>( out );
+	}
+	{
+		ofstream out("output/simd8f.csv");
+		benchmark_simd<double>( out );
+	}
+
+	return 0;
+}
+
+int main7() {
+	{
+		ofstream out("output/positions4.csv");
+		benchmark_positions<uint32_t,uint32_t>( out );
+	}
+	{
+		ofstream out("output/positions8.csv");
+		benchmark_positions<uint64_t,uint32_t>( out );
+	}
+
+	return 0;
+}
+
+int main8() {
+	{
+		ofstream out("output/remove4.csv");
+		benchmark_remove<uint32_t,uint32_t>( out );
+	}
+	{
+		ofstream out("output/remove64.csv");
+		benchmark_remove<data_array<uint64_t,8>,uint32_t>( out );
+	}
+	{
+		ofstream out("output/trim4.csv");
+		benchmark_trim<uint32_t,uint32_t>( out );
+	}
+	{
+		ofstream out("output/append4.csv");
+		benchmark_append<uint32_t,uint32_t>( out );
+	}
+	{
+		ofstream out("output/append64.csv");
+		benchmark_append<data_array<uint64_t,8>,uint32_t>( out );
+	}
+
+	return 0;
+}
+
+int main9() {
+	{
+		ofstream out("output/ordered8.csv");
+		benchmark_ordered<uint64_t,uint32_t>( out );
+	}
+	{
+		ofstream out("output/ordered64.csv");
+		benchmark_ordered<data_array<uint64_t,8>,uint32_t>( out );
+	}
+
+	return 0;
+}
+
+int main10() {
+	{
+		ofstream out("output/storage4.csv");
+		benchmark_storage<uint32_t,uint32_t>( out );
+	}
+	{
+		ofstream out("output/storage128.csv");
+		benchmark_storage<data_array<uint64_t,16>,uint32_t>( out );
+	}
+
+	return 0;
+}
+
+int main11() {
+
+	using P = preallocate_enable;
+	{
+		ofstream out("output/forward4.csv");
+		print_forward_header(out);
+		benchmark_forward<uint32_t,uint16_t,P>( out );
+		benchmark_forward<uint32_t,uint32_t,P>( out );
+	}
+	{
+		ofstream out("output/forward8.csv");
+		print_forward_header(out);
+		benchmark_forward<uint64_t,uint32_t,P>( out );
+	}
+	{
+		ofstream out("output/forward64.csv");
+		print_forward_header(out);
+		benchmark_forward<data_array<uint64_t,8>,uint32_t,P>( out );
+	}
+
+	return 0;
+}
+
+int main12() {
+
+	using P = preallocate_enable;
+	{
+		ofstream out("output/xor1.csv");
+		print_list_header( out, { "stdlist", "cwlist", "xorlist", "stdlist ratio", "cwlist ratio" } );
+		benchmark_xor<uint8_t,uint16_t,P>( out );
+		benchmark_xor<uint8_t,uint32_t,P>( out );
+	}
+	{
+		ofstream out("output/xor4.csv");
+		print_list_header( out, { "stdlist", "cwlist", "xorlist", "stdlist ratio", "cwlist ratio" } );
+		benchmark_xor<uint32_t,uint32_t,P>( out );
+	}
+
+	return 0;
+}
+
+int main13() {
+
+	using P = preallocate_disable;
+	{
+		ofstream out("output/adaptive1.csv");
+		print_list_header( out, { "list64", "list32", "adaptive", "list64 ratio", "list32 ratio" } );
+		benchmark_adaptive<uint8_t,P>( out );
+	}
+	{
+		ofstream out("output/adaptive4.csv");
+		print_list_header( out, { "list64", "list32", "adaptive", "list64 ratio", "list32 ratio" } );
+		benchmark_adaptive<uint32_t,P>( out );
+	}
+
+	return 0;
+}
+
+int main14() {
+	{
+		ofstream out("output/packed4.csv");
+		benchmark_packed<uint32_t>( out );
+	}
+	{
+		ofstream out("output/packed8.csv");
+		benchmark_packed<uint64_t>( out );
+	}
+
+	return 0;
+}
+
+int main15() {
+
+	using P = preallocate_enable;
+	{
+		ofstream out("output/unrolled4.csv");
+		print_unrolled_header( out );
+		benchmark_unrolled<uint32_t,uint32_t,P>( out );
+	}
+	{
+		ofstream out("output/unrolled8.csv");
+		print_unrolled_header( out );
+		benchmark_unrolled<uint64_t,uint32_t,P>( out );
+	}
+
+	return 0;
+}
+
+int main16() {
+	{
+		ofstream out("output/queue.csv");
+		out << "threads,"
+		       "stdlist mops,stdlist latency,"
+		       "cwlist mops,cwlist latency,"
+		       "concurrent mops,concurrent latency,"
+		       "stdlist ratio,cwlist ratio,"
+		    << endl;
+		benchmark_queue<uint32_t>( out );
+	}
+
+	return 0;
+}
+
+int main17() {
+	{
+		ofstream out("output/snapshot.csv");
+		out << "threads,"
+		       "locked mreads,locked kupdates,"
+		       "snapshot mreads,snapshot kupdates,"
+		       "ratio,"
+		    << endl;
+		benchmark_snapshot<uint32_t>( out );
+	}
+
+	return 0;
+}
+
+int main18() {
+	{
+		ofstream out("output/mapped.csv");
+		out << "N,"
+		       "rebuild,open,open and walk,"
+		       "open ratio,walk ratio,"
+		    << endl;
+		benchmark_mapped<uint64_t,uint32_t>( out );
+	}
+
+	return 0;
+}
+
+int main19() {
+	{
+		ofstream out("output/list_io.csv");
+		out << "N,"
+		       "element save,element load,"
+		       "storage save,storage load,"
+		       "list order save,list order load,"
+		       "storage save ratio,storage load ratio,"
+		       "list order save ratio,list order load ratio,"
+		    << endl;
+		benchmark_list_io<uint64_t,uint32_t>( out );
+	}
+
+	return 0;
+}
+
 int main() {
 	main1();
 	main2();
+	main3();
+	main4();
+	main5();
+	main6();
+	main7();
+	main8();
+	main9();
+	main10();
+	main11();
+	main12();
+	main13();
+	main14();
+	main15();
+	main16();
+	main17();
+	main18();
+	main19();
 }
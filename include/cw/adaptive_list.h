@@ -0,0 +1,665 @@
+#ifndef INCLUDED_CW_ADAPTIVE_LIST
+#define INCLUDED_CW_ADAPTIVE_LIST
+#include <cstdint>
+#include <algorithm>
+#include <vector>
+#include <memory>
+#include <new>
+#include <utility>
+#include <limits>
+#include <iterator>
+#include <type_traits>
+#include "list.h"
+
+#if _MSC_VER <= 1800
+#define noexcept throw()
+#endif
+
+namespace cw {
+
+// A cw::list whose index type grows with it. It starts with 8-bit links and
+// re-encodes them to 16, 32 and then 64 bits when an insertion would overflow
+// the index type, so a small list never pays for wide links and a large one
+// never throws at max_size().
+//
+// The list is held as one of list<T,uint8_t,A> .. list<T,uint64_t,A>; the
+// values are moved across and only the links are rewritten. Each re-encode
+// is O(N), and happens only when N crosses the index range, so growth is
+// amortized O(1) as with a vector. shrink_to_fit() narrows the links again.
+//
+// Iterators carry a 64-bit index, so a re-encode doesn't invalidate them.
+
+template<typename L,bool is_const>
+struct adaptive_list_iterator {
+	using value_type             = typename L::value_type;
+	using index_type             = typename L::index_type;
+	using size_type              = size_t;
+	using difference_type        = std::ptrdiff_t;
+	using reference              = typename std::conditional<is_const,const value_type&,value_type&>::type;
+	using pointer                = typename std::conditional<is_const,const value_type*,value_type*>::type;
+	using iterator_category      = std::bidirectional_iterator_tag;
+	using list_type              = typename std::conditional<is_const,const L,L>::type;
+
+	adaptive_list_iterator() = default;
+
+	adaptive_list_iterator( list_type* p, index_type index ) : p(p), index(index) {}
+
+	// iterator to const_iterator
+	template<bool rhs_const,typename = typename std::enable_if<is_const && !rhs_const>::type>
+	adaptive_list_iterator( const adaptive_list_iterator<L,rhs_const>& it ) : p(it.p), index(it.index) {}
+
+	reference operator*() const {
+		return p->slot_value(index);
+	}
+
+	pointer operator->() const {
+		return &p->slot_value(index);
+	}
+
+	adaptive_list_iterator& operator++() {
+		index = p->next_index(index);
+		return *this;
+	}
+
+	adaptive_list_iterator& operator--() {
+		index = p->prev_index(index);
+		return *this;
+	}
+
+	adaptive_list_iterator operator++(int) {
+		auto old = *this;
+		++(*this);
+		return old;
+	}
+
+	adaptive_list_iterator operator--(int) {
+		auto old = *this;
+		--(*this);
+		return old;
+	}
+
+	bool operator==( const adaptive_list_iterator& rhs ) const {
+		return (p == rhs.p) && (index == rhs.index);
+	}
+
+	bool operator!=( const adaptive_list_iterator& rhs ) const {
+		return !( *this == rhs );
+	}
+
+	list_type* p;
+	index_type index;
+};
+
+// T -- the value type
+// A -- the allocator, rebound separately for the values and the nodes
+template<typename T,typename A = std::allocator<T>>
+struct adaptive_list {
+	using value_type             = T;
+	using index_type             = uint64_t;
+	using size_type              = size_t;
+	using difference_type        = std::ptrdiff_t;
+	using reference              = T&;
+	using const_reference        = const T&;
+	using pointer                = T*;
+	using const_pointer          = const T*;
+	using list_type              = adaptive_list<T,A>;
+	using iterator               = adaptive_list_iterator<list_type,false>;
+	using const_iterator         = adaptive_list_iterator<list_type,true>;
+	using reverse_iterator       = std::reverse_iterator<iterator>;
+	using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+	using allocator_type         = A;
+
+	// SFINAE guard for the iterator-pair overloads
+	template<typename It>
+	using is_input_iterator = typename std::enable_if<std::is_convertible<typename std::iterator_traits<It>::iterator_category,std::input_iterator_tag>::value>::type;
+
+	using list8                  = list<T,uint8_t,A>;
+	using list16                 = list<T,uint16_t,A>;
+	using list32                 = list<T,uint32_t,A>;
+	using list64                 = list<T,uint64_t,A>;
+
+	static const index_type terminator = index_type(-1);
+
+	adaptive_list() : l8() {}
+
+	explicit adaptive_list( const allocator_type& alloc ) : l8( alloc ) {}
+
+	adaptive_list( const list_type& rhs ) : bytes( rhs.bytes ) {
+		rhs.visit( [this]( const auto& l ) {
+			using L = std::decay_t<decltype(l)>;
+			new (&this->get( tag<typename L::index_type>() )) L( l );
+		});
+	}
+
+	adaptive_list( list_type&& rhs ) : bytes( rhs.bytes ) {
+		rhs.visit( [this]( auto& l ) {
+			using L = std::decay_t<decltype(l)>;
+			new (&this->get( tag<typename L::index_type>() )) L( std::move(l) );
+			l.clear();
+		});
+	}
+
+	adaptive_list( const std::initializer_list<value_type>& rhs, const allocator_type& alloc = allocator_type() ) : adaptive_list(alloc) {
+		assign( rhs );
+	}
+
+	explicit adaptive_list( size_type N, const allocator_type& alloc = allocator_type() ) : adaptive_list(alloc) {
+		resize(N);
+	}
+
+	template<typename InputIt,typename = is_input_iterator<InputIt>>
+	adaptive_list( InputIt first, InputIt last, const allocator_type& alloc = allocator_type() ) : adaptive_list(alloc) {
+		assign( first, last );
+	}
+
+	~adaptive_list() {
+		destroy();
+	}
+
+	allocator_type get_allocator() const noexcept {
+		return visit( []( const auto& l ) { return l.get_allocator(); } );
+	}
+
+	// Assignment
+
+	list_type& operator=( const list_type& rhs ) {
+		if( this != &rhs ) {
+			list_type copy( rhs );
+			swap( copy );
+		}
+		return *this;
+	}
+
+	list_type& operator=( list_type&& rhs ) {
+		if( this != &rhs ) {
+			destroy();
+			bytes = rhs.bytes;
+			rhs.visit( [this]( auto& l ) {
+				using L = std::decay_t<decltype(l)>;
+				new (&this->get( tag<typename L::index_type>() )) L( std::move(l) );
+				l.clear();
+			});
+		}
+		return *this;
+	}
+
+	list_type& operator=( const std::initializer_list<value_type>& rhs ) {
+		assign( rhs );
+		return *this;
+	}
+
+	void assign( size_type count, const T& value ) {
+		clear();
+		reserve_index( count );
+		visit( [&]( auto& l ) { l.assign( count, value ); } );
+	}
+
+	template<typename InputIt,typename = is_input_iterator<InputIt>>
+	void assign( InputIt first, InputIt last ) {
+		clear();
+		assign_range( first, last, typename std::iterator_traits<InputIt>::iterator_category() );
+	}
+
+	void assign( const std::initializer_list<T>& rhs ) {
+		assign( std::begin(rhs), std::end(rhs) );
+	}
+
+	// Element Access
+
+	value_type& front() { return visit( []( auto& l ) -> value_type& { return l.front(); } ); }
+
+	const value_type& front() const { return slot_value( next_index( terminator ) ); }
+
+	value_type& back() { return visit( []( auto& l ) -> value_type& { return l.back(); } ); }
+
+	const value_type& back() const { return slot_value( prev_index( terminator ) ); }
+
+	// the values in storage order
+	T* data() noexcept { return visit( []( auto& l ) { return l.data(); } ); }
+
+	const T* data() const noexcept { return visit( []( const auto& l ) { return l.data(); } ); }
+
+	// Capacity
+
+	bool empty() const noexcept { return size() == 0; }
+
+	size_type size() const noexcept { return visit( []( const auto& l ) { return l.size(); } ); }
+
+	size_type max_size() const noexcept { return std::numeric_limits<uint64_t>::max(); }
+
+	// the bytes per link of the current encoding -- 1, 2, 4 or 8
+	size_t index_bytes() const noexcept { return bytes; }
+
+	// reserving also widens the links to fit N, so growing to N re-encodes nothing
+	void reserve( size_type N ) {
+		reserve_index( N );
+		visit( [N]( auto& l ) { l.reserve(N); } );
+	}
+
+	size_type capacity() const noexcept { return visit( []( const auto& l ) { return l.capacity(); } ); }
+
+	// narrows the links to the smallest index type that fits, then releases the unused storage
+	void shrink_to_fit() {
+		size_type N = size();
+		if( bytes > 1 && N <= std::numeric_limits<uint8_t>::max() ) {
+			reencode<uint8_t>();
+		} else if( bytes > 2 && N <= std::numeric_limits<uint16_t>::max() ) {
+			reencode<uint16_t>();
+		} else if( bytes > 4 && N <= std::numeric_limits<uint32_t>::max() ) {
+			reencode<uint32_t>();
+		}
+		visit( []( auto& l ) { l.shrink_to_fit(); } );
+	}
+
+	// Modifiers
+
+	// keeps the index width, as clear() keeps the capacity
+	void clear() noexcept {
+		visit( []( auto& l ) { l.clear(); } );
+	}
+
+	iterator insert( const_iterator pos, const value_type& x ) {
+		return emplace( pos, x );
+	}
+
+	iterator insert( const_iterator pos, value_type&& x ) {
+		return emplace( pos, std::move(x) );
+	}
+
+	template<typename InputIt,typename = is_input_iterator<InputIt>>
+	iterator insert( const_iterator pos, InputIt first, InputIt last ) {
+		reserve_for( first, last, typename std::iterator_traits<InputIt>::iterator_category() );
+		if( first == last ) return iterator( this, pos.index );
+		iterator result = insert( pos, *first );
+		for( ++first; first != last; ++first ) {
+			insert( pos, *first );
+		}
+		return result;
+	}
+
+	iterator insert( const_iterator pos, const std::initializer_list<value_type>& rhs ) {
+		return insert( pos, std::begin(rhs), std::end(rhs) );
+	}
+
+	template<typename... Ts>
+	iterator emplace( const_iterator pos, Ts&&... xs ) {
+		reserve_index( slots() + 1 );
+		index_type index = visit( [&]( auto& l ) {
+			using L = std::decay_t<decltype(l)>;
+			using U = typename L::index_type;
+			auto it = l.emplace( typename L::const_iterator( &l, convert_index<U>( pos.index ) ), std::forward<Ts>(xs)... );
+			return convert_index<index_type>( it.index );
+		});
+		return iterator( this, index );
+	}
+
+	iterator erase( const_iterator pos ) {
+		return iterator( this, visit( [&]( auto& l ) {
+			using L = std::decay_t<decltype(l)>;
+			using U = typename L::index_type;
+			auto it = l.erase( typename L::const_iterator( &l, convert_index<U>( pos.index ) ) );
+			return convert_index<index_type>( it.index );
+		}));
+	}
+
+	iterator erase( const_iterator first, const_iterator last ) {
+		return iterator( this, visit( [&]( auto& l ) {
+			using L = std::decay_t<decltype(l)>;
+			using U = typename L::index_type;
+			auto it = l.erase( typename L::const_iterator( &l, convert_index<U>( first.index ) ),
+			                   typename L::const_iterator( &l, convert_index<U>( last.index ) ) );
+			return convert_index<index_type>( it.index );
+		}));
+	}
+
+	void push_front( const value_type& x ) {
+		emplace_front( x );
+	}
+
+	void push_front( value_type&& x ) {
+		emplace_front( std::move(x) );
+	}
+
+	void push_back( const value_type& x ) {
+		emplace_back( x );
+	}
+
+	void push_back( value_type&& x ) {
+		emplace_back( std::move(x) );
+	}
+
+	template<typename... Ts>
+	void emplace_front( Ts&&... xs ) {
+		reserve_index( slots() + 1 );
+		visit( [&]( auto& l ) { l.emplace_front( std::forward<Ts>(xs)... ); } );
+	}
+
+	template<typename... Ts>
+	void emplace_back( Ts&&... xs ) {
+		reserve_index( slots() + 1 );
+		visit( [&]( auto& l ) { l.emplace_back( std::forward<Ts>(xs)... ); } );
+	}
+
+	void pop_front() {
+		visit( []( auto& l ) { l.pop_front(); } );
+	}
+
+	void pop_back() {
+		visit( []( auto& l ) { l.pop_back(); } );
+	}
+
+	void resize( size_type N ) {
+		reserve_index( N );
+		visit( [N]( auto& l ) { l.resize(N); } );
+	}
+
+	void resize( size_type N, const value_type& x ) {
+		reserve_index( N );
+		visit( [&]( auto& l ) { l.resize( N, x ); } );
+	}
+
+	void swap( adaptive_list& rhs ) {
+		list_type tmp( std::move(rhs) );
+		rhs = std::move(*this);
+		*this = std::move(tmp);
+	}
+
+	// Iterators
+
+	iterator begin() noexcept {
+		return iterator( this, next_index( terminator ) );
+	}
+
+	iterator end() noexcept {
+		return iterator( this, terminator );
+	}
+
+	const_iterator begin() const noexcept {
+		return const_iterator( this, next_index( terminator ) );
+	}
+
+	const_iterator end() const noexcept {
+		return const_iterator( this, terminator );
+	}
+
+	const_iterator cbegin() const noexcept {
+		return begin();
+	}
+
+	const_iterator cend() const noexcept {
+		return end();
+	}
+
+	reverse_iterator rbegin() noexcept {
+		return reverse_iterator( end() );
+	}
+
+	reverse_iterator rend() noexcept {
+		return reverse_iterator( begin() );
+	}
+
+	const_reverse_iterator rbegin() const noexcept {
+		return const_reverse_iterator( end() );
+	}
+
+	const_reverse_iterator rend() const noexcept {
+		return const_reverse_iterator( begin() );
+	}
+
+	const_reverse_iterator crbegin() const noexcept {
+		return rbegin();
+	}
+
+	const_reverse_iterator crend() const noexcept {
+		return rend();
+	}
+
+	// Operations
+
+	void reverse() noexcept {
+		visit( []( auto& l ) { l.reverse(); } );
+	}
+
+	size_type remove( const T& value ) {
+		return visit( [&]( auto& l ) { return l.remove( value ); } );
+	}
+
+	template<typename Pred>
+	size_type remove_if( Pred pred ) {
+		return visit( [&]( auto& l ) { return l.remove_if( pred ); } );
+	}
+
+	template<typename Comp>
+	size_type unique( Comp comp ) {
+		return visit( [&]( auto& l ) { return l.unique( comp ); } );
+	}
+
+	size_type unique() {
+		return visit( []( auto& l ) { return l.unique(); } );
+	}
+
+	template<typename Comp>
+	void sort( Comp comp ) {
+		visit( [&]( auto& l ) { l.sort( comp ); } );
+	}
+
+	void sort() {
+		visit( []( auto& l ) { l.sort(); } );
+	}
+
+	void compact() {
+		visit( []( auto& l ) { l.compact(); } );
+	}
+
+	// Calls f with the list in its current encoding, e.g. to run the algorithms
+	// of list_algorithm.h on it. f must not keep the list past the call.
+	template<typename F>
+	decltype(auto) visit( F&& f ) {
+		switch( bytes ) {
+		case 1:  return f( l8 );
+		case 2:  return f( l16 );
+		case 4:  return f( l32 );
+		default: return f( l64 );
+		}
+	}
+
+	template<typename F>
+	decltype(auto) visit( F&& f ) const {
+		switch( bytes ) {
+		case 1:  return f( l8 );
+		case 2:  return f( l16 );
+		case 4:  return f( l32 );
+		default: return f( l64 );
+		}
+	}
+
+	friend iterator;
+	friend const_iterator;
+
+protected:
+
+	template<typename U>
+	struct tag {};
+
+	list8& get( tag<uint8_t> ) noexcept { return l8; }
+	list16& get( tag<uint16_t> ) noexcept { return l16; }
+	list32& get( tag<uint32_t> ) noexcept { return l32; }
+	list64& get( tag<uint64_t> ) noexcept { return l64; }
+
+	// the bytes per link of the active member
+	unsigned char bytes = 1;
+
+	union {
+		list8 l8;
+		list16 l16;
+		list32 l32;
+		list64 l64;
+	};
+
+	void destroy() noexcept {
+		visit( []( auto& l ) {
+			using L = std::decay_t<decltype(l)>;
+			l.~L();
+		});
+	}
+
+	size_type slots() const noexcept {
+		return visit( []( const auto& l ) { return l.slots(); } );
+	}
+
+	// Iteration
+
+	value_type& slot_value( index_type i ) {
+		return visit( [i]( auto& l ) -> value_type& { return l.slot_value( typename std::decay_t<decltype(l)>::index_type(i) ); } );
+	}
+
+	const value_type& slot_value( index_type i ) const {
+		return visit( [i]( const auto& l ) -> const value_type& { return l.slot_value( typename std::decay_t<decltype(l)>::index_type(i) ); } );
+	}
+
+	// stepping from the terminator wraps to the head, or back to the tail.
+	// as with list_iterator, a linear list steps without loading the node.
+	index_type next_index( index_type i ) const noexcept {
+		return visit( [i]( const auto& l ) {
+			using U = typename std::decay_t<decltype(l)>::index_type;
+			if( i == terminator ) return convert_index<index_type>( l.head );
+			if( l.linear() ) return ( i == convert_index<index_type>( l.tail ) ) ? terminator : index_type(i + 1);
+			return convert_index<index_type>( l.next_link( U(i) ) );
+		});
+	}
+
+	index_type prev_index( index_type i ) const noexcept {
+		return visit( [i]( const auto& l ) {
+			using U = typename std::decay_t<decltype(l)>::index_type;
+			if( i == terminator ) return convert_index<index_type>( l.tail );
+			if( l.linear() ) return ( i == convert_index<index_type>( l.head ) ) ? terminator : index_type(i - 1);
+			return convert_index<index_type>( l.prev_link( U(i) ) );
+		});
+	}
+
+	// Encoding
+
+	// an index in another index type. the +1 wraps the terminator to zero and the
+	// -1 wraps it back to the all-ones terminator of To, widening or narrowing;
+	// with no branch, the loop of convert_links vectorizes.
+	template<typename To,typename From>
+	static To convert_index( From x ) noexcept {
+		return To( To( From( x + 1 ) ) - 1 );
+	}
+
+	template<typename To,typename From>
+	static void convert_links( const list_node<From>* src, size_t n, list_node<To>* dst ) noexcept {
+		for(size_t i=0;i<n;++i) {
+			dst[i].prev = convert_index<To>( src[i].prev );
+			dst[i].next = convert_index<To>( src[i].next );
+		}
+	}
+
+	// move the list into the encoding with index type W. the values move across
+	// and the links are rewritten; slot indices are unchanged.
+	template<typename W>
+	void reencode() {
+		using V = list<T,W,A>;
+		V to( get_allocator() );
+		visit( [&to]( auto& from ) {
+			to.values = std::move( from.values );
+			to.nodes.reserve( to.values.capacity() );
+			to.nodes.resize( from.nodes.size() );
+			convert_links( from.nodes.data(), from.nodes.size(), to.nodes.data() );
+			to.head = convert_index<W>( from.head );
+			to.tail = convert_index<W>( from.tail );
+			to.compact_ratio = from.compact_ratio;
+			to.scattered = from.scattered;
+			if( from.positions_indexed() ) {
+				to.index_positions( true );
+			}
+		});
+		destroy();
+		bytes = sizeof(W);
+		new (&get( tag<W>() )) V( std::move(to) );
+	}
+
+	// widen the links, if needed, so the storage can hold N slots
+	void reserve_index( size_type N ) {
+		if( N <= visit( []( const auto& l ) { return l.max_size(); } ) ) return;
+		if( N <= std::numeric_limits<uint16_t>::max() ) {
+			reencode<uint16_t>();
+		} else if( N <= std::numeric_limits<uint32_t>::max() ) {
+			reencode<uint32_t>();
+		} else {
+			reencode<uint64_t>();
+		}
+	}
+
+	template<typename It>
+	void reserve_for( It first, It last, std::forward_iterator_tag ) {
+		reserve_index( slots() + size_type( std::distance( first, last ) ) );
+	}
+
+	template<typename It>
+	void reserve_for( It, It, std::input_iterator_tag ) {}
+
+	template<typename It>
+	void assign_range( It first, It last, std::forward_iterator_tag ) {
+		reserve_index( size_type( std::distance( first, last ) ) );
+		visit( [&]( auto& l ) { l.assign( first, last ); } );
+	}
+
+	template<typename It>
+	void assign_range( It first, It last, std::input_iterator_tag ) {
+		for( ; first != last; ++first ) {
+			emplace_back( *first );
+		}
+	}
+
+};
+
+// Operators
+
+template<typename T, typename A>
+bool operator==( const cw::adaptive_list<T,A>& lhs, const cw::adaptive_list<T,A>& rhs ) {
+	if( lhs.size() != rhs.size() ) return false;
+	return std::equal( lhs.begin(), lhs.end(), rhs.begin() );
+}
+
+template<typename T, typename A>
+bool operator!=( const cw::adaptive_list<T,A>& lhs, const cw::adaptive_list<T,A>& rhs ) {
+	return !(lhs == rhs);
+}
+
+template<typename T, typename A>
+bool operator<( const cw::adaptive_list<T,A>& lhs, const cw::adaptive_list<T,A>& rhs ) {
+	return std::lexicographical_compare( lhs.begin(), lhs.end(), rhs.begin(), rhs.end() );
+}
+
+template<typename T, typename A>
+bool operator>( const cw::adaptive_list<T,A>& lhs, const cw::adaptive_list<T,A>& rhs ) {
+	return rhs < lhs;
+}
+
+template<typename T, typename A>
+bool operator<=( const cw::adaptive_list<T,A>& lhs, const cw::adaptive_list<T,A>& rhs ) {
+	return !(rhs < lhs);
+}
+
+template<typename T, typename A>
+bool operator>=( const cw::adaptive_list<T,A>& lhs, const cw::adaptive_list<T,A>& rhs ) {
+	return !(lhs < rhs);
+}
+
+}
+
+namespace std {
+
+template<typename T, typename A>
+void swap( cw::adaptive_list<T,A>& lhs, cw::adaptive_list<T,A>& rhs ) {
+	lhs.swap(rhs);
+}
+
+}
+
+#if _MSC_VER <= 1800
+#undef noexcept
+#endif
+
+#endif
@@ -0,0 +1,242 @@
+#ifndef INCLUDED_CW_CONCURRENT_QUEUE
+#define INCLUDED_CW_CONCURRENT_QUEUE
+#include <cstdint>
+#include <vector>
+#include <memory>
+#include <new>
+#include <utility>
+#include <atomic>
+#include <exception>
+#include <limits>
+#include <type_traits>
+
+#if _MSC_VER <= 1800
+#define noexcept throw()
+#endif
+
+namespace cw {
+
+// A bounded lock-free queue for many producers and many consumers, on the
+// design of cw::list: the values and the nodes live in two preallocated
+// vectors and the links are indices into them.
+//
+// An index fits in 32 bits, which leaves the upper half of a 64-bit word for a
+// tag that is bumped on every update. Head, tail, the next links and the top
+// of the free list are all tagged words, so a single compare-and-swap detects
+// a slot that was taken and reused in between (the ABA problem) without
+// pointers or double-width atomics. The queue is that of Michael and Scott,
+// with a dummy node at the head, and the free slots form a Treiber stack.
+//
+// A slot is recycled once its value has been taken and the head has moved
+// past it, whichever comes last, so a consumer moves its value out after
+// winning the head and T needn't be trivially copyable.
+
+// next is the tagged link of the queue, free_next the link of the free list.
+// refs counts what must happen before the slot is free again.
+struct concurrent_queue_node {
+	std::atomic<uint64_t> next;
+	std::atomic<uint32_t> free_next;
+	std::atomic<uint32_t> refs;
+};
+
+// T -- the value type
+// U -- the index type, an unsigned integer type of at most 32 bits
+// A -- the allocator, rebound separately for the values and the nodes
+template<typename T,typename U = uint32_t,typename A = std::allocator<T>>
+struct concurrent_queue {
+	using value_type             = T;
+	using index_type             = U;
+	using size_type              = size_t;
+	using allocator_type         = A;
+
+	static_assert( std::is_unsigned<U>::value && sizeof(U) <= 4, "cw::concurrent_queue -- the index type must fit in half a tagged word" );
+
+	using node_type              = concurrent_queue_node;
+	using word_type              = uint64_t;
+	using storage_type           = typename std::aligned_storage<sizeof(T),alignof(T)>::type;
+	using value_allocator_type   = typename std::allocator_traits<A>::template rebind_alloc<storage_type>;
+	using node_allocator_type    = typename std::allocator_traits<A>::template rebind_alloc<node_type>;
+	using values_type            = std::vector<storage_type,value_allocator_type>;
+	using nodes_type             = std::vector<node_type,node_allocator_type>;
+
+	static const index_type terminator = index_type(-1);
+
+	// one slot more than the capacity, for the dummy node at the head
+	values_type values;
+	nodes_type nodes;
+
+	// on separate cache lines, so producers and consumers don't contend for one
+	alignas(64) std::atomic<word_type> head;
+	alignas(64) std::atomic<word_type> tail;
+	alignas(64) std::atomic<word_type> free_top;
+
+	// preallocates all the storage; push_back() fails once capacity values are queued
+	explicit concurrent_queue( size_type capacity, const allocator_type& alloc = allocator_type() ) :
+		values( slots( capacity ), value_allocator_type(alloc) ),
+		nodes( slots( capacity ), node_allocator_type(alloc) )
+	{
+		// slot 0 is the dummy, the rest are free
+		nodes[0].next.store( pack( terminator, 0 ), std::memory_order_relaxed );
+		nodes[0].refs.store( 1, std::memory_order_relaxed );
+		for(size_type i=1;i<=capacity;++i) {
+			index_type next = ( i == capacity ) ? terminator : index_type(i + 1);
+			nodes[i].next.store( pack( terminator, 0 ), std::memory_order_relaxed );
+			nodes[i].free_next.store( next, std::memory_order_relaxed );
+		}
+		head.store( pack( 0, 0 ), std::memory_order_relaxed );
+		tail.store( pack( 0, 0 ), std::memory_order_relaxed );
+		free_top.store( pack( capacity > 0 ? index_type(1) : index_type(terminator), 0 ), std::memory_order_relaxed );
+	}
+
+	concurrent_queue( const concurrent_queue& ) = delete;
+
+	concurrent_queue& operator=( const concurrent_queue& ) = delete;
+
+	~concurrent_queue() {
+		for( index_type i = index_of( nodes[ index_of( head.load() ) ].next.load() ); i != terminator; i = index_of( nodes[i].next.load() ) ) {
+			value(i).~T();
+		}
+	}
+
+	allocator_type get_allocator() const noexcept {
+		return allocator_type( values.get_allocator() );
+	}
+
+	// Capacity
+
+	size_type capacity() const noexcept { return values.size() - 1; }
+
+	// a snapshot, which may be stale by the time it returns
+	bool empty() const noexcept {
+		return index_of( nodes[ index_of( head.load() ) ].next.load() ) == terminator;
+	}
+
+	static bool is_lock_free() noexcept {
+		return std::atomic<word_type>().is_lock_free();
+	}
+
+	// Modifiers
+
+	// queue a value at the back, returning false if the queue is full. lock-free.
+	bool push_back( const value_type& x ) {
+		return emplace_back( x );
+	}
+
+	bool push_back( value_type&& x ) {
+		return emplace_back( std::move(x) );
+	}
+
+	template<typename... Ts>
+	bool emplace_back( Ts&&... xs ) {
+		index_type n = pop_free();
+		if( n == terminator ) return false;
+		new (&value(n)) value_type( std::forward<Ts>(xs)... );
+
+		// taken by a consumer, and passed by the head
+		nodes[n].refs.store( 2, std::memory_order_relaxed );
+		word_type old = nodes[n].next.load( std::memory_order_relaxed );
+		nodes[n].next.store( pack( terminator, tag_of(old) + 1 ), std::memory_order_relaxed );
+
+		for(;;) {
+			word_type t = tail.load( std::memory_order_acquire );
+			word_type next = nodes[ index_of(t) ].next.load( std::memory_order_acquire );
+			if( t != tail.load( std::memory_order_acquire ) ) continue;
+			if( index_of(next) == terminator ) {
+				// the release publishes the value with the link
+				if( nodes[ index_of(t) ].next.compare_exchange_weak( next, pack( n, tag_of(next) + 1 ), std::memory_order_release, std::memory_order_relaxed ) ) {
+					tail.compare_exchange_strong( t, pack( n, tag_of(t) + 1 ), std::memory_order_release, std::memory_order_relaxed );
+					return true;
+				}
+			} else {
+				// another producer linked a node but hasn't swung the tail yet
+				tail.compare_exchange_strong( t, pack( index_of(next), tag_of(t) + 1 ), std::memory_order_release, std::memory_order_relaxed );
+			}
+		}
+	}
+
+	// move the front value into x, returning false if the queue is empty. lock-free.
+	bool pop_front( value_type& x ) {
+		for(;;) {
+			word_type h = head.load( std::memory_order_acquire );
+			word_type t = tail.load( std::memory_order_acquire );
+			word_type next = nodes[ index_of(h) ].next.load( std::memory_order_acquire );
+			if( h != head.load( std::memory_order_acquire ) ) continue;
+			index_type n = index_of(next);
+			if( index_of(h) == index_of(t) ) {
+				if( n == terminator ) return false;
+				tail.compare_exchange_strong( t, pack( n, tag_of(t) + 1 ), std::memory_order_release, std::memory_order_relaxed );
+			} else if( head.compare_exchange_weak( h, pack( n, tag_of(h) + 1 ), std::memory_order_acq_rel, std::memory_order_relaxed ) ) {
+				// n is the new dummy, its value is ours alone
+				x = std::move( value(n) );
+				value(n).~T();
+				release( n );
+				release( index_of(h) );
+				return true;
+			}
+		}
+	}
+
+protected:
+
+	// the dummy and capacity more
+	static size_type slots( size_type capacity ) {
+		if( capacity >= size_type( std::numeric_limits<index_type>::max() ) ) {
+			throw std::exception("cw::concurrent_queue -- capacity too big for index_type");
+		}
+		return capacity + 1;
+	}
+
+	static word_type pack( index_type index, word_type tag ) noexcept {
+		return ( tag << 32 ) | word_type( index );
+	}
+
+	static index_type index_of( word_type w ) noexcept {
+		return index_type( w );
+	}
+
+	static word_type tag_of( word_type w ) noexcept {
+		return w >> 32;
+	}
+
+	value_type& value( index_type i ) noexcept {
+		return *reinterpret_cast<value_type*>( &values[i] );
+	}
+
+	// Free list
+
+	index_type pop_free() {
+		word_type top = free_top.load( std::memory_order_acquire );
+		for(;;) {
+			index_type i = index_of(top);
+			if( i == terminator ) return terminator;
+			// may read a slot another thread just took; the tag then fails the swap
+			index_type next = index_type( nodes[i].free_next.load( std::memory_order_relaxed ) );
+			if( free_top.compare_exchange_weak( top, pack( next, tag_of(top) + 1 ), std::memory_order_acquire, std::memory_order_acquire ) ) {
+				return i;
+			}
+		}
+	}
+
+	void push_free( index_type i ) {
+		word_type top = free_top.load( std::memory_order_relaxed );
+		do {
+			nodes[i].free_next.store( index_of(top), std::memory_order_relaxed );
+		} while( !free_top.compare_exchange_weak( top, pack( i, tag_of(top) + 1 ), std::memory_order_release, std::memory_order_relaxed ) );
+	}
+
+	// free the slot once both its value is taken and the head has passed it
+	void release( index_type i ) {
+		if( nodes[i].refs.fetch_sub( 1, std::memory_order_acq_rel ) == 1 ) {
+			push_free( i );
+		}
+	}
+
+};
+
+}
+
+#if _MSC_VER <= 1800
+#undef noexcept
+#endif
+
+#endif
@@ -0,0 +1,827 @@
+#ifndef INCLUDED_CW_FORWARD_LIST
+#define INCLUDED_CW_FORWARD_LIST
+#include <cstdint>
+#include <algorithm>
+#include <functional>
+#include <vector>
+#include <memory>
+#include <utility>
+#include <exception>
+#include <limits>
+#include <iterator>
+#include <type_traits>
+
+#if _MSC_VER <= 1800
+#define noexcept throw()
+#endif
+
+namespace cw {
+
+// A singly linked list stored in two vectors -- the values, and one next link
+// per slot. Half the link memory of cw::list, for lists that only go forward.
+//
+// Erased slots go on a free list, linked through the next links, and are reused
+// by later insertions. Once more than half the storage is free, the live slots at
+// the back are moved down into the free slots below them in one pass, which
+// relabels every next link. A moved slot's predecessor is never needed, so no
+// prev links are kept.
+
+template<typename L,bool is_const>
+struct forward_list_iterator {
+	using value_type             = typename L::value_type;
+	using index_type             = typename L::index_type;
+	using size_type              = size_t;
+	using difference_type        = std::ptrdiff_t;
+	using reference              = typename std::conditional<is_const,const value_type&,value_type&>::type;
+	using pointer                = typename std::conditional<is_const,const value_type*,value_type*>::type;
+	using iterator_category      = std::forward_iterator_tag;
+	using list_type              = typename std::conditional<is_const,const L,L>::type;
+
+	forward_list_iterator() = default;
+
+	forward_list_iterator( list_type* p, index_type index ) : p(p), index(index) {}
+
+	// iterator to const_iterator
+	template<bool rhs_const,typename = typename std::enable_if<is_const && !rhs_const>::type>
+	forward_list_iterator( const forward_list_iterator<L,rhs_const>& it ) : p(it.p), index(it.index) {}
+
+	reference operator*() const {
+		return p->values[index];
+	}
+
+	pointer operator->() const {
+		return &p->values[index];
+	}
+
+	forward_list_iterator& operator++() {
+		index = p->next_index(index);
+		return *this;
+	}
+
+	forward_list_iterator operator++(int) {
+		auto old = *this;
+		++(*this);
+		return old;
+	}
+
+	bool operator==( const forward_list_iterator& rhs ) const {
+		return (p == rhs.p) && (index == rhs.index);
+	}
+
+	bool operator!=( const forward_list_iterator& rhs ) const {
+		return !( *this == rhs );
+	}
+
+	list_type* p;
+	index_type index;
+};
+
+// T -- the value type
+// U -- the index type, an unsigned integer type
+// A -- the allocator, rebound separately for the values and the links
+template<typename T,typename U = uint32_t,typename A = std::allocator<T>>
+struct forward_list {
+	using value_type             = T;
+	using index_type             = U;
+	using size_type              = size_t;
+	using difference_type        = std::ptrdiff_t;
+	using reference              = T&;
+	using const_reference        = const T&;
+	using pointer                = T*;
+	using const_pointer          = const T*;
+	using list_type              = forward_list<T,U,A>;
+	using iterator               = forward_list_iterator<list_type,false>;
+	using const_iterator         = forward_list_iterator<list_type,true>;
+	using allocator_type         = A;
+
+	// SFINAE guard for the iterator-pair overloads
+	template<typename It>
+	using is_input_iterator = typename std::enable_if<std::is_convertible<typename std::iterator_traits<It>::iterator_category,std::input_iterator_tag>::value>::type;
+
+	using value_allocator_type   = typename std::allocator_traits<A>::template rebind_alloc<value_type>;
+	using link_allocator_type    = typename std::allocator_traits<A>::template rebind_alloc<index_type>;
+	using values_type            = std::vector<value_type,value_allocator_type>;
+	using links_type             = std::vector<index_type,link_allocator_type>;
+
+	static const index_type terminator = index_type(-1);
+
+	// the position of before_begin()
+	static const index_type before_head = index_type(-2);
+
+	values_type values;
+	links_type nexts;
+
+	index_type head = terminator;
+
+	// free slots, linked through nexts
+	index_type free_head = terminator;
+	size_type free_count = 0;
+
+	forward_list() = default;
+
+	explicit forward_list( const allocator_type& alloc ) :
+		values( value_allocator_type(alloc) ),
+		nexts( link_allocator_type(alloc) )
+	{}
+
+	forward_list( const list_type& rhs, const allocator_type& alloc ) :
+		values( rhs.values, value_allocator_type(alloc) ),
+		nexts( rhs.nexts, link_allocator_type(alloc) ),
+		head( rhs.head ),
+		free_head( rhs.free_head ),
+		free_count( rhs.free_count )
+	{}
+
+	forward_list( const std::initializer_list<value_type>& rhs, const allocator_type& alloc = allocator_type() ) : forward_list(alloc) {
+		assign( rhs );
+	}
+
+	explicit forward_list( size_type N, const allocator_type& alloc = allocator_type() ) : forward_list(alloc) {
+		resize(N);
+	}
+
+	forward_list( size_type N, const value_type& x, const allocator_type& alloc = allocator_type() ) : forward_list(alloc) {
+		assign( N, x );
+	}
+
+	template<typename InputIt,typename = is_input_iterator<InputIt>>
+	forward_list( InputIt first, InputIt last, const allocator_type& alloc = allocator_type() ) : forward_list(alloc) {
+		assign( first, last );
+	}
+
+	allocator_type get_allocator() const noexcept {
+		return allocator_type( values.get_allocator() );
+	}
+
+	// Assignment
+
+	list_type& operator=( const std::initializer_list<value_type>& rhs ) {
+		assign( rhs );
+		return *this;
+	}
+
+	void assign( size_type count, const T& value ) {
+		if( count > max_size() ) {
+			throw std::exception("cw::forward_list::assign() -- size too big for index_type");
+		}
+		values.assign( count, value );
+		set_default_links();
+	}
+
+	template<typename InputIt,typename = is_input_iterator<InputIt>>
+	void assign( InputIt first, InputIt last ) {
+		values.assign( first, last );
+		if( values.size() > max_size() ) {
+			clear();
+			throw std::exception("cw::forward_list::assign() -- size too big for index_type");
+		}
+		set_default_links();
+	}
+
+	void assign( const std::initializer_list<T>& rhs ) {
+		assign( std::begin(rhs), std::end(rhs) );
+	}
+
+	// Element Access
+
+	value_type& front() { return values[head]; }
+
+	const value_type& front() const { return values[head]; }
+
+	// Capacity
+
+	bool empty() const noexcept { return head == terminator; }
+
+	// O(1), unlike std::forward_list
+	size_type size() const noexcept { return nexts.size() - free_count; }
+
+	size_type max_size() const noexcept { return std::numeric_limits<index_type>::max() - 1; }
+
+	void reserve( size_type N ) {
+		values.reserve(N);
+		nexts.reserve(N);
+	}
+
+	size_type capacity() const noexcept { return values.capacity(); }
+
+	void shrink_to_fit() {
+		values.shrink_to_fit();
+		nexts.shrink_to_fit();
+	}
+
+	// Modifiers
+
+	void clear() noexcept {
+		values.clear();
+		nexts.clear();
+		head = terminator;
+		free_head = terminator;
+		free_count = 0;
+	}
+
+	iterator insert_after( const_iterator pos, const value_type& x ) {
+		return iterator( this, link_after( pos.index, new_slot( x ) ) );
+	}
+
+	iterator insert_after( const_iterator pos, value_type&& x ) {
+		return iterator( this, link_after( pos.index, new_slot( std::move(x) ) ) );
+	}
+
+	// returns an iterator to the last inserted element, or pos if none
+	iterator insert_after( const_iterator pos, size_type count, const value_type& x ) {
+		index_type index = pos.index;
+		for(size_type i=0;i<count;++i) {
+			index = link_after( index, new_slot( x ) );
+		}
+		return iterator( this, index );
+	}
+
+	template<typename InputIt,typename = is_input_iterator<InputIt>>
+	iterator insert_after( const_iterator pos, InputIt first, InputIt last ) {
+		index_type index = pos.index;
+		for( ; first != last; ++first ) {
+			index = link_after( index, new_slot( *first ) );
+		}
+		return iterator( this, index );
+	}
+
+	iterator insert_after( const_iterator pos, const std::initializer_list<value_type>& rhs ) {
+		return insert_after( pos, std::begin(rhs), std::end(rhs) );
+	}
+
+	template<typename... Ts>
+	iterator emplace_after( const_iterator pos, Ts&&... xs ) {
+		return iterator( this, link_after( pos.index, new_slot( std::forward<Ts>(xs)... ) ) );
+	}
+
+	// erase the element after pos, returning an iterator to the element that followed it.
+	// invalidates iterators to the erased element, and all iterators if the free slots are reclaimed.
+	iterator erase_after( const_iterator pos ) {
+		index_type follow = unlink_after( pos.index );
+		return iterator( this, apply_reclaim( follow ) );
+	}
+
+	// erase the elements in (first,last)
+	iterator erase_after( const_iterator first, const_iterator last ) {
+		while( next_index( first.index ) != last.index ) {
+			unlink_after( first.index );
+		}
+		return iterator( this, apply_reclaim( last.index ) );
+	}
+
+	void push_front( const value_type& x ) {
+		link_after( before_head, new_slot( x ) );
+	}
+
+	void push_front( value_type&& x ) {
+		link_after( before_head, new_slot( std::move(x) ) );
+	}
+
+	template<typename... Ts>
+	void emplace_front( Ts&&... xs ) {
+		link_after( before_head, new_slot( std::forward<Ts>(xs)... ) );
+	}
+
+	void pop_front() {
+		unlink_after( before_head );
+		apply_reclaim( terminator );
+	}
+
+	void resize( size_type N ) {
+		resize_with( N, [this]( index_type index ){ return link_after( index, new_slot() ); } );
+	}
+
+	void resize( size_type N, const value_type& x ) {
+		resize_with( N, [&]( index_type index ){ return link_after( index, new_slot( x ) ); } );
+	}
+
+	void swap( forward_list& rhs ) {
+		values.swap( rhs.values );
+		nexts.swap( rhs.nexts );
+		std::swap( head, rhs.head );
+		std::swap( free_head, rhs.free_head );
+		std::swap( free_count, rhs.free_count );
+	}
+
+	// Iterators
+
+	iterator before_begin() noexcept {
+		return iterator( this, before_head );
+	}
+
+	const_iterator before_begin() const noexcept {
+		return const_iterator( this, before_head );
+	}
+
+	const_iterator cbefore_begin() const noexcept {
+		return before_begin();
+	}
+
+	iterator begin() noexcept {
+		return iterator( this, head );
+	}
+
+	iterator end() noexcept {
+		return iterator( this, terminator );
+	}
+
+	const_iterator begin() const noexcept {
+		return const_iterator( this, head );
+	}
+
+	const_iterator end() const noexcept {
+		return const_iterator( this, terminator );
+	}
+
+	const_iterator cbegin() const noexcept {
+		return begin();
+	}
+
+	const_iterator cend() const noexcept {
+		return end();
+	}
+
+	// Operations
+
+	template<typename Comp>
+	void merge( list_type& rhs, Comp comp ) {
+		if( this == &rhs ) return;
+		merge( std::move(rhs), comp );
+		rhs.clear();
+	}
+
+	template<typename Comp>
+	void merge( list_type&& rhs, Comp comp ) {
+		if( this == &rhs || rhs.empty() ) return;
+		index_type right_head = append_chain( std::move(rhs) );
+		head = ( head == terminator ) ? right_head : merge_chains( head, right_head, comp );
+	}
+
+	void merge( list_type& rhs ) {
+		merge( rhs, std::less<>() );
+	}
+
+	void merge( list_type&& rhs ) {
+		merge( std::move(rhs), std::less<>() );
+	}
+
+	// move the elements of rhs in after pos
+	void splice_after( const_iterator pos, list_type& rhs ) {
+		splice_after( pos, std::move(rhs) );
+		rhs.clear();
+	}
+
+	void splice_after( const_iterator pos, list_type&& rhs ) {
+		if( rhs.empty() ) return;
+		index_type after = next_index( pos.index );
+		index_type first = append_chain( std::move(rhs) );
+		index_type last = index_type( nexts.size() - 1 );
+		nexts[last] = after;
+		set_next( pos.index, first );
+	}
+
+	// move the element after it in rhs to after pos. within the list, the links
+	// are moved instead, and splicing an element after itself or where it already
+	// is does nothing.
+	void splice_after( const_iterator pos, list_type& rhs, const_iterator it ) {
+		if( this == &rhs ) {
+			splice_within( pos, it );
+			return;
+		}
+		splice_after( pos, std::move(rhs), it );
+		rhs.erase_after( it );
+	}
+
+	void splice_after( const_iterator pos, list_type&& rhs, const_iterator it ) {
+		if( this == &rhs ) {
+			splice_within( pos, it );
+			return;
+		}
+		insert_after( pos, std::move( rhs.values[ rhs.next_index( it.index ) ] ) );
+	}
+
+	// move the elements in (first,last) of rhs to after pos, which within the
+	// list must not be in (first,last)
+	void splice_after( const_iterator pos, list_type& rhs, const_iterator first, const_iterator last ) {
+		if( this == &rhs ) {
+			splice_within( pos, first, last );
+			return;
+		}
+		splice_after( pos, std::move(rhs), first, last );
+		rhs.erase_after( first, last );
+	}
+
+	void splice_after( const_iterator pos, list_type&& rhs, const_iterator first, const_iterator last ) {
+		if( this == &rhs ) {
+			splice_within( pos, first, last );
+			return;
+		}
+		index_type index = pos.index;
+		for( index_type i = rhs.next_index( first.index ); i != last.index; i = rhs.nexts[i] ) {
+			index = link_after( index, new_slot( std::move( rhs.values[i] ) ) );
+		}
+	}
+
+	// Remove the matching elements, returning the number removed. O(N).
+	size_type remove( const T& value ) {
+		return remove_if( [&]( const value_type& x ){ return x == value; } );
+	}
+
+	template<typename Pred>
+	size_type remove_if( Pred pred ) {
+		size_type N = 0;
+		index_type prev = before_head;
+		for( index_type i = head; i != terminator; ) {
+			if( pred( values[i] ) ) {
+				i = unlink_after( prev );
+				++N;
+			} else {
+				prev = i;
+				i = nexts[i];
+			}
+		}
+		apply_reclaim( terminator );
+		return N;
+	}
+
+	// reverse the links in one pass
+	void reverse() noexcept {
+		index_type prev = terminator;
+		for( index_type i = head; i != terminator; ) {
+			index_type next = nexts[i];
+			nexts[i] = prev;
+			prev = i;
+			i = next;
+		}
+		head = prev;
+	}
+
+	// Delete consecutive repeated values, keeping the first of each run.
+	// Returns the number erased. O(N).
+	template<typename Comp>
+	size_type unique( Comp comp ) {
+		if( head == terminator ) return 0;
+		size_type N = 0;
+		index_type kept = head;
+		for( index_type i = nexts[head]; i != terminator; ) {
+			if( comp( values[kept], values[i] ) ) {
+				i = unlink_after( kept );
+				++N;
+			} else {
+				kept = i;
+				i = nexts[i];
+			}
+		}
+		apply_reclaim( terminator );
+		return N;
+	}
+
+	size_type unique() {
+		return unique( std::equal_to<>() );
+	}
+
+	// bottom-up merge sort on the next links -- O(N log N) compares, stable, relinks only
+	template<typename Comp>
+	void sort( Comp comp ) {
+		static const size_t max_bins = std::numeric_limits<index_type>::digits + 1;
+		index_type bins[max_bins];
+		size_t num_bins = 0;
+
+		index_type index = head;
+		while( index != terminator ) {
+			index_type next = nexts[index];
+			nexts[index] = terminator;
+
+			// carry the new element up through the occupied bins
+			index_type run = index;
+			size_t k = 0;
+			for( ; k < num_bins && bins[k] != terminator; ++k ) {
+				run = merge_chains( bins[k], run, comp );
+				bins[k] = terminator;
+			}
+			if( k == num_bins ) ++num_bins;
+			bins[k] = run;
+
+			index = next;
+		}
+
+		// lower bins hold later elements
+		index_type run = terminator;
+		for(size_t k=0;k<num_bins;++k) {
+			if( bins[k] == terminator ) continue;
+			run = ( run == terminator ) ? bins[k] : merge_chains( bins[k], run, comp );
+		}
+		head = run;
+	}
+
+	void sort() {
+		sort( std::less<>() );
+	}
+
+	// Compaction
+
+	// move the live slots into the free slots, so the storage is dense. O(N).
+	// Invalidates all iterators.
+	void reclaim() {
+		reclaim_index( terminator );
+	}
+
+	friend iterator;
+	friend const_iterator;
+
+protected:
+
+	// Assignment
+
+	// link the values as a straight chain
+	void set_default_links() {
+		size_type N = values.size();
+		nexts.resize( N );
+		for(size_type i=0;i<N;++i) {
+			nexts[i] = index_type(i + 1);
+		}
+		if( N > 0 ) {
+			nexts[N-1] = terminator;
+		}
+		head = ( N > 0 ) ? index_type(0) : terminator;
+		free_head = terminator;
+		free_count = 0;
+	}
+
+	// Iteration
+
+	index_type next_index( index_type i ) const {
+		return ( i == before_head ) ? head : nexts[i];
+	}
+
+	void set_next( index_type i, index_type next ) {
+		if( i == before_head ) {
+			head = next;
+		} else {
+			nexts[i] = next;
+		}
+	}
+
+	// Modifiers
+
+	// construct a value in a free slot, or at the back of the storage. the slot is unlinked.
+	template<typename... Ts>
+	index_type new_slot( Ts&&... xs ) {
+		if( free_head == terminator ) {
+			index_type N = index_type(nexts.size());
+			if( N >= max_size() ) {
+				throw std::exception("cw::forward_list -- size too big for index_type");
+			}
+			values.emplace_back( std::forward<Ts>(xs)... );
+			nexts.push_back( index_type(terminator) );
+			return N;
+		}
+		index_type index = free_head;
+		values[ index ] = value_type( std::forward<Ts>(xs)... );
+		free_head = nexts[ index ];
+		--free_count;
+		return index;
+	}
+
+	// link the unlinked slot N in after index, returning N
+	index_type link_after( index_type index, index_type N ) {
+		nexts[N] = next_index(index);
+		set_next( index, N );
+		return N;
+	}
+
+	// relink the element after it to after pos
+	void splice_within( const_iterator pos, const_iterator it ) {
+		index_type moved = next_index( it.index );
+		if( pos.index == it.index || pos.index == moved ) return;
+		set_next( it.index, nexts[moved] );
+		link_after( pos.index, moved );
+	}
+
+	// relink the chain in (first,last) to after pos
+	void splice_within( const_iterator pos, const_iterator first, const_iterator last ) {
+		index_type begin = next_index( first.index );
+		if( pos.index == first.index || begin == last.index ) return;
+		index_type end = begin;
+		while( nexts[end] != last.index ) {
+			end = nexts[end];
+		}
+		set_next( first.index, last.index );
+		nexts[end] = next_index( pos.index );
+		set_next( pos.index, begin );
+	}
+
+	// unlink and free the element after index, returning the element that followed it.
+	// an element in the back slot is dropped from the storage instead.
+	index_type unlink_after( index_type index ) {
+		index_type erased = next_index(index);
+		index_type follow = nexts[erased];
+		set_next( index, follow );
+
+		if( erased == index_type(nexts.size() - 1) ) {
+			values.pop_back();
+			nexts.pop_back();
+			return follow;
+		}
+
+		// release any resources held by the erased value
+		static_cast<void>( value_type( std::move( values[erased] ) ) );
+
+		nexts[erased] = free_head;
+		free_head = erased;
+		++free_count;
+		return follow;
+	}
+
+	// reclaim the free slots once they are more than half the storage,
+	// returning the new index of follow
+	index_type apply_reclaim( index_type follow ) {
+		if( 2 * free_count > nexts.size() ) {
+			return reclaim_index( follow );
+		}
+		return follow;
+	}
+
+	// the live slots above the new end of the storage are swapped down into the
+	// free slots below it, in storage order, then every next link is relabelled
+	// through a table of the moved slots. returns the new index of follow.
+	index_type reclaim_index( index_type follow ) {
+		size_type M = nexts.size();
+		size_type N = M - free_count;
+		if( free_count == 0 ) return follow;
+
+		std::vector<bool> vacant( M );
+		for( index_type i = free_head; i != terminator; i = nexts[i] ) {
+			vacant[i] = true;
+		}
+
+		std::vector<index_type> remap( M - N );
+		size_type hole = 0;
+		for( size_type from = N; from < M; ++from ) {
+			if( vacant[from] ) continue;
+			while( !vacant[hole] ) {
+				++hole;
+			}
+			remap[ from - N ] = index_type(hole);
+			values[hole] = std::move( values[from] );
+			nexts[hole] = nexts[from];
+			++hole;
+		}
+
+		auto relabel = [&]( index_type i ){ return ( i < N || i >= M ) ? i : remap[ i - N ]; };
+		for(size_type i=0;i<N;++i) {
+			nexts[i] = relabel( nexts[i] );
+		}
+		head = relabel( head );
+
+		values.erase( std::begin(values) + N, std::end(values) );
+		nexts.resize( N );
+		free_head = terminator;
+		free_count = 0;
+		return relabel( follow );
+	}
+
+	template<typename F>
+	void resize_with( size_type N, F append ) {
+		if( N > max_size() ) {
+			throw std::exception("cw::forward_list::resize() -- size too big for index_type");
+		}
+		// find the last element kept, or the end of the list
+		index_type index = before_head;
+		size_type n = 0;
+		for( ; n < N && next_index(index) != terminator; ++n ) {
+			index = next_index(index);
+		}
+		if( n < N ) {
+			for( ; n < N; ++n ) {
+				index = append( index );
+			}
+		} else {
+			while( next_index(index) != terminator ) {
+				unlink_after( index );
+			}
+			apply_reclaim( terminator );
+		}
+	}
+
+	// move the elements of rhs onto the back of the storage as a straight chain,
+	// returning the index of its first element
+	index_type append_chain( list_type&& rhs ) {
+		size_type offset = nexts.size();
+		size_type sum_size = offset + rhs.size();
+		if( sum_size > max_size() ) {
+			throw std::exception("cw::forward_list -- too big for index_type");
+		}
+		values.reserve( sum_size );
+		nexts.reserve( sum_size );
+		for( index_type i = rhs.head; i != terminator; i = rhs.nexts[i] ) {
+			values.push_back( std::move( rhs.values[i] ) );
+			nexts.push_back( index_type( nexts.size() + 1 ) );
+		}
+		nexts.back() = terminator;
+		return index_type(offset);
+	}
+
+	// merge the chains starting at a and b, return the new first index.
+	// stable -- ties are taken from a. the chains must be non-empty and terminated.
+	template<typename Comp>
+	index_type merge_chains( index_type a, index_type b, Comp comp ) {
+		index_type first;
+		if( comp( values[b], values[a] ) ) {
+			first = b;
+			b = nexts[b];
+		} else {
+			first = a;
+			a = nexts[a];
+		}
+		index_type last = first;
+		while( a != terminator && b != terminator ) {
+			if( comp( values[b], values[a] ) ) {
+				nexts[last] = b;
+				last = b;
+				b = nexts[b];
+			} else {
+				nexts[last] = a;
+				last = a;
+				a = nexts[a];
+			}
+		}
+		nexts[last] = ( a != terminator ) ? a : b;
+		return first;
+	}
+
+};
+
+template<typename T>
+using forward_list8 = forward_list<T,uint8_t>;
+
+template<typename T>
+using forward_list16 = forward_list<T,uint16_t>;
+
+template<typename T>
+using forward_list32 = forward_list<T,uint32_t>;
+
+template<typename T>
+using forward_list64 = forward_list<T,uint64_t>;
+
+// Erasure
+
+template<typename T, typename U, typename A, typename Pred>
+size_t erase_if( cw::forward_list<T,U,A>& c, Pred pred ) {
+	return c.remove_if( pred );
+}
+
+template<typename T, typename U, typename A, typename V>
+size_t erase( cw::forward_list<T,U,A>& c, const V& value ) {
+	return c.remove_if( [&]( const T& x ){ return x == value; } );
+}
+
+// Operators
+
+template<typename T, typename U, typename A>
+bool operator==( const cw::forward_list<T,U,A>& lhs, const cw::forward_list<T,U,A>& rhs ) {
+	if( lhs.size() != rhs.size() ) return false;
+	return std::equal( lhs.begin(), lhs.end(), rhs.begin() );
+}
+
+template<typename T, typename U, typename A>
+bool operator!=( const cw::forward_list<T,U,A>& lhs, const cw::forward_list<T,U,A>& rhs ) {
+	return !(lhs == rhs);
+}
+
+template<typename T, typename U, typename A>
+bool operator<( const cw::forward_list<T,U,A>& lhs, const cw::forward_list<T,U,A>& rhs ) {
+	return std::lexicographical_compare( lhs.begin(), lhs.end(), rhs.begin(), rhs.end() );
+}
+
+template<typename T, typename U, typename A>
+bool operator>( const cw::forward_list<T,U,A>& lhs, const cw::forward_list<T,U,A>& rhs ) {
+	return rhs < lhs;
+}
+
+template<typename T, typename U, typename A>
+bool operator<=( const cw::forward_list<T,U,A>& lhs, const cw::forward_list<T,U,A>& rhs ) {
+	return !(rhs < lhs);
+}
+
+template<typename T, typename U, typename A>
+bool operator>=( const cw::forward_list<T,U,A>& lhs, const cw::forward_list<T,U,A>& rhs ) {
+	return !(lhs < rhs);
+}
+
+}
+
+namespace std {
+
+template<typename T, typename U, typename A>
+void swap( cw::forward_list<T,U,A>& lhs, cw::forward_list<T,U,A>& rhs ) {
+	lhs.swap(rhs);
+}
+
+}
+
+#if _MSC_VER <= 1800
+#undef noexcept
+#endif
+
+#endif
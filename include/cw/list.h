@@ -1,11 +1,24 @@
 #ifndef INCLUDED_CW_LIST
 #define INCLUDED_CW_LIST
 #include <cstdint>
+#include <cstring>
+#include <algorithm>
 #include <vector>
+#include <memory>
 #include <utility>
 #include <exception>
 #include <limits>
 #include <iterator>
+#include <type_traits>
+
+#if __cplusplus >= 201703L || _MSVC_LANG >= 201703L
+#if defined(__has_include)
+#if __has_include(<memory_resource>)
+#include <memory_resource>
+#define CW_LIST_PMR
+#endif
+#endif
+#endif
 
 #if _MSC_VER <= 1800
 #define noexcept throw()
@@ -13,74 +26,141 @@
 
 namespace cw {
 
-template<typename T,typename U>
+// Erase policies
+
+// The erased slot is filled by moving the element stored at the back.
+// The storage stays dense. Erasure invalidates iterators to the moved element.
+struct erase_swap {};
+
+// Erased slots stay in place on a free list, linked through node::next, and are
+// reused by later insertions. Erasure never moves or invalidates other elements.
+// Each slot has a generation, so handles to erased elements can be detected.
+struct erase_stable {};
+
+template<typename T,typename U,typename A,typename E,typename L>
 struct list;
 
-template<typename T,typename U>
+template<typename L>
 struct list_iterator;
 
-template<typename T,typename U>
+template<typename L>
 struct list_const_iterator;
 
+// Packed index types -- an unsigned integer of B bytes with no alignment, so a
+// node of two links takes 2*B bytes. As the index type U of a list, the list
+// computes with the native integer index_traits<U>::type and only the stored
+// links are packed. Loads and stores are unaligned copies of B bytes, in the
+// byte order of the host.
+template<size_t B>
+struct packed_index {
+	using native_type = typename std::conditional<( B <= 4 ),uint32_t,uint64_t>::type;
+
+	static const native_type mask = native_type( ( uint64_t(1) << ( 8 * B ) ) - 1 );
+
+	unsigned char bytes[B];
+
+	packed_index() = default;
+
+	packed_index( native_type x ) noexcept {
+		std::memcpy( bytes, &x, B );
+	}
+
+	packed_index& operator=( native_type x ) noexcept {
+		std::memcpy( bytes, &x, B );
+		return *this;
+	}
+
+	// all-ones reads back as the all-ones of native_type, so the terminator survives the round trip
+	operator native_type() const noexcept {
+		native_type x = 0;
+		std::memcpy( &x, bytes, B );
+		return native_type( ( x + 1 ) & mask ) - 1;
+	}
+};
+
+using uint24_index = packed_index<3>;
+using uint40_index = packed_index<5>;
+using uint48_index = packed_index<6>;
+
+// the integer a list with index type U computes with, and its largest value
+template<typename U>
+struct index_traits {
+	using type = U;
+	static const uint64_t max = std::numeric_limits<U>::max();
+};
+
+template<size_t B>
+struct index_traits<packed_index<B>> {
+	using type = typename packed_index<B>::native_type;
+	static const uint64_t max = packed_index<B>::mask;
+};
+
 template<typename T,typename U>
 struct list_types_base {
 	using value_type             = T;
-	using index_type             = U;
+	using index_type             = typename index_traits<U>::type;
 	using size_type              = size_t;
 	using difference_type        = std::ptrdiff_t;
 };
 
-template<typename T,typename U,bool is_const>
+// iterators are parameterised on the list type L
+
+template<typename L,bool is_const>
 struct list_iterator_types;
 
-template<typename T,typename U>
-struct list_iterator_types<T,U,false> : list_types_base<T,U> {
-	using reference              = T&;
-	using pointer                = T*;
-	using iterator               = list_iterator<T,U>;
+template<typename L>
+struct list_iterator_types<L,false> : list_types_base<typename L::value_type,typename L::index_type> {
+	using reference              = typename L::value_type&;
+	using pointer                = typename L::value_type*;
+	using iterator               = list_iterator<L>;
 	using reverse_iterator       = std::reverse_iterator<iterator>;
 	using iterator_category      = std::bidirectional_iterator_tag;
-	using list_type              = list<T,U>;
+	using list_type              = L;
 };
 
-template<typename T,typename U>
-struct list_iterator_types<T,U,true> : list_types_base<T,U> {
-	using reference              = const T&;
-	using pointer                = const T*;
-	using iterator               = list_const_iterator<T,U>;
+template<typename L>
+struct list_iterator_types<L,true> : list_types_base<typename L::value_type,typename L::index_type> {
+	using reference              = const typename L::value_type&;
+	using pointer                = const typename L::value_type*;
+	using iterator               = list_const_iterator<L>;
 	using reverse_iterator       = std::reverse_iterator<iterator>;
 	using iterator_category      = std::bidirectional_iterator_tag;
-	using list_type              = const list<T,U>;
+	using list_type              = const L;
 };
 
-template<typename T,typename U,bool is_const>
-struct list_iterator_base : list_iterator_types<T,U,is_const> {
-	using base_type = list_iterator_base<T,U,is_const>;
+template<typename L,bool is_const>
+struct list_iterator_base : list_iterator_types<L,is_const> {
+	using base_type = list_iterator_base<L,is_const>;
 
-	using typename list_iterator_types<T,U,is_const>::value_type;
-	using typename list_iterator_types<T,U,is_const>::index_type;
-	using typename list_iterator_types<T,U,is_const>::reference;
-	using typename list_iterator_types<T,U,is_const>::pointer;
-	using typename list_iterator_types<T,U,is_const>::iterator;
-	using typename list_iterator_types<T,U,is_const>::list_type;
+	using typename list_iterator_types<L,is_const>::value_type;
+	using typename list_iterator_types<L,is_const>::index_type;
+	using typename list_iterator_types<L,is_const>::reference;
+	using typename list_iterator_types<L,is_const>::pointer;
+	using typename list_iterator_types<L,is_const>::iterator;
+	using typename list_iterator_types<L,is_const>::list_type;
 
 	list_iterator_base() = default;
 
 	list_iterator_base( list_type* p, index_type index ) : p(p), index(index) {}
 
 	reference operator*() const {
-		return p->values[index];
+		return p->slot_value(index);
 	}
 
 	pointer operator->() const {
-		return &p->values[index];
+		return &p->slot_value(index);
 	}
 
+	// while the list is linear the neighbours are adjacent in storage,
+	// so the step doesn't wait on a load of the node
+
 	base_type& operator++() {
 		if( index == p->terminator ) {
 			index = p->head;
+		} else if( p->linear() ) {
+			index = ( index == p->tail ) ? p->terminator : index_type(index + 1);
 		} else {
-			index = p->nodes[index].next;
+			index = p->next_link(index);
 		}
 		return *this;
 	}
@@ -88,8 +168,10 @@ struct list_iterator_base : list_iterator_types<T,U,is_const> {
 	base_type& operator--() {
 		if( index == p->terminator ) {
 			index = p->tail;
+		} else if( p->linear() ) {
+			index = ( index == p->head ) ? p->terminator : index_type(index - 1);
 		} else {
-			index = p->nodes[index].prev;
+			index = p->prev_link(index);
 		}
 		return *this;
 	}
@@ -114,14 +196,14 @@ struct list_iterator_base : list_iterator_types<T,U,is_const> {
 		return !( *this == rhs );
 	}
 
-	friend list<value_type,index_type>;
+	friend L;
 
 	list_type* p;
 	index_type index;
 };
 
-template<typename T,typename U>
-struct list_const_iterator : list_iterator_base<T,U,true> {
+template<typename L>
+struct list_const_iterator : list_iterator_base<L,true> {
 
 	using base_type::list_iterator_base;
 
@@ -129,13 +211,13 @@ struct list_const_iterator : list_iterator_base<T,U,true> {
 
 	list_const_iterator( const base_type& it ) : list_iterator_base(it) {}
 
-	list_const_iterator( const list_iterator<T,U>& it ) : list_iterator_base(it.p,it.index) {}
+	list_const_iterator( const list_iterator<L>& it ) : list_iterator_base(it.p,it.index) {}
 
-	friend list_iterator<T,U>;
+	friend list_iterator<L>;
 };
 
-template<typename T,typename U>
-struct list_iterator : list_iterator_base<T,U,false> {
+template<typename L>
+struct list_iterator : list_iterator_base<L,false> {
 
 	using base_type::list_iterator_base;
 
@@ -143,7 +225,7 @@ struct list_iterator : list_iterator_base<T,U,false> {
 
 	list_iterator( const base_type& it ) : list_iterator_base(it) {}
 
-	explicit list_iterator( const list_const_iterator<T,U>& it ) : list_iterator_base( const_cast<list_type*>(it.p), it.index ) {}
+	explicit list_iterator( const list_const_iterator<L>& it ) : list_iterator_base( const_cast<list_type*>(it.p), it.index ) {}
 
 	void iter_swap( iterator& rhs ) {
 		if( p != rhs.p )
@@ -152,679 +234,1896 @@ struct list_iterator : list_iterator_base<T,U,false> {
 		std::swap( index, rhs.index );
 	}
 
-	friend list_const_iterator<T,U>;
+	friend list_const_iterator<L>;
 };
 
-template<typename T,typename U = uint32_t>
-struct list : list_types_base<T,U> {
-	using reference              = T&;
-	using const_reference        = const T&;
-	using pointer                = T*;
-	using const_pointer          = const T*;
-	using iterator               = list_iterator<T,U>;
-	using const_iterator         = list_const_iterator<T,U>;
-	using reverse_iterator       = std::reverse_iterator<iterator>;
-	using const_reverse_iterator = std::reverse_iterator<const_iterator>;
-	using list_type              = list<T,U>;
+// handle to an element of a list using the erase_stable policy.
+// a handle outlives its element -- it is simply no longer valid.
+template<typename U>
+struct list_handle {
+	using index_type      = U;
+	using generation_type = uint32_t;
 
-	struct node {
-		index_type prev, next;
-	};
+	index_type index;
+	generation_type generation;
+};
 
-	static const index_type terminator = index_type(-1); //std::numeric_limits<index_type>::max();
+// free slot bookkeeping for erase policy E
 
-	std::vector<value_type> values;
-	std::vector<node> nodes;
-	
-	index_type head = terminator,
-	           tail = terminator;
-	
-	list() = default;
+template<typename U,typename A,typename E>
+struct list_slots {
+	list_slots() = default;
 
-	list( const std::initializer_list<value_type>& rhs ) {
-		assign( rhs );
-	}
+	explicit list_slots( const A& ) {}
 
-	explicit list( const std::vector<value_type>& rhs ) {
-		assign( rhs );
-	}
+	list_slots( const list_slots&, const A& ) {}
 
-	explicit list( std::vector<value_type>&& rhs ) {
-		assign( std::move( rhs ) );
-	}
-	
-	explicit list( size_type N ) {
-		resize(N);
-	}
+	size_t num_free() const noexcept { return 0; }
 
-	// Assignment
+	bool is_free( U ) const noexcept { return false; }
 
-	list_type& operator=( const std::vector<value_type>& rhs ) {
-		size_type N = rhs.size();
-		if( N > max_size() ) {
-			throw std::exception("cw::list assignment -- vector too big for index_type");
-		}
-		values = rhs;
-		set_default_nodes( N );
-		return *this;
-	}
+	void swap( list_slots& ) noexcept {}
+};
 
-	list_type& operator=( std::vector<value_type>&& rhs ) {
-		size_type N = rhs.size();
-		if( N > max_size() ) {
-			throw std::exception("cw::list assignment -- vector too big for index_type");
-		}
-		values = std::move(rhs);
-		set_default_nodes( N );
-		return *this;
-	}
+template<typename U,typename A>
+struct list_slots<U,A,erase_stable> {
+	using generation_type        = typename list_handle<U>::generation_type;
+	using generation_allocator   = typename std::allocator_traits<A>::template rebind_alloc<generation_type>;
 
-	list_type& operator=( const std::initializer_list<value_type>& rhs ) {
-		size_type N = rhs.size();
-		if( N > max_size() ) {
-			throw std::exception("cw::list assignment -- initializer_list too big for index_type");
-		}
-		values = rhs;
-		set_default_nodes( N );
-		return *this;
-	}
+	U free_head = U(-1);
+	size_t free_count = 0;
 
-	void assign( size_type count, const T& value ) {
-		values.assign( count, value );
-		set_default_nodes( count );
-	}
+	// odd while the slot is free
+	std::vector<generation_type,generation_allocator> generations;
 
-	template<typename InputIt>
-	void assign( InputIt first, InputIt last ) {
-		values.assign( first, last );
-		set_default_nodes( std::distance(first,last) );
-	}
+	list_slots() = default;
 
-	void assign( const std::initializer_list<T>& rhs ) {
-		values.assign( rhs );
-		set_default_nodes( rhs.size() );
-	}
+	explicit list_slots( const A& alloc ) : generations( generation_allocator(alloc) ) {}
 
-	// Element Access
+	list_slots( const list_slots& rhs, const A& alloc ) :
+		free_head( rhs.free_head ),
+		free_count( rhs.free_count ),
+		generations( rhs.generations, generation_allocator(alloc) )
+	{}
+
+	size_t num_free() const noexcept { return free_count; }
 
-	value_type& front() { return values[head]; }
+	bool is_free( U index ) const noexcept { return ( generations[index] & 1 ) != 0; }
 
-	value_type& back() { return values[tail]; }
+	void swap( list_slots& rhs ) noexcept {
+		std::swap( free_head, rhs.free_head );
+		std::swap( free_count, rhs.free_count );
+		generations.swap( rhs.generations );
+	}
+};
 
-	value_type* data() noexcept { return values.data(); }
+// Storage layouts -- how the values and the links of the slots are laid out
 
-	const value_type* data() const noexcept { return values.data(); }
+// values and nodes {prev,next} in two vectors. the values are contiguous, so
+// data() and the algorithms of list_algorithm.h run over them directly.
+struct layout_soa {};
 
-	// Capacity
+// one vector of records {prev,next,value}, so a step through the list and the
+// value it reaches share a cache line. suits large values visited in list order.
+struct layout_aos {};
 
-	bool empty() const noexcept { return size() == 0; }
+// values, prev links and next links in three vectors, so a forward traversal
+// reads only the next links and reverse() is O(1).
+struct layout_split {};
 
-	size_type size() const noexcept { return nodes.size(); }
-	
-	size_type max_size() const noexcept { return std::numeric_limits<index_type>::max(); }
-	
-	void reserve( size_type N ) {
+template<typename U>
+struct list_node {
+	U prev, next;
+};
+
+// the slots of a list under layout policy L. every layout provides the same
+// accessors and bulk operations; links are left unset by the operations that
+// add slots, for the list to link.
+template<typename T,typename U,typename A,typename L>
+struct list_storage;
+
+template<typename T,typename U,typename A>
+struct list_storage<T,U,A,layout_soa> {
+	using node                   = list_node<U>;
+	using value_allocator_type   = typename std::allocator_traits<A>::template rebind_alloc<T>;
+	using node_allocator_type    = typename std::allocator_traits<A>::template rebind_alloc<node>;
+	using values_type            = std::vector<T,value_allocator_type>;
+	using nodes_type             = std::vector<node,node_allocator_type>;
+	using link_type              = U;
+	using I                      = typename index_traits<U>::type;
+
+	static const bool contiguous = true;
+
+	values_type values;
+	nodes_type nodes;
+
+	list_storage() = default;
+
+	explicit list_storage( const A& alloc ) :
+		values( value_allocator_type(alloc) ),
+		nodes( node_allocator_type(alloc) )
+	{}
+
+	list_storage( const list_storage& rhs, const A& alloc ) :
+		values( rhs.values, value_allocator_type(alloc) ),
+		nodes( rhs.nodes, node_allocator_type(alloc) )
+	{}
+
+	T& slot_value( I i ) noexcept { return values[i]; }
+	const T& slot_value( I i ) const noexcept { return values[i]; }
+	U& prev_link( I i ) noexcept { return nodes[i].prev; }
+	I prev_link( I i ) const noexcept { return nodes[i].prev; }
+	U& next_link( I i ) noexcept { return nodes[i].next; }
+	I next_link( I i ) const noexcept { return nodes[i].next; }
+	void set_links( I i, I prev, I next ) noexcept { nodes[i] = { U(prev), U(next) }; }
+
+	size_t slots() const noexcept { return nodes.size(); }
+	size_t slot_capacity() const noexcept { return values.capacity(); }
+	A slot_allocator() const { return A( values.get_allocator() ); }
+
+	T* data() noexcept { return values.data(); }
+	const T* data() const noexcept { return values.data(); }
+
+	void reserve_slots( size_t N ) {
 		values.reserve(N);
 		nodes.reserve(N);
 	}
 
-	size_type capacity() const noexcept { return values.capacity(); }
-
-	void shrink_to_fit() {
+	void shrink_slots() {
 		values.shrink_to_fit();
 		nodes.shrink_to_fit();
 	}
 
-	// Modifiers
-
-	void clear() noexcept {
+	void clear_slots() noexcept {
 		values.clear();
 		nodes.clear();
-		head = tail = terminator;
-	}
-
-	iterator insert( const_iterator pos, const value_type& x ) {
-		values.push_back(x);
-		return insert_index_node( pos.index );
 	}
 
-	iterator insert( const_iterator pos, value_type&& x ) {
-		values.push_back( std::move(x) );
-		return insert_index_node( pos.index );
+	void swap( list_storage& rhs ) noexcept {
+		values.swap( rhs.values );
+		nodes.swap( rhs.nodes );
 	}
 
 	template<typename... Ts>
-	iterator emplace( const_iterator pos, Ts&&... xs ) {
+	void emplace_slot( Ts&&... xs ) {
 		values.emplace_back( std::forward<Ts>(xs)... );
-		insert_index_node( pos.index );
+		nodes.emplace_back();
 	}
 
-	iterator erase( const_iterator pos ) {
-		return erase_index(pos.index);
-	}
-
-	iterator erase( const_iterator first, const_iterator last ) {
-		while( first != last ) {
-			first = erase_index( first.index );
-		}
-		return iterator(first);
+	void pop_slot() {
+		values.pop_back();
+		nodes.pop_back();
 	}
 
-	void push_front( const value_type& x ) {
-		values.push_back(x);
-		push_front_node();
+	// drop the slots from N onwards
+	void truncate_slots( size_t N ) {
+		values.erase( std::begin(values) + N, std::end(values) );
+		nodes.resize( N );
 	}
 
-	void push_back( const value_type& x ) {
-		values.push_back(x);
-		push_back_node();
+	// add slots at the back, up to N
+	void grow_slots( size_t N ) {
+		values.resize( N );
+		nodes.resize( N );
 	}
 
-	void push_front( value_type&& x ) {
-		values.push_back( std::move(x) );
-		push_front_node();
+	void grow_slots( size_t N, const T& x ) {
+		values.resize( N, x );
+		nodes.resize( N );
 	}
 
-	void push_back( value_type&& x ) {
-		values.push_back( std::move(x) );
-		push_back_node();
+	template<typename InputIt>
+	void append_slots( InputIt first, InputIt last ) {
+		values.insert( std::end(values), first, last );
+		nodes.resize( values.size() );
 	}
 
-	template<typename... Ts>
-	void emplace_front( Ts&&... xs ) {
-		values.emplace_back( std::forward<Ts>(xs)... );
-		size_type num_values = values.size();
-		size_type num_nodes = nodes.size();
-		while( num_nodes++ < num_values ) {
-			push_front_node();
-		}
+	void append_slots( size_t count, const T& x ) {
+		values.insert( std::end(values), count, x );
+		nodes.resize( values.size() );
 	}
 
-	template<typename... Ts>
-	void emplace_back( Ts&&... xs ) {
-		values.emplace_back( std::forward<Ts>(xs)... );
-		size_type num_values = values.size();
-		size_type num_nodes = nodes.size();
-		while( num_nodes++ < num_values ) {
-			push_back_node();
-		}
+	// replace every slot
+	template<typename V>
+	void assign_slots( V&& rhs ) {
+		values = std::forward<V>(rhs);
+		nodes.resize( values.size() );
 	}
 
-	void pop_front() {
-		erase_index(head);
+	void assign_slots( size_t count, const T& x ) {
+		values.assign( count, x );
+		nodes.resize( count );
 	}
 
-	void pop_back() {
-		erase_index(tail);
+	template<typename InputIt>
+	void assign_slots( InputIt first, InputIt last ) {
+		values.assign( first, last );
+		nodes.resize( values.size() );
 	}
 
-	void resize( size_type N ) {
-		if( N > max_size() ) {
-			throw std::exception("cw::list::resize() -- size too big for index_type");
-		}
-		size_type current_size = size();
-		if( N > current_size ) {
-			values.resize( N );
-			nodes.resize( N );
-			resize_nodes( N );
-		} else {
-			while( current_size > N ) {
-				pop_back();
-				--current_size;
-			}
+	// replace the slots with the values of the slots index(*it) for it in [first,last), in that order
+	template<typename It,typename Index>
+	void gather_slots( It first, It last, Index index ) {
+		values_type ordered( values.get_allocator() );
+		ordered.reserve( values.capacity() );
+		for( ; first != last; ++first ) {
+			ordered.push_back( std::move( values[ index( *first ) ] ) );
 		}
+		values.swap( ordered );
+		nodes.resize( values.size() );
 	}
 
-	void resize( size_type N, const value_type& x ) {
-		if( N > max_size() ) {
-			throw std::exception("cw::list::resize() -- size too big for index_type");
-		}
-		size_type current_size = size();
-		if( N > current_size ) {
-			values.resize( N, x );
-			nodes.resize( N );
-			resize_nodes( N );
-		} else {
-			while( current_size > N ) {
-				pop_back();
-				--current_size;
-			}
+	// exchange the prev and next links of every slot
+	void reverse_links() noexcept {
+		for( auto&& n : nodes ) {
+			std::swap( n.prev, n.next );
 		}
 	}
+};
 
-	void swap( list& rhs ) {
-		values.swap( rhs );
-		nodes.swap( rhs );
-		std::swap( head, rhs.head );
-		std::swap( tail, rhs.tail );
-	}
+template<typename T,typename U,typename A>
+struct list_storage<T,U,A,layout_aos> {
+	struct record {
+		U prev, next;
+		T value;
 
-	// Iterators
+		struct value_tag {};
 
-	iterator begin() noexcept {
-		return iterator( this, head );
-	}
+		record() : prev(), next(), value() {}
 
-	iterator end() noexcept {
-		return iterator( this, terminator );
-	}
+		template<typename... Ts>
+		record( value_tag, Ts&&... xs ) : prev(), next(), value( std::forward<Ts>(xs)... ) {}
+	};
 
-	const_iterator begin() const noexcept {
-		return const_iterator( this, head );
-	}
+	using value_allocator_type   = typename std::allocator_traits<A>::template rebind_alloc<T>;
+	using record_allocator_type  = typename std::allocator_traits<A>::template rebind_alloc<record>;
+	using values_type            = std::vector<T,value_allocator_type>;
+	using records_type           = std::vector<record,record_allocator_type>;
+	using value_tag              = typename record::value_tag;
+	using link_type              = U;
+	using I                      = typename index_traits<U>::type;
 
-	const_iterator end() const noexcept {
-		return const_iterator( this, terminator );
-	}
+	static const bool contiguous = false;
 
-	const_iterator cbegin() const noexcept {
-		return begin();
-	}
+	records_type records;
 
-	const_iterator cend() const noexcept {
-		return end();
-	}
+	list_storage() = default;
 
-	iterator rbegin() noexcept {
-		return reverse_iterator( end() );
-	}
+	explicit list_storage( const A& alloc ) : records( record_allocator_type(alloc) ) {}
 
-	iterator rend() noexcept {
-		return reverse_iterator( begin() );
-	}
+	list_storage( const list_storage& rhs, const A& alloc ) : records( rhs.records, record_allocator_type(alloc) ) {}
 
-	const_iterator rbegin() const noexcept {
-		return const_reverse_iterator( end() );
-	}
+	T& slot_value( I i ) noexcept { return records[i].value; }
+	const T& slot_value( I i ) const noexcept { return records[i].value; }
+	U& prev_link( I i ) noexcept { return records[i].prev; }
+	I prev_link( I i ) const noexcept { return records[i].prev; }
+	U& next_link( I i ) noexcept { return records[i].next; }
+	I next_link( I i ) const noexcept { return records[i].next; }
 
-	const_iterator rend() const noexcept {
-		return const_reverse_iterator( begin() );
+	void set_links( I i, I prev, I next ) noexcept {
+		records[i].prev = prev;
+		records[i].next = next;
 	}
 
-	const_iterator crbegin() const noexcept {
-		return rbegin();
-	}
+	size_t slots() const noexcept { return records.size(); }
+	size_t slot_capacity() const noexcept { return records.capacity(); }
+	A slot_allocator() const { return A( records.get_allocator() ); }
 
-	const_iterator crend() const noexcept {
-		return rend();
-	}
+	void reserve_slots( size_t N ) { records.reserve(N); }
 
-	// Operations
+	void shrink_slots() { records.shrink_to_fit(); }
 
-	template<typename Comp>
-	void merge( list_type& rhs, Comp comp ) {		
-		merge( std::move(rhs), comp );
+	void clear_slots() noexcept { records.clear(); }
 
-		// rhs is now empty
-		rhs.clear();
+	void swap( list_storage& rhs ) noexcept { records.swap( rhs.records ); }
+
+	template<typename... Ts>
+	void emplace_slot( Ts&&... xs ) {
+		records.emplace_back( value_tag(), std::forward<Ts>(xs)... );
 	}
 
-	template<typename Comp>
-	void merge( list_type&& rhs, Comp comp ) {
-		size_type left_size = size();
-		size_type right_size = rhs.size();
-		size_type sum_size = left_size + right_size;
-		if( sum_size > max_size() ) {
-			throw std::exception("cw::list merge -- too big for index_type");
-		}
+	void pop_slot() { records.pop_back(); }
+
+	void truncate_slots( size_t N ) {
+		records.erase( std::begin(records) + N, std::end(records) );
+	}
 
-		values.reserve( sum_size );
-		std::move( std::begin(rhs.values), std::end(rhs.values), std::back_inserter(values) );
+	void grow_slots( size_t N ) { records.resize( N ); }
 
-		nodes.reserve( sum_size );
-		std::move( std::begin(rhs.nodes), std::end(rhs.nodes), std::back_inserter(nodes) );
+	void grow_slots( size_t N, const T& x ) { records.resize( N, record( value_tag(), x ) ); }
 
-		// offset the new indexes
-		for(size_type i=left_size;i<sum_size;++i) {
-			nodes[ i ].prev += index_type(left_size);
-			nodes[ i ].next += index_type(left_size);
+	template<typename InputIt>
+	void append_slots( InputIt first, InputIt last ) {
+		for( ; first != last; ++first ) {
+			records.emplace_back( value_tag(), *first );
 		}
+	}
 
-		// connect the head
-		index_type right_head = rhs.head + index_type(left_size);
-		nodes[ tail ].next = right_head;
-		nodes[ right_head ].prev = tail;
+	void append_slots( size_t count, const T& x ) {
+		records.resize( records.size() + count, record( value_tag(), x ) );
+	}
 
-		// connect the tail
-		index_type right_tail = rhs.tail + index_type(left_size);
-		tail = right_tail;
-		nodes[ right_tail ].next = terminator;
+	void assign_slots( const values_type& rhs ) {
+		assign_slots( std::begin(rhs), std::end(rhs) );
+	}
 
-		// merge the two parts
-		merge_index( head, right_head, tail, comp );
+	void assign_slots( values_type&& rhs ) {
+		assign_slots( std::make_move_iterator( std::begin(rhs) ), std::make_move_iterator( std::end(rhs) ) );
 	}
 
-	void merge( list_type& rhs ) {
-		merge( rhs, less<>() );
+	void assign_slots( const std::initializer_list<T>& rhs ) {
+		assign_slots( std::begin(rhs), std::end(rhs) );
 	}
 
-	void merge( list_type&& rhs ) {
-		merge( std::move(rhs), less<>() );
+	void assign_slots( size_t count, const T& x ) {
+		records.assign( count, record( value_tag(), x ) );
 	}
 
-	void remove( const T& value ) {
-		index_type N = index_type(values.size());
-		for(index_type i=0;i<N;++i) {
-			if( values[i] == value ) {
-				erase_index(i);
-				--i; --N;
-			}
-		}
+	template<typename InputIt>
+	void assign_slots( InputIt first, InputIt last ) {
+		records.clear();
+		append_slots( first, last );
 	}
 
-	template<typename Pred>
-	void remove_if( Pred pred ) {
-		index_type N = index_type(values.size());
-		for(index_type i=0;i<N;++i) {
-			if( pred(values[i]) ) {
-				erase_index(i);
-				--i; --N;
-			}
+	template<typename It,typename Index>
+	void gather_slots( It first, It last, Index index ) {
+		records_type ordered( records.get_allocator() );
+		ordered.reserve( records.capacity() );
+		for( ; first != last; ++first ) {
+			ordered.emplace_back( value_tag(), std::move( records[ index( *first ) ].value ) );
 		}
+		records.swap( ordered );
 	}
 
-	void reverse() noexcept {
-		for( auto&& node : nodes ) {
-			std::swap( node.prev, node.next );
+	void reverse_links() noexcept {
+		for( auto&& r : records ) {
+			std::swap( r.prev, r.next );
 		}
-		std::swap( head, tail );
 	}
+};
 
-	void splice( const_iterator pos, list_type& rhs ) {
-		splice( pos, std::move(rhs) );
-		rhs.clear();
-	}
+template<typename T,typename U,typename A>
+struct list_storage<T,U,A,layout_split> {
+	using value_allocator_type   = typename std::allocator_traits<A>::template rebind_alloc<T>;
+	using link_allocator_type    = typename std::allocator_traits<A>::template rebind_alloc<U>;
+	using values_type            = std::vector<T,value_allocator_type>;
+	using links_type             = std::vector<U,link_allocator_type>;
+	using link_type              = U;
+	using I                      = typename index_traits<U>::type;
 
-	void splice( const_iterator pos, list_type&& rhs ) {
-		size_type left_size = size();
-		size_type right_size = rhs.size();
-		size_type sum_size = left_size + right_size;
-		if( sum_size > max_size() ) {
-			throw std::exception("cw::list splice -- too big for index_type");
-		}
+	static const bool contiguous = true;
 
-		values.reserve( sum_size );
-		std::move( std::begin(rhs.values), std::end(rhs.values), std::back_inserter(values) );
+	values_type values;
+	links_type prevs;
+	links_type nexts;
 
-		nodes.reserve( sum_size );
-		std::move( std::begin(rhs.nodes), std::end(rhs.nodes), std::back_inserter(nodes) );
+	list_storage() = default;
 
-		index_type right_head = rhs.head + index_type(left_size);
-		index_type right_tail = rhs.tail + index_type(left_size);
+	explicit list_storage( const A& alloc ) :
+		values( value_allocator_type(alloc) ),
+		prevs( link_allocator_type(alloc) ),
+		nexts( link_allocator_type(alloc) )
+	{}
 
-		splice_index( pos.index, index_type(left_size), index_type(sum_size), right_head, right_tail );
-	}
+	list_storage( const list_storage& rhs, const A& alloc ) :
+		values( rhs.values, value_allocator_type(alloc) ),
+		prevs( rhs.prevs, link_allocator_type(alloc) ),
+		nexts( rhs.nexts, link_allocator_type(alloc) )
+	{}
 
-	void splice( const_iterator pos, list_type& rhs, const_iterator it ) {
-		splice( pos, std::move(rhs), it );
-		rhs.erase( it );
+	T& slot_value( I i ) noexcept { return values[i]; }
+	const T& slot_value( I i ) const noexcept { return values[i]; }
+	U& prev_link( I i ) noexcept { return prevs[i]; }
+	I prev_link( I i ) const noexcept { return prevs[i]; }
+	U& next_link( I i ) noexcept { return nexts[i]; }
+	I next_link( I i ) const noexcept { return nexts[i]; }
+
+	void set_links( I i, I prev, I next ) noexcept {
+		prevs[i] = prev;
+		nexts[i] = next;
 	}
 
-	void splice( const_iterator pos, list_type&& rhs, const_iterator it ) {
-		size_type left_size = size();
-		if( left_size + 1 > max_size() ) {
-			throw std::exception("cw::list splice -- too big for index_type");
-		}
+	size_t slots() const noexcept { return nexts.size(); }
+	size_t slot_capacity() const noexcept { return values.capacity(); }
+	A slot_allocator() const { return A( values.get_allocator() ); }
 
-		values.emplace_back( std::move(*it) );
-		
-		index_type prev_index = prev_index(pos.index);
-		nodes.push_back( { prev_index, pos.index } );
+	T* data() noexcept { return values.data(); }
+	const T* data() const noexcept { return values.data(); }
 
-		if( prev_pos == terminator ) {
-			head = left_size;
+	void reserve_slots( size_t N ) {
+		values.reserve(N);
+		prevs.reserve(N);
+		nexts.reserve(N);
+	}
+
+	void shrink_slots() {
+		values.shrink_to_fit();
+		prevs.shrink_to_fit();
+		nexts.shrink_to_fit();
+	}
+
+	void clear_slots() noexcept {
+		values.clear();
+		prevs.clear();
+		nexts.clear();
+	}
+
+	void swap( list_storage& rhs ) noexcept {
+		values.swap( rhs.values );
+		prevs.swap( rhs.prevs );
+		nexts.swap( rhs.nexts );
+	}
+
+	template<typename... Ts>
+	void emplace_slot( Ts&&... xs ) {
+		values.emplace_back( std::forward<Ts>(xs)... );
+		prevs.emplace_back();
+		nexts.emplace_back();
+	}
+
+	void pop_slot() {
+		values.pop_back();
+		prevs.pop_back();
+		nexts.pop_back();
+	}
+
+	void truncate_slots( size_t N ) {
+		values.erase( std::begin(values) + N, std::end(values) );
+		resize_links( N );
+	}
+
+	void grow_slots( size_t N ) {
+		values.resize( N );
+		resize_links( N );
+	}
+
+	void grow_slots( size_t N, const T& x ) {
+		values.resize( N, x );
+		resize_links( N );
+	}
+
+	template<typename InputIt>
+	void append_slots( InputIt first, InputIt last ) {
+		values.insert( std::end(values), first, last );
+		resize_links( values.size() );
+	}
+
+	void append_slots( size_t count, const T& x ) {
+		values.insert( std::end(values), count, x );
+		resize_links( values.size() );
+	}
+
+	template<typename V>
+	void assign_slots( V&& rhs ) {
+		values = std::forward<V>(rhs);
+		resize_links( values.size() );
+	}
+
+	void assign_slots( size_t count, const T& x ) {
+		values.assign( count, x );
+		resize_links( count );
+	}
+
+	template<typename InputIt>
+	void assign_slots( InputIt first, InputIt last ) {
+		values.assign( first, last );
+		resize_links( values.size() );
+	}
+
+	template<typename It,typename Index>
+	void gather_slots( It first, It last, Index index ) {
+		values_type ordered( values.get_allocator() );
+		ordered.reserve( values.capacity() );
+		for( ; first != last; ++first ) {
+			ordered.push_back( std::move( values[ index( *first ) ] ) );
+		}
+		values.swap( ordered );
+		resize_links( values.size() );
+	}
+
+	void reverse_links() noexcept {
+		prevs.swap( nexts );
+	}
+
+private:
+
+	void resize_links( size_t N ) {
+		prevs.resize( N );
+		nexts.resize( N );
+	}
+};
+
+// order-statistic index over the link order of a list -- a treap keyed by
+// position, stored by slot index alongside the nodes. rank and select are
+// O(log N) expected, as are insertion and erasure of a single slot.
+template<typename U,typename A>
+struct list_ranks {
+	static const U nil = U(-1);
+
+	struct node {
+		U parent, left, right;
+		U size;
+		uint32_t priority;
+	};
+
+	using node_allocator_type = typename std::allocator_traits<A>::template rebind_alloc<node>;
+
+	std::vector<node,node_allocator_type> tree;
+	U root = nil;
+	bool enabled = false;
+	uint32_t seed = 0x9e3779b9u;
+
+	list_ranks() = default;
+
+	explicit list_ranks( const A& alloc ) : tree( node_allocator_type(alloc) ) {}
+
+	list_ranks( const list_ranks& rhs, const A& alloc ) :
+		tree( rhs.tree, node_allocator_type(alloc) ),
+		root( rhs.root ),
+		enabled( rhs.enabled ),
+		seed( rhs.seed )
+	{}
+
+	void clear() noexcept {
+		tree.clear();
+		root = nil;
+	}
+
+	void swap( list_ranks& rhs ) noexcept {
+		tree.swap( rhs.tree );
+		std::swap( root, rhs.root );
+		std::swap( enabled, rhs.enabled );
+		std::swap( seed, rhs.seed );
+	}
+
+	U size_of( U x ) const noexcept {
+		return ( x == nil ) ? U(0) : tree[x].size;
+	}
+
+	// position of slot x in the list
+	U rank( U x ) const noexcept {
+		U r = size_of( tree[x].left );
+		for( U p = tree[x].parent; p != nil; x = p, p = tree[p].parent ) {
+			if( tree[p].right == x ) {
+				r += size_of( tree[p].left ) + 1;
+			}
+		}
+		return r;
+	}
+
+	// slot at position k, which must be less than the size of the list
+	U select( U k ) const noexcept {
+		U x = root;
+		for(;;) {
+			U left_size = size_of( tree[x].left );
+			if( k < left_size ) {
+				x = tree[x].left;
+			} else if( k == left_size ) {
+				return x;
+			} else {
+				k -= left_size + 1;
+				x = tree[x].right;
+			}
+		}
+	}
+
+	// rebuild from the chain of list l. O(N) -- a Cartesian tree is built along
+	// the right spine.
+	template<typename L>
+	void rebuild( const L& l ) {
+		tree.resize( l.slots() );
+		std::vector<U> spine;
+		for( U i = l.head; i != nil; i = l.next_link(i) ) {
+			tree[i] = { nil, nil, nil, 1, random() };
+			U last = nil;
+			while( !spine.empty() && tree[ spine.back() ].priority < tree[i].priority ) {
+				last = pop_spine( spine );
+			}
+			tree[i].left = last;
+			if( last != nil ) {
+				tree[last].parent = i;
+			}
+			if( !spine.empty() ) {
+				tree[ spine.back() ].right = i;
+				tree[i].parent = spine.back();
+			}
+			spine.push_back(i);
+		}
+		root = spine.empty() ? nil : spine.front();
+		while( !spine.empty() ) {
+			pop_spine( spine );
+		}
+	}
+
+	// add slot x in front of slot before, or at the back if before is nil
+	void insert( U x, U before ) {
+		if( tree.size() <= x ) {
+			tree.resize( size_t(x) + 1 );
+		}
+		tree[x] = { nil, nil, nil, 1, random() };
+		if( root == nil ) {
+			root = x;
+			return;
+		}
+
+		// attach as a leaf -- the rightmost of everything in front of before
+		U p;
+		if( before == nil ) {
+			p = rightmost( root );
+			tree[p].right = x;
+		} else if( tree[before].left == nil ) {
+			p = before;
+			tree[p].left = x;
+		} else {
+			p = rightmost( tree[before].left );
+			tree[p].right = x;
+		}
+		tree[x].parent = p;
+		for( ; p != nil; p = tree[p].parent ) {
+			++tree[p].size;
+		}
+
+		while( tree[x].parent != nil && tree[ tree[x].parent ].priority < tree[x].priority ) {
+			rotate_up(x);
+		}
+	}
+
+	void erase( U x ) {
+		// rotate x down to a leaf
+		for(;;) {
+			U l = tree[x].left;
+			U r = tree[x].right;
+			if( l == nil && r == nil ) break;
+			if( r == nil || ( l != nil && tree[r].priority < tree[l].priority ) ) {
+				rotate_up(l);
+			} else {
+				rotate_up(r);
+			}
+		}
+		U p = tree[x].parent;
+		if( p == nil ) {
+			root = nil;
+		} else if( tree[p].left == x ) {
+			tree[p].left = nil;
+		} else {
+			tree[p].right = nil;
+		}
+		for( ; p != nil; p = tree[p].parent ) {
+			--tree[p].size;
+		}
+	}
+
+	// the element in slot from is now stored in the unused slot to
+	void move( U from, U to ) {
+		tree[to] = tree[from];
+		const node& n = tree[to];
+		for( U y : { n.parent, n.left, n.right } ) {
+			if( y != nil ) relabel( y, from, to );
+		}
+		if( root == from ) {
+			root = to;
+		}
+	}
+
+	// the elements in slots a and b have exchanged positions, or exchanged slots
+	void swap_slots( U a, U b ) {
+		if( a == b ) return;
+		std::swap( tree[a], tree[b] );
+		relabel( a, a, b );
+		relabel( b, a, b );
+		relabel_neighbours( a, a, b );
+		relabel_neighbours( b, a, b );
+	}
+
+	// mirror the order of the list
+	void reverse() noexcept {
+		for( auto&& n : tree ) {
+			std::swap( n.left, n.right );
+		}
+	}
+
+private:
+
+	uint32_t random() noexcept {
+		seed ^= seed << 13;
+		seed ^= seed >> 17;
+		seed ^= seed << 5;
+		return seed;
+	}
+
+	static U swap_label( U i, U a, U b ) noexcept {
+		if( i == a ) return b;
+		if( i == b ) return a;
+		return i;
+	}
+
+	U pop_spine( std::vector<U>& spine ) noexcept {
+		U x = spine.back();
+		spine.pop_back();
+		tree[x].size = size_of( tree[x].left ) + size_of( tree[x].right ) + 1;
+		return x;
+	}
+
+	U rightmost( U x ) const noexcept {
+		while( tree[x].right != nil ) {
+			x = tree[x].right;
+		}
+		return x;
+	}
+
+	// exchange the labels a and b in the links of slot x
+	void relabel( U x, U a, U b ) noexcept {
+		auto& n = tree[x];
+		n.parent = swap_label( n.parent, a, b );
+		n.left = swap_label( n.left, a, b );
+		n.right = swap_label( n.right, a, b );
+	}
+
+	// exchange the labels a and b in the root and in the links of the neighbours
+	// of slot x, other than a and b themselves. a neighbour shared by a and b is
+	// relabelled once, when x == a.
+	void relabel_neighbours( U x, U a, U b ) noexcept {
+		const node& n = tree[x];
+		for( U y : { n.parent, n.left, n.right } ) {
+			if( y == nil || y == a || y == b ) continue;
+			if( x == b && is_neighbour( a, y ) ) continue;
+			relabel( y, a, b );
+		}
+		if( x == a ) {
+			root = swap_label( root, a, b );
+		}
+	}
+
+	bool is_neighbour( U x, U y ) const noexcept {
+		const node& n = tree[x];
+		return n.parent == y || n.left == y || n.right == y;
+	}
+
+	void rotate_up( U x ) noexcept {
+		U p = tree[x].parent;
+		U g = tree[p].parent;
+		if( tree[p].left == x ) {
+			tree[p].left = tree[x].right;
+			if( tree[x].right != nil ) tree[ tree[x].right ].parent = p;
+			tree[x].right = p;
+		} else {
+			tree[p].right = tree[x].left;
+			if( tree[x].left != nil ) tree[ tree[x].left ].parent = p;
+			tree[x].left = p;
+		}
+		tree[p].parent = x;
+		tree[x].parent = g;
+		if( g == nil ) {
+			root = x;
+		} else if( tree[g].left == p ) {
+			tree[g].left = x;
+		} else {
+			tree[g].right = x;
+		}
+		tree[p].size = size_of( tree[p].left ) + size_of( tree[p].right ) + 1;
+		tree[x].size = size_of( tree[x].left ) + size_of( tree[x].right ) + 1;
+	}
+};
+
+// T -- the value type
+// U -- the index type, an unsigned integer type or a packed_index
+// A -- the allocator, rebound separately for the values and the nodes
+// E -- the erase policy, erase_swap or erase_stable
+// L -- the storage layout, layout_soa, layout_aos or layout_split
+template<typename T,typename U = uint32_t,typename A = std::allocator<T>,typename E = erase_swap,typename L = layout_soa>
+struct list : list_types_base<T,U>, list_storage<T,U,A,L>, list_slots<typename index_traits<U>::type,A,E> {
+	using reference              = T&;
+	using const_reference        = const T&;
+	using pointer                = T*;
+	using const_pointer          = const T*;
+	using list_type              = list<T,U,A,E,L>;
+	using iterator               = list_iterator<list_type>;
+	using const_iterator         = list_const_iterator<list_type>;
+	using reverse_iterator       = std::reverse_iterator<iterator>;
+	using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+	using allocator_type         = A;
+	using erase_policy           = E;
+	using layout_policy          = L;
+	using handle_type            = list_handle<typename index_traits<U>::type>;
+	using storage_type           = list_storage<T,U,A,L>;
+	using slots_type             = list_slots<typename index_traits<U>::type,A,E>;
+	using ranks_type             = list_ranks<typename index_traits<U>::type,A>;
+	using link_type              = U;
+	using stable_tag             = std::integral_constant<bool,std::is_same<E,erase_stable>::value>;
+
+	static const bool stable_slots = stable_tag::value;
+
+	// SFINAE guard for the iterator-pair overloads
+	template<typename It>
+	using is_input_iterator = typename std::enable_if<std::is_convertible<typename std::iterator_traits<It>::iterator_category,std::input_iterator_tag>::value>::type;
+
+	using values_type            = typename storage_type::values_type;
+
+	static const index_type terminator = index_type(-1); //std::numeric_limits<index_type>::max();
+
+	index_type head = terminator,
+	           tail = terminator;
+
+	// Compaction policy -- after an element is inserted or erased, the storage is
+	// compacted once more than compact_ratio * size() links have been scattered
+	// since the last compaction. Zero disables it.
+	double compact_ratio = 0.0;
+
+	// links written out of storage order since the last compaction (an upper bound)
+	size_type scattered = 0;
+
+	// positional index, see index_positions()
+	ranks_type ranks;
+	
+	list() = default;
+
+	explicit list( const allocator_type& alloc ) :
+		storage_type( alloc ),
+		slots_type( alloc ),
+		ranks( alloc )
+	{}
+
+	list( const list_type& rhs, const allocator_type& alloc ) :
+		storage_type( rhs, alloc ),
+		slots_type( rhs, alloc ),
+		head( rhs.head ),
+		tail( rhs.tail ),
+		compact_ratio( rhs.compact_ratio ),
+		scattered( rhs.scattered ),
+		ranks( rhs.ranks, alloc )
+	{}
+
+	list( const std::initializer_list<value_type>& rhs, const allocator_type& alloc = allocator_type() ) : list(alloc) {
+		assign( rhs );
+	}
+
+	explicit list( const values_type& rhs ) : list( allocator_type( rhs.get_allocator() ) ) {
+		*this = rhs;
+	}
+
+	explicit list( values_type&& rhs ) : list( allocator_type( rhs.get_allocator() ) ) {
+		*this = std::move( rhs );
+	}
+	
+	explicit list( size_type N, const allocator_type& alloc = allocator_type() ) : list(alloc) {
+		resize(N);
+	}
+
+	template<typename InputIt,typename = is_input_iterator<InputIt>>
+	list( InputIt first, InputIt last, const allocator_type& alloc = allocator_type() ) : list(alloc) {
+		assign( first, last );
+	}
+
+	allocator_type get_allocator() const noexcept {
+		return slot_allocator();
+	}
+
+	// Assignment
+
+	list_type& operator=( const values_type& rhs ) {
+		size_type N = rhs.size();
+		if( N > max_size() ) {
+			throw std::exception("cw::list assignment -- vector too big for index_type");
+		}
+		assign_slots( rhs );
+		set_default_nodes( N );
+		return *this;
+	}
+
+	list_type& operator=( values_type&& rhs ) {
+		size_type N = rhs.size();
+		if( N > max_size() ) {
+			throw std::exception("cw::list assignment -- vector too big for index_type");
+		}
+		assign_slots( std::move(rhs) );
+		set_default_nodes( N );
+		return *this;
+	}
+
+	list_type& operator=( const std::initializer_list<value_type>& rhs ) {
+		size_type N = rhs.size();
+		if( N > max_size() ) {
+			throw std::exception("cw::list assignment -- initializer_list too big for index_type");
+		}
+		assign_slots( rhs );
+		set_default_nodes( N );
+		return *this;
+	}
+
+	void assign( size_type count, const T& value ) {
+		assign_slots( count, value );
+		set_default_nodes( count );
+	}
+
+	template<typename InputIt,typename = is_input_iterator<InputIt>>
+	void assign( InputIt first, InputIt last ) {
+		assign_slots( first, last );
+		set_default_nodes( slots() );
+	}
+
+	void assign( const std::initializer_list<T>& rhs ) {
+		assign_slots( rhs );
+		set_default_nodes( rhs.size() );
+	}
+
+	// Element Access
+
+	value_type& front() { return slot_value(head); }
+
+	value_type& back() { return slot_value(tail); }
+
+	// the element at position pos -- O(1) while linear, O(log N) expected with
+	// the positional index, O(N) otherwise
+	value_type& at( size_type pos ) {
+		if( pos >= size() ) {
+			throw std::exception("cw::list::at() -- position out of range");
+		}
+		return slot_value( get_pos_index( index_type(pos) ) );
+	}
+
+	const value_type& at( size_type pos ) const {
+		if( pos >= size() ) {
+			throw std::exception("cw::list::at() -- position out of range");
+		}
+		return slot_value( get_pos_index( index_type(pos) ) );
+	}
+
+	value_type& operator[]( size_type pos ) { return slot_value( get_pos_index( index_type(pos) ) ); }
+
+	const value_type& operator[]( size_type pos ) const { return slot_value( get_pos_index( index_type(pos) ) ); }
+
+	// data() -- the values in storage order, for the contiguous layouts only
+
+	// true while the elements are stored in list order, i.e. slot i holds the
+	// element at position i. set by assignment, resize, compact and the gathering sorts;
+	// cleared by any mutation that writes a link out of storage order.
+	bool linear() const noexcept { return scattered == 0; }
+
+	// Capacity
+
+	bool empty() const noexcept { return size() == 0; }
+
+	size_type size() const noexcept { return slots() - num_free(); }
+	
+	size_type max_size() const noexcept { return size_type( index_traits<U>::max ); }
+	
+	void reserve( size_type N ) {
+		reserve_slots(N);
+	}
+
+	size_type capacity() const noexcept { return slot_capacity(); }
+
+	void shrink_to_fit() {
+		shrink_slots();
+	}
+
+	// Modifiers
+
+	void clear() noexcept {
+		clear_slots();
+		head = tail = terminator;
+		scattered = 0;
+		renew_slots( stable_tag() );
+		ranks.clear();
+	}
+
+	iterator insert( const_iterator pos, const value_type& x ) {
+		return apply_compact_policy( insert_index_node( pos.index, x ) );
+	}
+
+	iterator insert( const_iterator pos, value_type&& x ) {
+		return apply_compact_policy( insert_index_node( pos.index, std::move(x) ) );
+	}
+
+	// Range insertion -- the values are constructed in one contiguous run at the back
+	// of the storage, then linked in before pos as a single straight chain.
+	// Returns an iterator to the first inserted element, or pos if none.
+	template<typename InputIt,typename = is_input_iterator<InputIt>>
+	iterator insert( const_iterator pos, InputIt first, InputIt last ) {
+		size_type offset = slots();
+		append_slots( first, last );
+		return apply_compact_policy( link_block( offset, pos.index ) );
+	}
+
+	iterator insert( const_iterator pos, size_type count, const value_type& x ) {
+		size_type offset = slots();
+		if( offset + count > max_size() ) {
+			throw std::exception("cw::list::insert() -- size too big for index_type");
+		}
+		append_slots( count, x );
+		return apply_compact_policy( link_block( offset, pos.index ) );
+	}
+
+	iterator insert( const_iterator pos, const std::initializer_list<value_type>& rhs ) {
+		return insert( pos, std::begin(rhs), std::end(rhs) );
+	}
+
+	template<typename Range>
+	void append_range( Range&& r ) {
+		using std::begin;
+		using std::end;
+		insert( cend(), begin(r), end(r) );
+	}
+
+	template<typename... Ts>
+	iterator emplace( const_iterator pos, Ts&&... xs ) {
+		return apply_compact_policy( insert_index_node( pos.index, std::forward<Ts>(xs)... ) );
+	}
+
+	iterator erase( const_iterator pos ) {
+		return apply_compact_policy( erase_index(pos.index) );
+	}
+
+	// O(k) for k elements -- the range is unlinked once, then its slots are reclaimed together
+	iterator erase( const_iterator first, const_iterator last ) {
+		if( first == last ) return iterator( last );
+		return apply_compact_policy( iterator( this, erase_range( first.index, last.index ) ) );
+	}
+
+	void push_front( const value_type& x ) {
+		insert_index_node( head, x );
+		apply_compact_policy();
+	}
+
+	void push_back( const value_type& x ) {
+		insert_index_node( terminator, x );
+		apply_compact_policy();
+	}
+
+	void push_front( value_type&& x ) {
+		insert_index_node( head, std::move(x) );
+		apply_compact_policy();
+	}
+
+	void push_back( value_type&& x ) {
+		insert_index_node( terminator, std::move(x) );
+		apply_compact_policy();
+	}
+
+	template<typename... Ts>
+	void emplace_front( Ts&&... xs ) {
+		insert_index_node( head, std::forward<Ts>(xs)... );
+		apply_compact_policy();
+	}
+
+	template<typename... Ts>
+	void emplace_back( Ts&&... xs ) {
+		insert_index_node( terminator, std::forward<Ts>(xs)... );
+		apply_compact_policy();
+	}
+
+	void pop_front() {
+		erase_index(head);
+		apply_compact_policy();
+	}
+
+	void pop_back() {
+		erase_index(tail);
+		apply_compact_policy();
+	}
+
+	void resize( size_type N ) {
+		if( N > max_size() ) {
+			throw std::exception("cw::list::resize() -- size too big for index_type");
+		}
+		size_type current_size = size();
+		if( N > current_size ) {
+			size_type first = slots();
+			grow_slots( first + N - current_size );
+			resize_nodes( first );
+		} else if( N < current_size ) {
+			erase_range( get_pos_index( index_type(N) ), terminator );
+			apply_compact_policy();
+		}
+	}
+
+	void resize( size_type N, const value_type& x ) {
+		if( N > max_size() ) {
+			throw std::exception("cw::list::resize() -- size too big for index_type");
+		}
+		size_type current_size = size();
+		if( N > current_size ) {
+			size_type first = slots();
+			grow_slots( first + N - current_size, x );
+			resize_nodes( first );
+		} else if( N < current_size ) {
+			erase_range( get_pos_index( index_type(N) ), terminator );
+			apply_compact_policy();
+		}
+	}
+
+	void swap( list& rhs ) {
+		storage_type::swap( rhs );
+		std::swap( head, rhs.head );
+		std::swap( tail, rhs.tail );
+		std::swap( compact_ratio, rhs.compact_ratio );
+		std::swap( scattered, rhs.scattered );
+		slots_type::swap( rhs );
+		ranks.swap( rhs.ranks );
+	}
+
+	// Iterators
+
+	iterator begin() noexcept {
+		return iterator( this, head );
+	}
+
+	iterator end() noexcept {
+		return iterator( this, terminator );
+	}
+
+	const_iterator begin() const noexcept {
+		return const_iterator( this, head );
+	}
+
+	const_iterator end() const noexcept {
+		return const_iterator( this, terminator );
+	}
+
+	const_iterator cbegin() const noexcept {
+		return begin();
+	}
+
+	const_iterator cend() const noexcept {
+		return end();
+	}
+
+	reverse_iterator rbegin() noexcept {
+		return reverse_iterator( end() );
+	}
+
+	reverse_iterator rend() noexcept {
+		return reverse_iterator( begin() );
+	}
+
+	const_reverse_iterator rbegin() const noexcept {
+		return const_reverse_iterator( end() );
+	}
+
+	const_reverse_iterator rend() const noexcept {
+		return const_reverse_iterator( begin() );
+	}
+
+	const_reverse_iterator crbegin() const noexcept {
+		return rbegin();
+	}
+
+	const_reverse_iterator crend() const noexcept {
+		return rend();
+	}
+
+	// iterator to the element at position pos, or end() if pos == size().
+	// complexity as at()
+	iterator nth( size_type pos ) noexcept {
+		return iterator( this, get_pos_index( index_type(pos) ) );
+	}
+
+	const_iterator nth( size_type pos ) const noexcept {
+		return const_iterator( this, get_pos_index( index_type(pos) ) );
+	}
+
+	// position of the element, or size() for end(). complexity as at()
+	size_type position_of( const_iterator pos ) const noexcept {
+		return get_index_pos( pos.index );
+	}
+
+	// iterator n elements after pos, or before it for negative n, as std::next
+	// but by position on a linear list or with the positional index
+	iterator next( const_iterator pos, difference_type n = 1 ) noexcept {
+		return iterator( this, advance_index( pos.index, n ) );
+	}
+
+	const_iterator next( const_iterator pos, difference_type n = 1 ) const noexcept {
+		return const_iterator( this, advance_index( pos.index, n ) );
+	}
+
+	iterator prev( const_iterator pos, difference_type n = 1 ) noexcept {
+		return next( pos, -n );
+	}
+
+	const_iterator prev( const_iterator pos, difference_type n = 1 ) const noexcept {
+		return next( pos, -n );
+	}
+
+	// Positional index -- an order-statistic tree over the links, so at(), nth(),
+	// position_of(), next() and prev() are O(log N) expected on a scattered list.
+	// While enabled, insertion and erasure also cost O(log N) expected and the
+	// operations that relink the whole list rebuild it in O(N).
+	void index_positions( bool enable ) {
+		ranks.enabled = enable;
+		if( enable ) {
+			ranks.rebuild( *this );
 		} else {
-			nodes[ prev_pos ].next = left_size;
+			ranks.clear();
+		}
+	}
+
+	bool positions_indexed() const noexcept { return ranks.enabled; }
+
+	// Operations
+
+	template<typename Comp>
+	void merge( list_type& rhs, Comp comp ) {		
+		merge( std::move(rhs), comp );
+
+		// rhs is now empty
+		rhs.clear();
+	}
+
+	template<typename Comp>
+	void merge( list_type&& rhs, Comp comp ) {
+		size_type left_size = size();
+		size_type right_size = rhs.size();
+		size_type sum_size = left_size + right_size;
+		if( sum_size > max_size() ) {
+			throw std::exception("cw::list merge -- too big for index_type");
 		}
 
-		if( pos.index == terminator ) {
-			tail = left_size;
+		if( right_size == 0 ) return;
+		index_type offset = append_storage( std::move(rhs) );
+		scattered += sum_size;
+
+		// terminate the right chain
+		index_type right_head = rhs.head + offset;
+		index_type right_tail = rhs.tail + offset;
+		next_link(right_tail) = terminator;
+
+		// merge the two chains and restore the prev links
+		if( left_size == 0 ) {
+			head = right_head;
 		} else {
-			nodes[ pos.index ].prev = left_size;
+			head = merge_chains( head, right_head, comp );
 		}
+		relink_prev();
 	}
 
-	void splice( const_iterator pos, list_type& rhs, const_iterator first, const_iterator last) {
-		splice( pos, std::move(rhs), first, last );
-		rhs.erase( first, last );
+	void merge( list_type& rhs ) {
+		merge( rhs, less<>() );
 	}
 
-	void splice( const_iterator pos, list_type&&, const_iterator first, const_iterator last ) {
+	void merge( list_type&& rhs ) {
+		merge( std::move(rhs), less<>() );
+	}
+
+	// Remove the matching elements, returning the number removed. The values are
+	// tested in storage order, then the matches are erased together. O(N).
+	// Invalidates iterators to moved elements.
+	size_type remove( const T& value ) {
+		return remove_if( [&]( const value_type& x ){ return x == value; } );
+	}
+
+	template<typename Pred>
+	size_type remove_if( Pred pred ) {
+		size_type M = slots();
+		std::vector<bool> marked( M );
+		size_type N = 0;
+		for(size_type i=0;i<M;++i) {
+			if( !is_free( index_type(i) ) && pred( slot_value(i) ) ) {
+				marked[i] = true;
+				++N;
+			}
+		}
+		if( N > 0 ) {
+			erase_marked( marked );
+			apply_compact_policy();
+		}
+		return N;
+	}
+
+	void reverse() noexcept {
+		reverse_links();
+		std::swap( head, tail );
+		scattered += size();
+		if( ranks.enabled ) {
+			ranks.reverse();
+		}
+	}
+
+	void splice( const_iterator pos, list_type& rhs ) {
+		splice( pos, std::move(rhs) );
+		rhs.clear();
+	}
+
+	void splice( const_iterator pos, list_type&& rhs ) {
 		size_type left_size = size();
-		size_type right_size = std::distance( first, last );
+		size_type right_size = rhs.size();
 		size_type sum_size = left_size + right_size;
 		if( sum_size > max_size() ) {
 			throw std::exception("cw::list splice -- too big for index_type");
 		}
 
-		reserve( sum_size );
-		std::move( first, last, std::back_inserter(*this) );
+		if( right_size == 0 ) return;
+		index_type offset = append_storage( std::move(rhs) );
+		scattered += right_size;
+
+		splice_index( pos.index, rhs.head + offset, rhs.tail + offset );
+		rebuild_ranks();
+	}
+
+	void splice( const_iterator pos, list_type& rhs, const_iterator it ) {
+		splice( pos, std::move(rhs), it );
+		rhs.erase( it );
+	}
+
+	void splice( const_iterator pos, list_type&& rhs, const_iterator it ) {
+		size_type left_size = size();
+		if( left_size + 1 > max_size() ) {
+			throw std::exception("cw::list splice -- too big for index_type");
+		}
+
+		insert_index_node( pos.index, std::move(*it) );
+	}
+
+	void splice( const_iterator pos, list_type& rhs, const_iterator first, const_iterator last) {
+		splice( pos, std::move(rhs), first, last );
+		rhs.erase( first, last );
+	}
+
+	void splice( const_iterator pos, list_type&&, const_iterator first, const_iterator last ) {
+		insert( pos, std::make_move_iterator( iterator(first) ), std::make_move_iterator( iterator(last) ) );
 	}
 
-	// Delete repeated values
+	// Delete consecutive repeated values, keeping the first of each run -- one
+	// pass in list order, comparing each element with the last one kept.
+	// Returns the number erased. O(N). Invalidates iterators to moved elements.
 	template<typename Comp>
-	void unique( Comp comp ) {
-		index_type N = index_type(values.size());
-		for(index_type i=0;i<N;++i) {
-			for(index_type j=i+1;j<N;++j) {
-				if( comp( values[i], values[j] ) ) {
-					erase_index(j);
-					--j; --N;
-				}
+	size_type unique( Comp comp ) {
+		if( size() < 2 ) return 0;
+		std::vector<bool> marked( slots() );
+		size_type N = 0;
+		index_type kept = head;
+		for( index_type i = next_link(head); i != terminator; i = next_link(i) ) {
+			if( comp( slot_value(kept), slot_value(i) ) ) {
+				marked[i] = true;
+				++N;
+			} else {
+				kept = i;
 			}
 		}
+		if( N > 0 ) {
+			erase_marked( marked );
+			apply_compact_policy();
+		}
+		return N;
 	}
 
-	void unique() {
-		unique( equal_to<>() );
+	size_type unique() {
+		return unique( equal_to<>() );
 	}
 
 	template<typename Comp>
 	void sort( Comp comp ) {
-		size_type N = nodes.size();
+		size_type N = size();
 		if( N < 2 ) return;
-		//merge_sort(head,tail,N,comp);
-		insertion_sort(head,tail,comp);
-		//selection_sort(head,tail,comp);
+		merge_sort(comp);
+		scattered += N;
 	}
 
+	// integral value types are radix sorted
 	void sort() {
-		sort( less<>() );
+		sort_default( is_radix_key<value_type>() );
+	}
+
+	// Sort by a key, e.g. []( const T& x ){ return x.id; }
+	// Each key is computed once. Integral keys are radix sorted -- O(N) for a
+	// fixed key size. Other keys are compared with <. Stable, relinks only.
+	template<typename Key>
+	void sort_by_key( Key key ) {
+		size_type N = size();
+		if( N < 2 ) return;
+		key_sort( key, false, is_radix_key<key_result<Key>>() );
+		scattered += N;
+	}
+
+	// Sort into sequential storage -- a permutation of indexes is sorted contiguously,
+	// then the values are gathered into sorted order and the nodes are rebuilt as a
+	// straight chain. Stable. Invalidates all iterators.
+	template<typename Comp>
+	void sort_compact( Comp comp ) {
+		std::vector<index_type> order;
+		order.reserve( size() );
+		for( index_type i = head; i != terminator; i = next_link(i) ) {
+			order.push_back( i );
+		}
+		std::stable_sort( std::begin(order), std::end(order), [&]( index_type a, index_type b ){ return comp( slot_value(a), slot_value(b) ); } );
+		gather_order( std::begin(order), std::end(order) );
+	}
+
+	void sort_compact() {
+		sort_compact_default( is_radix_key<value_type>() );
+	}
+
+	// sort_compact using a cached key, as sort_by_key
+	template<typename Key>
+	void sort_compact_by_key( Key key ) {
+		key_sort( key, true, is_radix_key<key_result<Key>>() );
+	}
+
+	// Compaction
+
+	// Rewrite the storage into traversal order, so the element at position i
+	// is stored at index i and its links are i-1 and i+1.
+	// In place, O(N). Invalidates all iterators.
+	void compact() {
+		compact_index( terminator );
+	}
+
+	// Handles -- erase_stable only
+
+	handle_type handle( const_iterator pos ) const {
+		static_assert( stable_slots, "cw::list handles require the erase_stable policy" );
+		return { pos.index, generations[pos.index] };
 	}
 
+	// false once the element has been erased, or the list compacted, sorted into
+	// sequential storage, assigned or cleared
+	bool valid( handle_type h ) const noexcept {
+		static_assert( stable_slots, "cw::list handles require the erase_stable policy" );
+		return h.index < generations.size() && generations[h.index] == h.generation;
+	}
+
+	// end() if the handle is not valid
+	iterator iterator_to( handle_type h ) noexcept {
+		return valid(h) ? iterator( this, h.index ) : end();
+	}
+
+	const_iterator iterator_to( handle_type h ) const noexcept {
+		return valid(h) ? const_iterator( this, h.index ) : end();
+	}
+
+	// iter_swap relinks through swap_nodes
+	friend iterator;
+
 protected:
 
 	// Assignment
 
+	// link the N slots as a straight chain
 	void set_default_nodes( size_type N ) {
-		nodes.resize( N );
-		if( N == 0 ) return;
-		nodes[0].prev = terminator;
-		nodes[0].next = 1;
+		scattered = 0;
+		renew_slots( stable_tag() );
+		if( N == 0 ) {
+			head = tail = terminator;
+			ranks.clear();
+			return;
+		}
+		for(size_type i=0;i<N;++i) {
+			set_links( index_type(i), index_type(i-1), index_type(i+1) );
+		}
+		next_link( index_type(N-1) ) = terminator;
 		head = 0;
 		tail = index_type(N-1);
-		if( N == 1 ) return;
-		for(size_type i=1;i<N;++i) {
-			nodes[i].prev = index_type(i-1);
-			nodes[i].next = index_type(i+1);
-		}
-		nodes[N-1].next = terminator;
+		rebuild_ranks();
 	}
 
 	// Iteration
 
 	index_type prev_index( index_type i ) const {
 		if( i == terminator ) return tail;
-		return nodes[i].prev;
+		return prev_link(i);
 	}
 
 	index_type next_index( index_type i ) const {
 		if( i == terminator ) return head;
-		return nodes[i].next;
+		return next_link(i);
+	}
+
+	index_type prev_index( index_type index, index_type n ) const {
+		for(index_type i=0;i<n;++i)
+			index = prev_index(index);
+		return index;
+	}
+
+	index_type next_index( index_type index, index_type n ) const {
+		for(index_type i=0;i<n;++i)
+			index = next_index(index);
+		return index;
+	}
+
+	index_type advance_index( index_type index, difference_type n ) const {
+		if( linear() || ranks.enabled ) {
+			return get_pos_index( index_type( difference_type( get_index_pos(index) ) + n ) );
+		}
+		if( n > 0 )
+			index = next_index( index, index_type(n) );
+		if( n < 0 )
+			index = prev_index( index, index_type(-n) );
+		return index;
+	}
+
+	// Element Access
+
+	// the index of the element at position n, or the terminator if n >= size()
+	index_type get_pos_index( index_type n ) const {
+		if( n >= size() ) return terminator;
+		if( linear() ) return n;
+		if( ranks.enabled ) return ranks.select(n);
+		index_type half = index_type(size() / 2);
+		if( n < half ) {
+			return next_index( head, n );
+		} else {
+			return prev_index( tail, index_type(size()-1) - n );
+		}
+	}
+
+	// the position of the element at index, or size() for the terminator
+	index_type get_index_pos( index_type index ) const {
+		if( index == terminator ) return index_type(size());
+		if( linear() ) return index;
+		if( ranks.enabled ) return ranks.rank(index);
+		index_type n = 0;
+		for( ; index != head; index = prev_link(index) ) {
+			++n;
+		}
+		return n;
+	}
+
+	// Modifiers
+
+	// construct a value in a new slot and link it in before index
+	template<typename... Ts>
+	iterator insert_index_node( index_type index, Ts&&... xs ) {
+		return link_index( new_slot( stable_tag(), std::forward<Ts>(xs)... ), index );
+	}
+
+	// link the unlinked node N in before index
+	iterator link_index( index_type N, index_type index ) {
+		if( index != terminator || tail != index_type(N-1) ) {
+			++scattered;
+		}
+		if( index == terminator ) {
+			set_links( N, tail, terminator );
+			if( tail == terminator ) {
+				head = N;
+			} else {
+				next_link(tail) = N;
+			}
+			tail = N;
+		} else {
+			index_type prev_index = prev_link(index);
+			set_links( N, prev_index, index );
+			prev_link(index) = N;
+			if( prev_index == terminator ) {
+				head = N;
+			} else {
+				next_link(prev_index) = N;
+			}
+		}
+		if( ranks.enabled ) {
+			ranks.insert( N, index );
+		}
+		return iterator( this, N );
+	}
+
+	iterator erase_index( index_type index ) {
+
+		index_type prev_index = prev_link(index);
+		index_type next_index = next_link(index);
+
+		if( prev_index == terminator ) {
+			head = next_index;
+		} else {
+			next_link(prev_index) = next_index;
+		}
+		
+		if( next_index == terminator ) {
+			tail = prev_index;
+		} else {
+			prev_link(next_index) = prev_index;
+		}
+
+		if( ranks.enabled ) {
+			ranks.erase( index );
+		}
+		next_index = release_slot( index, next_index, stable_tag() );
+		return iterator( this, next_index );
+	}
+
+	// Slots
+
+	// construct a value at the back of the storage, returning its index. the node is unlinked.
+	template<typename... Ts>
+	index_type new_slot( std::false_type, Ts&&... xs ) {
+		index_type N = index_type(slots());
+		emplace_slot( std::forward<Ts>(xs)... );
+		return N;
+	}
+
+	// reuse a free slot if there is one
+	template<typename... Ts>
+	index_type new_slot( std::true_type, Ts&&... xs ) {
+		if( free_head == terminator ) {
+			index_type N = new_slot( std::false_type(), std::forward<Ts>(xs)... );
+			add_slots( N, N + 1, std::true_type() );
+			return N;
+		}
+		index_type index = free_head;
+		slot_value(index) = value_type( std::forward<Ts>(xs)... );
+		free_head = next_link(index);
+		--free_count;
+		++generations[ index ];
+		return index;
+	}
+
+	// release the slot of an unlinked node, returning the new index of follow.
+	// erase_swap -- move the element at the back of the storage into the slot.
+	index_type release_slot( index_type index, index_type follow, std::false_type ) {
+		index_type last_index = index_type(slots() - 1);
+
+		if( index != last_index || follow != terminator ) {
+			++scattered;
+		}
+
+		// move the last element to the erased index
+		if( index < last_index ) {
+			move_slot( last_index, index );
+			if( follow == last_index ) {
+				follow = index;
+			}
+		}
+		pop_slot();
+		return follow;
+	}
+
+	// move the element in slot from to the unused slot to, keeping its position
+	void move_slot( index_type from, index_type to ) {
+		index_type prev = prev_link(from);
+		index_type next = next_link(from);
+
+		slot_value(to) = std::move( slot_value(from) );
+		set_links( to, prev, next );
+		if( ranks.enabled ) {
+			ranks.move( from, to );
+		}
+
+		if( prev == terminator ) {
+			head = to;
+		} else {
+			next_link(prev) = to;
+		}
+
+		if( next == terminator ) {
+			tail = to;
+		} else {
+			prev_link(next) = to;
+		}
+	}
+
+	// erase the elements in [first,last), returning the new index of last
+	index_type erase_range( index_type first, index_type last ) {
+		if( first == head && last == terminator ) {
+			clear();
+			return terminator;
+		}
+
+		std::vector<index_type> chain;
+		for( index_type i = first; i != last; i = next_link(i) ) {
+			chain.push_back( i );
+			if( ranks.enabled ) {
+				ranks.erase( i );
+			}
+		}
+
+		// unlink the chain in one step
+		index_type prev = prev_link(first);
+		if( prev == terminator ) {
+			head = last;
+		} else {
+			next_link(prev) = last;
+		}
+		if( last == terminator ) {
+			tail = prev;
+		} else {
+			prev_link(last) = prev;
+			++scattered;
+		}
+
+		return release_range( chain, last, stable_tag() );
 	}
 
-	index_type prev_index( index_type index, index_type n ) const {
-		for(index_type i=0;i<n;++i)
-			index = prev_index(index);
-		return index;
+	// erase_swap -- the slots of the chain that lie below the last chain.size()
+	// slots of the storage are filled from the survivors above, then the storage
+	// is truncated. a chain occupying the back of the storage moves nothing.
+	index_type release_range( const std::vector<index_type>& chain, index_type follow, std::false_type ) {
+		size_type k = chain.size();
+		size_type cut = slots() - k;
+
+		std::vector<bool> above( k );
+		for( auto i : chain ) {
+			if( i >= cut ) {
+				above[ i - cut ] = true;
+			}
+		}
+
+		size_type from = cut;
+		for( auto i : chain ) {
+			if( i >= cut ) continue;
+			while( above[ from - cut ] ) {
+				++from;
+			}
+			move_slot( index_type(from), i );
+			++scattered;
+			if( follow == index_type(from) ) {
+				follow = i;
+			}
+			++from;
+		}
+
+		truncate_slots( cut );
+		return follow;
 	}
 
-	index_type next_index( index_type index, index_type n ) const {
-		for(index_type i=0;i<n;++i)
-			index = next_index(index);
-		return index;
+	// erase_stable -- the slots of the chain join the free list in place
+	index_type release_range( const std::vector<index_type>& chain, index_type follow, std::true_type ) {
+		for( auto i : chain ) {
+			release_slot( i, terminator, std::true_type() );
+		}
+		return follow;
 	}
 
-	index_type advance_index( index_type index, difference_type n ) const {
-		if( n > 0 )
-			next_index( index, index_type(n) );
-		if( n < 0 )
-			prev_index( index, index_type(-n) );
-		return index;
-	}
+	// erase_stable -- push the slot onto the free list
+	index_type release_slot( index_type index, index_type follow, std::true_type ) {
+		++scattered;
 
-	// Element Access
+		// release any resources held by the erased value
+		static_cast<void>( value_type( std::move( slot_value(index) ) ) );
 
-	index_type get_value_index( const T& val ) const {
-		return (&val - &values[0]) / sizeof(value_type);
+		// both links, so reverse() leaves the free list intact
+		prev_link(index) = free_head;
+		next_link(index) = free_head;
+		free_head = index;
+		++free_count;
+		++generations[ index ];
+		return follow;
 	}
 
-	node& get_value_node( const T& val ) {
-		return nodes[ get_value_index(val) ];
+	// erase the elements in the marked slots in one pass over the list and one over
+	// the storage, rather than one erase_index each
+	void erase_marked( const std::vector<bool>& marked ) {
+		unlink_marked( marked );
+		release_marked( marked, stable_tag() );
+		rebuild_ranks();
 	}
 
-	index_type get_pos_index( index_type n ) const {
-		index_type half = index_type(nodes.size() / 2);
-		if( n < half ) {
-			return next_index( head, n );
+	// link the unmarked elements to each other, in list order
+	void unlink_marked( const std::vector<bool>& marked ) {
+		index_type prev = terminator;
+		for( index_type i = head; i != terminator; i = next_link(i) ) {
+			if( marked[i] ) continue;
+			prev_link(i) = prev;
+			if( prev == terminator ) {
+				head = i;
+			} else {
+				next_link(prev) = i;
+			}
+			prev = i;
+		}
+		if( prev == terminator ) {
+			head = terminator;
 		} else {
-			return prev_index( tail, index_type(nodes.size()-1) - n );
+			next_link(prev) = terminator;
 		}
+		tail = prev;
 	}
 
-	// Modifiers
+	// erase_swap -- slide the survivors down, keeping their storage order,
+	// and rewrite the links through a table of their new indexes
+	void release_marked( const std::vector<bool>& marked, std::false_type ) {
+		size_type N = slots();
+		std::vector<index_type> remap( N );
+		size_type j = 0;
+		for(size_type i=0;i<N;++i) {
+			remap[i] = marked[i] ? terminator : index_type(j++);
+		}
+		auto relabel = [&]( index_type i ){ return ( i == terminator ) ? terminator : remap[i]; };
+		for(size_type i=0;i<N;++i) {
+			if( marked[i] ) continue;
+			index_type k = remap[i];
+			if( k != i ) {
+				slot_value(k) = std::move( slot_value(i) );
+			}
+			set_links( k, relabel( prev_link(i) ), relabel( next_link(i) ) );
+		}
+		head = relabel( head );
+		tail = relabel( tail );
+		truncate_slots( j );
+	}
 
-	iterator insert_index_node( index_type index ) {
-		index_type N = index_type(nodes.size());
-		if( index == terminator ) {
-			nodes.push_back( {tail, terminator} );
-			if( tail == terminator ) {
-				head = N;
-			} else {
-				nodes[ tail ].next = N;
+	// erase_stable -- the marked slots join the free list in place
+	void release_marked( const std::vector<bool>& marked, std::true_type ) {
+		for(size_type i=0;i<marked.size();++i) {
+			if( marked[i] ) {
+				release_slot( index_type(i), terminator, std::true_type() );
 			}
-			tail = N;
-		} else {
-			index_type prev_index = nodes[ index ].prev;
-			nodes.push_back( { prev_index, index } );
-			nodes[ index ].prev = N;
-			if( prev_index == terminator ) {
-				head = N;
+		}
+	}
+
+	// give the slots in [first,last) at the back of the storage a live generation
+	void add_slots( size_type, size_type, std::false_type ) noexcept {}
+
+	void add_slots( size_type first, size_type last, std::true_type ) {
+		for(size_type i=first;i<last;++i) {
+			if( i < generations.size() ) {
+				++generations[i];
 			} else {
-				nodes[ prev_index ].next = N;
+				generations.push_back(0);
 			}
 		}
-		return iterator( this, N );
 	}
 
-	iterator erase_index( index_type index ) {
-
-		index_type prev_index = nodes[ index ].prev;
-		index_type next_index = nodes[ index ].next;
+	// empty the free list and give every slot a new generation,
+	// invalidating all handles
+	void renew_slots( std::false_type ) noexcept {}
 
-		if( prev_index == terminator ) {
-			head = next_index;
-		} else {
-			nodes[ prev_index ].next = next_index;
-		}
-		
-		if( next_index == terminator ) {
-			tail = prev_index;
-		} else {
-			nodes[ next_index ].prev = prev_index;
+	void renew_slots( std::true_type ) {
+		free_head = terminator;
+		free_count = 0;
+		for( auto&& g : generations ) {
+			g |= 1;
 		}
+		add_slots( 0, slots(), std::true_type() );
+	}
 
-		index_type last_index = index_type(values.size() - 1);
-
-		// move the last element to the erased index
-		if( index < last_index ) {
-			index_type last_prev = nodes[ last_index ].prev;
-			index_type last_next = nodes[ last_index ].next;
+	// move the storage of rhs onto the back of the storage, returning the offset of its indexes.
+	// the links into and out of the moved chain still need to be connected.
+	index_type append_storage( list_type&& rhs ) {
+		if( rhs.num_free() > 0 ) {
+			rhs.compact();
+		}
 
-			values[index] = std::move( values.back() );
-			nodes[index] = std::move( nodes.back() );
-		
-			if( last_prev == terminator ) {
-				head = index;
-			} else {
-				nodes[ last_prev ].next = index;
-			}
+		size_type offset = slots();
+		size_type sum_size = offset + rhs.slots();
+		if( sum_size > max_size() ) {
+			throw std::exception("cw::list -- storage too big for index_type");
+		}
 
-			if( last_next == terminator ) {
-				tail = index;
-			} else {
-				nodes[ last_next ].prev = index;
-			}
+		// move the slots across, offsetting their links
+		reserve_slots( sum_size );
+		for(size_type i=offset;i<sum_size;++i) {
+			index_type j = index_type(i - offset);
+			emplace_slot( std::move( rhs.slot_value(j) ) );
+			set_links( index_type(i), index_type( rhs.prev_link(j) + offset ), index_type( rhs.next_link(j) + offset ) );
 		}
-		values.pop_back();
-		nodes.pop_back();
-		return iterator( this, next_index );
+
+		add_slots( offset, sum_size, stable_tag() );
+		return index_type(offset);
 	}
 
-	void push_front_node() {
-		index_type N = index_type(nodes.size());
-		nodes.push_back( { terminator, head } );
-		if( head == terminator ) {
-			tail = N;
-		} else {
-			nodes[head].prev = N;
-		}
-		head = N;
+	// link the slots in [first,slots()) at the back as a straight chain
+	void resize_nodes( size_type first ) {
+		link_block( first, terminator );
 	}
 
-	void push_back_node() {
-		index_type N = index_type(nodes.size());
-		nodes.push_back( { tail, terminator } );
-		if( tail == terminator ) {
-			head = N;
-		} else {
-			nodes[tail].next = N;
+	// link the slots in [first,slots()) in before index as a
+	// straight chain. returns an iterator to the first, or to index if there are none.
+	iterator link_block( size_type first, index_type index ) {
+		size_type last = slots();
+		if( last > max_size() ) {
+			truncate_slots( first );
+			throw std::exception("cw::list -- size too big for index_type");
 		}
-		tail = N;
-	}
+		add_slots( first, last, stable_tag() );
+		if( first == last ) return iterator( this, index );
 
-	void resize_nodes( size_type N ) {
-		
-		size_type current_size = size();
-		if( current_size <= N ) return;
-		
-		// modify previous tail and add first new node
-		if( tail == terminator ) {
-			head = 0;
-			nodes[0].prev = terminator;
-			nodes[0].next = 1;
-		} else {
-			nodes[tail].next = index_type(current_size);
-			nodes[current_size].prev = tail;
-			if( N > current_size + 1 ) {
-				nodes[current_size].next = index_type(current_size + 1);
-			} else {
-				nodes[current_size].next = terminator;
-			}
+		if( index != terminator || tail != index_type(first - 1) ) {
+			++scattered;
 		}
 
-		// add more new nodes
-		for( size_type i = current_size + 1; i < N-1; ++i ) {
-			nodes[i].prev = index_type(i - 1);
-			nodes[i].next = index_type(i + 1);
+		for(size_type i=first;i<last;++i) {
+			set_links( index_type(i), index_type(i - 1), index_type(i + 1) );
 		}
+		splice_index( index, index_type(first), index_type(last - 1) );
 
-		// add the last node and update the tail
-		if( N > current_size + 1 ) {
-			tail = index_type(N - 1);
-			nodes[tail].prev = tail - 1;
-			nodes[tail].next = terminator;
+		if( ranks.enabled ) {
+			if( 2 * ( last - first ) > size() ) {
+				rebuild_ranks();
+			} else {
+				for(size_type i=first;i<last;++i) {
+					ranks.insert( index_type(i), index );
+				}
+			}
 		}
+		return iterator( this, index_type(first) );
 	}
 
 	void swap_nodes( index_type left, index_type right ) {
@@ -835,90 +2134,222 @@ protected:
 		// can't swap with the terminator
 		if( left == terminator || right == terminator ) return;
 
-		index_type left_prev = nodes[ left ].prev;
-		index_type left_next = nodes[ left ].next;
-		index_type right_prev = nodes[ right ].prev;
-		index_type right_next = nodes[ right ].next;
+		scattered += 2;
+		if( ranks.enabled ) {
+			ranks.swap_slots( left, right );
+		}
+
+		index_type left_prev = prev_link(left);
+		index_type left_next = next_link(left);
+		index_type right_prev = prev_link(right);
+		index_type right_next = next_link(right);
 
 		// check for adjacency left -> right
 		if( right_prev == left ) {
-			nodes[ left ].prev = left_next;
-			nodes[ left ].next = right_next;
-			nodes[ right ].prev = left_prev;
-			nodes[ right ].next = right_prev;
+			prev_link(left) = left_next;
+			next_link(left) = right_next;
+			prev_link(right) = left_prev;
+			next_link(right) = right_prev;
 
 			if( left_prev == terminator ) {
 				head = right;
 			} else {
-				nodes[ left_prev ].next = right;
+				next_link(left_prev) = right;
 			}
 
 			if( right_next == terminator ) {
 				tail = left;
 			} else {
-				nodes[ right_next ].prev = left;
+				prev_link(right_next) = left;
 			}
 			return;
 		}
 
 		// check for adjacency right -> left
 		if( right_next == left ) {
-			nodes[ left ].prev = right_prev;
-			nodes[ left ].next = left_prev;
-			nodes[ right ].prev = right_next;
-			nodes[ right ].next = left_next;
+			prev_link(left) = right_prev;
+			next_link(left) = left_prev;
+			prev_link(right) = right_next;
+			next_link(right) = left_next;
 
 			if( left_next == terminator ) {
 				tail = right;
 			} else {
-				nodes[ left_next ].prev = right;
+				prev_link(left_next) = right;
 			}
 
 			if( right_prev == terminator ) {
 				head = left;
 			} else {
-				nodes[ right_prev ].next = left;
+				next_link(right_prev) = left;
 			}
 			return;
 		}
 
 		// non-adjacent
 
-		nodes[ left ].prev = right_prev;
-		nodes[ left ].next = right_next;
-		nodes[ right ].prev = left_prev;
-		nodes[ right ].next = left_next;
+		prev_link(left) = right_prev;
+		next_link(left) = right_next;
+		prev_link(right) = left_prev;
+		next_link(right) = left_next;
 
 		if( left_prev == terminator ) {
 			head = right;
 		} else {
-			nodes[ left_prev ].next = right;
+			next_link(left_prev) = right;
 		}
 		
 		if( left_next == terminator ) {
 			tail = right;
 		} else {
-			nodes[ left_next ].prev = right;
+			prev_link(left_next) = right;
 		}
 
 		if( right_prev == terminator ) {
 			head = left;
 		} else {
-			nodes[ right_prev ].next = left;
+			next_link(right_prev) = left;
 		}
 
 		if( right_next == terminator ) {
 			tail = left;
 		} else {
-			nodes[ right_next ].prev = left;
+			prev_link(right_next) = left;
+		}
+	}
+
+	// exchange the storage of two elements, keeping their positions in the list
+	void swap_slots( index_type a, index_type b ) {
+		if( a == b ) return;
+
+		index_type a_prev = prev_link(a);
+		index_type a_next = next_link(a);
+		index_type b_prev = prev_link(b);
+		index_type b_next = next_link(b);
+
+		std::swap( slot_value(a), slot_value(b) );
+		set_links( a, swap_label( b_prev, a, b ), swap_label( b_next, a, b ) );
+		set_links( b, swap_label( a_prev, a, b ), swap_label( a_next, a, b ) );
+
+		// point the neighbours at the new indexes.
+		// neighbours that are themselves a or b were relabelled above.
+		if( a_prev == terminator ) {
+			head = b;
+		} else if( a_prev != b ) {
+			next_link(a_prev) = b;
+		}
+
+		if( a_next == terminator ) {
+			tail = b;
+		} else if( a_next != b ) {
+			prev_link(a_next) = b;
+		}
+
+		if( b_prev == terminator ) {
+			head = a;
+		} else if( b_prev != a ) {
+			next_link(b_prev) = a;
+		}
+
+		if( b_next == terminator ) {
+			tail = a;
+		} else if( b_next != a ) {
+			prev_link(b_next) = a;
+		}
+	}
+
+	void rebuild_ranks() {
+		if( ranks.enabled ) {
+			ranks.rebuild( *this );
+		}
+	}
+
+	static index_type swap_label( index_type i, index_type a, index_type b ) noexcept {
+		if( i == a ) return b;
+		if( i == b ) return a;
+		return i;
+	}
+
+	// Operations
+
+	template<typename Key>
+	using key_result = typename std::decay<decltype( std::declval<Key&>()( std::declval<const value_type&>() ) )>::type;
+
+	template<typename K>
+	using is_radix_key = std::integral_constant<bool, std::is_integral<K>::value && !std::is_same<K,bool>::value>;
+
+	template<typename K>
+	struct keyed_index {
+		K key;
+		index_type index;
+	};
+
+	void sort_default( std::true_type ) {
+		sort_by_key( []( const value_type& x ){ return x; } );
+	}
+
+	void sort_default( std::false_type ) {
+		sort( less<>() );
+	}
+
+	void sort_compact_default( std::true_type ) {
+		sort_compact_by_key( []( const value_type& x ){ return x; } );
+	}
+
+	void sort_compact_default( std::false_type ) {
+		sort_compact( less<>() );
+	}
+
+	// Compaction
+
+	// compact the storage, returning the new index of the element stored at follow
+	index_type compact_index( index_type follow ) {
+		if( num_free() > 0 ) {
+			// gather into new storage, dropping the free slots
+			std::vector<index_type> order;
+			order.reserve( size() );
+			index_type new_follow = terminator;
+			for( index_type i = head; i != terminator; i = next_link(i) ) {
+				if( i == follow ) {
+					new_follow = index_type( order.size() );
+				}
+				order.push_back( i );
+			}
+			gather_order( std::begin(order), std::end(order) );
+			return new_follow;
+		}
+
+		index_type index = head;
+		for( index_type i = 0; index != terminator; ++i ) {
+			// positions before i are already in place, so index >= i
+			if( index != i ) {
+				swap_slots( i, index );
+				follow = swap_label( follow, i, index );
+			}
+			index = next_link(i);
+		}
+		scattered = 0;
+		renew_slots( stable_tag() );
+		rebuild_ranks();
+		return follow;
+	}
+
+	iterator apply_compact_policy( iterator it ) {
+		if( compact_ratio > 0 && double(scattered) > compact_ratio * double(size()) ) {
+			it.index = compact_index( it.index );
 		}
+		return it;
+	}
+
+	void apply_compact_policy() {
+		apply_compact_policy( end() );
 	}
 
 	// Operations
 
 	index_type count( index_type first, index_type last ) {
 		if( first == head && last == tail )
-			return index_type(nodes.size());
+			return index_type(size());
 		if( first == terminator || last == terminator )
 			return 0;
 		index_type N = 1;
@@ -932,59 +2363,25 @@ protected:
 		return N;
 	}
 
-	// produces sorted [first,last] from sorted [first,mid) and sorted [mid,last]
-	template<typename Comp>
-	void merge_index( index_type first, index_type mid, index_type last, Comp comp ) {
-		index_type last_next = next_index(last);
-		for( index_type i = first; i != mid; i = next_index(i) ) {
-			for( index_type j = mid; j != last_next; j = next_index(j) ) {
-				if( comp( values[j], values[i] ) ) {
-					swap_nodes( i, j );
-					if( mid == j )
-						mid = i;
-					std::swap( i, j );
-				} else {
-					break;
-				}
-			}
-		}
-		for( index_type i = mid; i != last_next; i = next_index(i) ) {
-			for( index_type j = next_index(i); j != last_next; j = next_index(j) ) {
-				if( comp( values[j], values[i] ) ) {
-					swap_nodes( i, j );
-					std::swap( i, j );
-				} else {
-					break;
-				}
-			}
-		}
-	}
-
-	// splice [right_head,right_tail] into [head,right_head) at index
-	void splice_index( index_type index, index_type left_size, index_type sum_size, index_type right_head, index_type right_tail ) {
+	// link the chain [first,last] in before index
+	void splice_index( index_type index, index_type first, index_type last ) {
 		index_type prev_pos = prev_index(index);
-		
-		// offset the new indexes
-		for(index_type i=left_size;i<sum_size;++i) {
-			nodes[ i ].prev += left_size;
-			nodes[ i ].next += left_size;
-		}
-		
+
 		// connect the head
 		if( prev_pos == terminator ) {
-			head = right_head;
+			head = first;
 		} else {
-			nodes[ prev_pos ].next = right_head;
+			next_link(prev_pos) = first;
 		}
-		nodes[ right_head ].prev = prev_pos;
+		prev_link(first) = prev_pos;
 
 		// connect the tail
 		if( index == terminator ) {
-			tail = right_tail;
+			tail = last;
 		} else {
-			nodes[ index ].prev = right_tail;
+			prev_link(index) = last;
 		}
-		nodes[ right_tail ].next = index;
+		next_link(last) = index;
 	}
 
 	// insertion sort -- O(N^2) compares/swaps, adaptive, [first,last]
@@ -994,7 +2391,7 @@ protected:
 		for( index_type i = first; i != last; i = next_index(i) ) {
 			for( index_type j = i; j != first_prev; j = prev_index(j) ) {
 				index_type j_next = next_index(j);
-				if( !comp( values[j_next], values[j] ) ) break;
+				if( !comp( slot_value(j_next), slot_value(j) ) ) break;
 				swap_nodes( j, j_next );
 				if( i == j ) i = j_next;
 				else if( i == j_next ) i = j;
@@ -1011,7 +2408,7 @@ protected:
 		for( index_type i = first; i != last_next; i = next_index(i) ) {
 			index_type min_index = i;
 			for( index_type j = next_index(i); j != last_next; j = next_index(j) ) {
-				if( comp( values[j], values[min_index] ) ) {
+				if( comp( slot_value(j), slot_value(min_index) ) ) {
 					min_index = j;
 				}
 			}
@@ -1022,30 +2419,200 @@ protected:
 		}
 	}
 
-	// merge sort, [first,last] -- fix me
+	// merge the next-chains starting at a and b, return the new first index.
+	// stable -- ties are taken from a. the chains must be non-empty and terminated.
 	template<typename Comp>
-	void merge_sort( index_type first, index_type last, size_type N, Comp comp ) {
-		if( N < 2 ) return;
+	index_type merge_chains( index_type a, index_type b, Comp comp ) {
+		index_type first;
+		if( comp( slot_value(b), slot_value(a) ) ) {
+			first = b;
+			b = next_link(b);
+		} else {
+			first = a;
+			a = next_link(a);
+		}
+		index_type last = first;
+		while( a != terminator && b != terminator ) {
+			if( comp( slot_value(b), slot_value(a) ) ) {
+				next_link(last) = b;
+				last = b;
+				b = next_link(b);
+			} else {
+				next_link(last) = a;
+				last = a;
+				a = next_link(a);
+			}
+		}
+		next_link(last) = ( a != terminator ) ? a : b;
+		return first;
+	}
 
-		if( N * sizeof(node) <= 64 ) {
-			insertion_sort(first,last,comp);
-			return;
+	// rebuild the prev links and the tail from the next links, starting at head
+	void relink_prev() noexcept {
+		index_type prev = terminator;
+		for( index_type i = head; i != terminator; i = next_link(i) ) {
+			prev_link(i) = prev;
+			prev = i;
 		}
+		tail = prev;
+		rebuild_ranks();
+	}
 
-		index_type first_pos = index_type( count( head, first ) - 1 );
-		index_type half_size = index_type((N-1) / 2);
-		index_type mid = next_index( first, half_size );
-		index_type mid_next = next_index( mid );
+	// bottom-up merge sort -- O(N log N) compares, stable, relinks only.
+	// bin k holds a sorted chain of 2^k elements (or is empty).
+	template<typename Comp>
+	void merge_sort( Comp comp ) {
+		static const size_t max_bins = std::numeric_limits<index_type>::digits + 1;
+		index_type bins[max_bins];
+		size_t num_bins = 0;
+
+		index_type index = head;
+		while( index != terminator ) {
+			index_type next = next_link(index);
+			next_link(index) = terminator;
+
+			// carry the new element up through the occupied bins
+			index_type run = index;
+			size_t k = 0;
+			for( ; k < num_bins && bins[k] != terminator; ++k ) {
+				run = merge_chains( bins[k], run, comp );
+				bins[k] = terminator;
+			}
+			if( k == num_bins ) ++num_bins;
+			bins[k] = run;
 
-		merge_sort( first, mid, half_size+1, comp );
-		merge_sort( mid_next, last, N-(half_size+1), comp );
+			index = next;
+		}
 
-		// sorting invalidates indices. recompute them.
-		first = get_pos_index( first_pos );
-		mid_next = next_index( first, half_size + 1 );
-		last = next_index( mid_next, index_type(N - 2) - half_size );
-		
-		merge_index( first, mid_next, last, comp );
+		// lower bins hold later elements
+		index_type run = terminator;
+		for(size_t k=0;k<num_bins;++k) {
+			if( bins[k] == terminator ) continue;
+			run = ( run == terminator ) ? bins[k] : merge_chains( bins[k], run, comp );
+		}
+
+		head = run;
+		relink_prev();
+	}
+
+	// integral keys -- radix sort, or a comparison sort for short lists
+	template<typename Key>
+	void key_sort( Key key, bool gather, std::true_type ) {
+		using key_type = key_result<Key>;
+		using radix_type = typename std::make_unsigned<key_type>::type;
+		using entry = keyed_index<radix_type>;
+
+		// signed keys have their sign bit flipped so they order as unsigned
+		const radix_type sign_bit = std::is_signed<key_type>::value ? radix_type( radix_type(1) << ( 8 * sizeof(radix_type) - 1 ) ) : radix_type(0);
+
+		std::vector<entry> a;
+		a.reserve( slots() );
+		for( index_type i = head; i != terminator; i = next_link(i) ) {
+			a.push_back( { radix_type( radix_type( key( slot_value(i) ) ) ^ sign_bit ), i } );
+		}
+
+		if( a.size() < 64 ) {
+			std::stable_sort( std::begin(a), std::end(a), []( const entry& x, const entry& y ){ return x.key < y.key; } );
+		} else {
+			radix_sort( a );
+		}
+		apply_order( std::begin(a), std::end(a), gather );
+	}
+
+	// other keys -- computed once, then a comparison sort
+	template<typename Key>
+	void key_sort( Key key, bool gather, std::false_type ) {
+		using entry = keyed_index<key_result<Key>>;
+
+		std::vector<entry> a;
+		a.reserve( slots() );
+		for( index_type i = head; i != terminator; i = next_link(i) ) {
+			a.push_back( { key( slot_value(i) ), i } );
+		}
+
+		std::stable_sort( std::begin(a), std::end(a), []( const entry& x, const entry& y ){ return x.key < y.key; } );
+		apply_order( std::begin(a), std::end(a), gather );
+	}
+
+	// LSD radix sort on (key,index) pairs, one byte per pass
+	template<typename R>
+	static void radix_sort( std::vector<keyed_index<R>>& a ) {
+		static const size_t digits = sizeof(R);
+		size_type N = a.size();
+		std::vector<keyed_index<R>> b( N );
+
+		// histogram every digit in one pass
+		size_type counts[digits][256] = {};
+		for( auto&& e : a ) {
+			for(size_t d=0;d<digits;++d) {
+				++counts[d][ ( e.key >> ( 8 * d ) ) & 0xff ];
+			}
+		}
+
+		for(size_t d=0;d<digits;++d) {
+			size_type* count = counts[d];
+
+			// skip digits shared by every key
+			if( count[ ( a[0].key >> ( 8 * d ) ) & 0xff ] == N ) continue;
+
+			size_type sum = 0;
+			for(size_t j=0;j<256;++j) {
+				size_type c = count[j];
+				count[j] = sum;
+				sum += c;
+			}
+			for( auto&& e : a ) {
+				b[ count[ ( e.key >> ( 8 * d ) ) & 0xff ]++ ] = e;
+			}
+			a.swap( b );
+		}
+	}
+
+	static index_type order_index( index_type i ) noexcept {
+		return i;
+	}
+
+	template<typename Entry>
+	static index_type order_index( const Entry& e ) noexcept {
+		return e.index;
+	}
+
+	template<typename It>
+	void apply_order( It first, It last, bool gather ) {
+		if( gather ) {
+			gather_order( first, last );
+		} else {
+			relink_order( first, last );
+		}
+	}
+
+	// relink the nodes to follow the indexes in [first,last)
+	template<typename It>
+	void relink_order( It first, It last ) {
+		index_type prev = terminator;
+		for( ; first != last; ++first ) {
+			index_type index = order_index( *first );
+			prev_link(index) = prev;
+			if( prev == terminator ) {
+				head = index;
+			} else {
+				next_link(prev) = index;
+			}
+			prev = index;
+		}
+		if( prev != terminator ) {
+			next_link(prev) = terminator;
+		}
+		tail = prev;
+		rebuild_ranks();
+	}
+
+	// move the values into the order of the indexes in [first,last),
+	// then rebuild the nodes as a straight chain
+	template<typename It>
+	void gather_order( It first, It last ) {
+		gather_slots( first, last, []( const typename std::iterator_traits<It>::value_type& e ){ return order_index(e); } );
+		set_default_nodes( slots() );
 	}
 
 };
@@ -1062,35 +2629,128 @@ using list32 = list<T,uint32_t>;
 template<typename T>
 using list64 = list<T,uint64_t>;
 
+// packed links, between the power-of-two widths
+template<typename T>
+using list24 = list<T,uint24_index>;
+
+template<typename T>
+using list40 = list<T,uint40_index>;
+
+template<typename T>
+using list48 = list<T,uint48_index>;
+
+// erased slots are reused rather than filled from the back, so iterators stay valid
+template<typename T,typename U = uint32_t>
+using stable_list = list<T,U,std::allocator<T>,erase_stable>;
+
+// values and links interleaved in one vector, see layout_aos
+template<typename T,typename U = uint32_t>
+using aos_list = list<T,U,std::allocator<T>,erase_swap,layout_aos>;
+
+// prev and next links in separate vectors, see layout_split
+template<typename T,typename U = uint32_t>
+using split_list = list<T,U,std::allocator<T>,erase_swap,layout_split>;
+
+#ifdef CW_LIST_PMR
+namespace pmr {
+
+template<typename T,typename U = uint32_t>
+using list = cw::list<T,U,std::pmr::polymorphic_allocator<T>>;
+
+template<typename T>
+using list8 = list<T,uint8_t>;
+
+template<typename T>
+using list16 = list<T,uint16_t>;
+
+template<typename T>
+using list32 = list<T,uint32_t>;
+
+template<typename T>
+using list64 = list<T,uint64_t>;
+
+template<typename T>
+using list24 = list<T,uint24_index>;
+
+template<typename T>
+using list40 = list<T,uint40_index>;
+
+template<typename T>
+using list48 = list<T,uint48_index>;
+
+}
+#endif
+
+// Erasure
+
+template<typename T, typename U, typename A, typename E, typename L, typename Pred>
+size_t erase_if( cw::list<T,U,A,E,L>& c, Pred pred ) {
+	return c.remove_if( pred );
+}
+
+template<typename T, typename U, typename A, typename E, typename L, typename V>
+size_t erase( cw::list<T,U,A,E,L>& c, const V& value ) {
+	return c.remove_if( [&]( const T& x ){ return x == value; } );
+}
+
 // Operators
 
-template<typename T, typename U>
-bool operator==( const cw::list<T,U>& lhs, const cw::list<T,U>& rhs ) {
-	return lhs.size() == rhs.size() && std::equal( lhs.begin(), lhs.end(), rhs.begin() );
+// lists stored in list order compare their values directly while they are contiguous
+
+template<typename List>
+bool list_equal_linear( const List& lhs, const List& rhs, std::true_type ) {
+	return std::equal( lhs.data(), lhs.data() + lhs.size(), rhs.data() );
+}
+
+template<typename List>
+bool list_equal_linear( const List& lhs, const List& rhs, std::false_type ) {
+	return std::equal( lhs.begin(), lhs.end(), rhs.begin() );
+}
+
+template<typename List>
+bool list_less_linear( const List& lhs, const List& rhs, std::true_type ) {
+	return std::lexicographical_compare( lhs.data(), lhs.data() + lhs.size(), rhs.data(), rhs.data() + rhs.size() );
+}
+
+template<typename List>
+bool list_less_linear( const List& lhs, const List& rhs, std::false_type ) {
+	return std::lexicographical_compare( lhs.begin(), lhs.end(), rhs.begin(), rhs.end() );
+}
+
+template<typename T, typename U, typename A, typename E, typename L>
+bool operator==( const cw::list<T,U,A,E,L>& lhs, const cw::list<T,U,A,E,L>& rhs ) {
+	if( lhs.size() != rhs.size() ) return false;
+	if( lhs.linear() && rhs.linear() ) {
+		return list_equal_linear( lhs, rhs, std::integral_constant<bool,cw::list<T,U,A,E,L>::contiguous>() );
+	}
+	return std::equal( lhs.begin(), lhs.end(), rhs.begin() );
 }
 
-template<typename T, typename U>
-bool operator!=( const cw::list<T,U>& lhs, const cw::list<T,U>& rhs ) {
+template<typename T, typename U, typename A, typename E, typename L>
+bool operator!=( const cw::list<T,U,A,E,L>& lhs, const cw::list<T,U,A,E,L>& rhs ) {
 	return !(lhs == rhs);
 }
 
-template<typename T, typename U>
-bool operator<( const cw::list<T,U>& lhs, const cw::list<T,U>& rhs ) {
+template<typename T, typename U, typename A, typename E, typename L>
+bool operator<( const cw::list<T,U,A,E,L>& lhs, const cw::list<T,U,A,E,L>& rhs ) {
+	if( lhs.linear() && rhs.linear() ) {
+		return list_less_linear( lhs, rhs, std::integral_constant<bool,cw::list<T,U,A,E,L>::contiguous>() );
+	}
 	return std::lexicographical_compare( lhs.begin(), lhs.end(), rhs.begin(), rhs.end() );
 }
 
-template<typename T, typename U>
-bool operator>( const cw::list<T,U>& lhs, const cw::list<T,U>& rhs ) {
+template<typename T, typename U, typename A, typename E, typename L>
+bool operator>( const cw::list<T,U,A,E,L>& lhs, const cw::list<T,U,A,E,L>& rhs ) {
 	return rhs < lhs;
 }
 
-template<typename T, typename U>
-bool operator<=( const cw::list<T,U>& lhs, const cw::list<T,U>& rhs ) {
+template<typename T, typename U, typename A, typename E, typename L>
+bool operator<=( const cw::list<T,U,A,E,L>& lhs, const cw::list<T,U,A,E,L>& rhs ) {
 	return !(rhs < lhs);
 }
 
-template<typename T, typename U>
-bool operator>=( const cw::list<T,U>& lhs, const cw::list<T,U>& rhs ) {
+template<typename T, typename U, typename A, typename E, typename L>
+bool operator>=( const cw::list<T,U,A,E,L>& lhs, const cw::list<T,U,A,E,L>& rhs ) {
 	return !(lhs < rhs);
 }
 
@@ -1099,8 +2759,8 @@ bool operator>=( const cw::list<T,U>& lhs, const cw::list<T,U>& rhs ) {
 
 namespace std {
 
-template<typename T, typename U>
-void swap( cw::list<T,U>& lhs, cw::list<T,U>& rhs ) {
+template<typename T, typename U, typename A, typename E, typename L>
+void swap( cw::list<T,U,A,E,L>& lhs, cw::list<T,U,A,E,L>& rhs ) {
 	lhs.swap(rhs);
 }
 
@@ -1,61 +1,683 @@
 #ifndef INCLUDED_CW_LIST_ALGORITHM
 #define INCLUDED_CW_LIST_ALGORITHM
 #include <algorithm>
+#include <numeric>
+#include <functional>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <exception>
 #include "list.h"
+#include "simd.h"
 
 namespace cw {
 
 // Algorithms can be implemented directly on the vector of values,
 // bypassing the linked structure entirely.
+// These take only the default erase_swap policy, whose storage has no free slots.
+//
+// Since the values are visited in storage order rather than list order, only
+// order-independent algorithms are provided. Each also has an overload taking
+// an execution policy as the first argument.
+//
+// find, count, replace, min_element, max_element and the sums (accumulate and
+// reduce without an op) use the vector kernels of simd.h for arithmetic values.
 
-template<typename T,typename U,typename T2,typename BinaryOp>
-T2 accumulate( const cw::list<T,U>& v, T2 init, BinaryOp op ) {
+// Execution policies
+
+struct sequential_policy {};
+
+// Splits the values into contiguous chunks, one per thread.
+// The calling thread processes the first chunk.
+struct parallel_policy {
+	// 0 -- std::thread::hardware_concurrency()
+	unsigned threads;
+
+	// the minimum number of elements given to a thread
+	size_t grain;
+
+	explicit parallel_policy( unsigned threads = 0, size_t grain = 1 << 16 ) : threads(threads), grain(grain) {}
+
+	size_t num_chunks( size_t N ) const {
+		size_t max_chunks = threads > 0 ? threads : std::max( std::thread::hardware_concurrency(), 1u );
+		size_t chunks = std::min( max_chunks, N / std::max( grain, size_t(1) ) );
+		return std::max( chunks, size_t(1) );
+	}
+
+	// calls f( first, last, chunk ) for contiguous chunks covering [0,N), concurrently.
+	// an exception thrown by any chunk is rethrown once all have finished.
+	// returns the number of chunks.
+	template<typename F>
+	size_t for_chunks( size_t N, F f ) const {
+		size_t chunks = num_chunks( N );
+		if( chunks == 1 ) {
+			f( size_t(0), N, size_t(0) );
+			return 1;
+		}
+
+		std::vector<std::exception_ptr> errors( chunks );
+		auto run = [&]( size_t c ) {
+			try {
+				f( N * c / chunks, N * ( c + 1 ) / chunks, c );
+			} catch( ... ) {
+				errors[c] = std::current_exception();
+			}
+		};
+
+		std::vector<std::thread> workers;
+		workers.reserve( chunks - 1 );
+		for(size_t c=1;c<chunks;++c) {
+			workers.emplace_back( run, c );
+		}
+		run( 0 );
+		for( auto&& w : workers ) {
+			w.join();
+		}
+
+		for( auto&& e : errors ) {
+			if( e ) std::rethrow_exception( e );
+		}
+		return chunks;
+	}
+};
+
+const sequential_policy seq = {};
+const parallel_policy par;
+
+// Value kernels -- on a range of values, vectorized where the types allow
+
+// x compares as a value of T -- T has kernels, and x is a T or both are integral
+template<typename T,typename T2>
+struct simd_comparable : std::integral_constant<bool, simd::has_kernels<T>::value && (
+	std::is_same<T,T2>::value ||
+	( std::is_integral<T>::value && std::is_integral<T2>::value && !std::is_same<T2,bool>::value )
+)> {};
+
+// adding the values to a T2 can be done in 64-bit modular arithmetic, or T2 is the floating-point T
+template<typename T,typename T2>
+struct simd_summable : std::integral_constant<bool, simd::has_kernels<T>::value && (
+	std::is_same<T,T2>::value ||
+	( std::is_integral<T>::value && std::is_integral<T2>::value && !std::is_same<T2,bool>::value && sizeof(T2) <= 8 )
+)> {};
+
+template<typename T,typename T2>
+size_t find_values( const T* p, size_t n, const T2& x, std::false_type ) {
+	return size_t( std::find( p, p + n, x ) - p );
+}
+
+// no value of T equals an integral x outside its range
+template<typename T,typename T2>
+size_t find_values( const T* p, size_t n, const T2& x, std::true_type ) {
+	return T(x) == x ? simd::find( p, n, T(x) ) : n;
+}
+
+template<typename T,typename T2>
+size_t find_values( const T* p, size_t n, const T2& x ) {
+	return find_values( p, n, x, simd_comparable<T,T2>() );
+}
+
+template<typename T,typename T2>
+size_t count_values( const T* p, size_t n, const T2& x, std::false_type ) {
+	return size_t( std::count( p, p + n, x ) );
+}
+
+template<typename T,typename T2>
+size_t count_values( const T* p, size_t n, const T2& x, std::true_type ) {
+	return T(x) == x ? simd::count( p, n, T(x) ) : 0;
+}
+
+template<typename T,typename T2>
+size_t count_values( const T* p, size_t n, const T2& x ) {
+	return count_values( p, n, x, simd_comparable<T,T2>() );
+}
+
+template<typename T,typename T2>
+void replace_values( T* p, size_t n, const T2& old_val, const T2& new_val, std::false_type ) {
+	std::replace( p, p + n, old_val, new_val );
+}
+
+template<typename T,typename T2>
+void replace_values( T* p, size_t n, const T2& old_val, const T2& new_val, std::true_type ) {
+	if( T(old_val) == old_val ) simd::replace( p, n, T(old_val), T(new_val) );
+}
+
+template<typename T,typename T2>
+void replace_values( T* p, size_t n, const T2& old_val, const T2& new_val ) {
+	replace_values( p, n, old_val, new_val, simd_comparable<T,T2>() );
+}
+
+// the index of the first value not preceded by comp -- std::less gives
+// the first minimum and std::greater the first maximum
+template<typename T,typename Comp>
+size_t extreme_index( const T* p, size_t n, Comp comp ) {
+	return size_t( std::min_element( p, p + n, comp ) - p );
+}
+
+template<typename T>
+size_t extreme_index( const T* p, size_t n, std::less<T>, std::true_type ) {
+	return simd::min_index( p, n );
+}
+
+template<typename T>
+size_t extreme_index( const T* p, size_t n, std::greater<T>, std::true_type ) {
+	return simd::max_index( p, n );
+}
+
+template<typename T,typename Comp>
+size_t extreme_index( const T* p, size_t n, Comp comp, std::false_type ) {
+	return size_t( std::min_element( p, p + n, comp ) - p );
+}
+
+template<typename T>
+size_t extreme_index( const T* p, size_t n, std::less<T> comp ) {
+	return extreme_index( p, n, comp, simd_comparable<T,T>() );
+}
+
+template<typename T>
+size_t extreme_index( const T* p, size_t n, std::greater<T> comp ) {
+	return extreme_index( p, n, comp, simd_comparable<T,T>() );
+}
+
+template<typename T,typename T2>
+T2 sum_values( const T* p, size_t n, T2 init, std::false_type ) {
+	return std::accumulate( p, p + n, init );
+}
+
+// integral -- the value conversions and additions are all modular
+template<typename T,typename T2>
+T2 sum_values( const T* p, size_t n, T2 init, std::true_type, std::true_type ) {
+	return T2( uint64_t(init) + simd::sum( p, n ) );
+}
+
+template<typename T,typename T2>
+T2 sum_values( const T* p, size_t n, T2 init, std::true_type, std::false_type ) {
+	return init + simd::sum( p, n );
+}
+
+template<typename T,typename T2>
+T2 sum_values( const T* p, size_t n, T2 init, std::true_type ) {
+	return sum_values( p, n, init, std::true_type(), std::is_integral<T>() );
+}
+
+template<typename T,typename T2>
+T2 sum_values( const T* p, size_t n, T2 init ) {
+	return sum_values( p, n, init, simd_summable<T,T2>() );
+}
+
+// Reductions -- op must be associative and commutative, as the values are
+// combined in storage order and, with par, in independent chunks.
+
+template<typename T,typename U,typename A,typename T2,typename BinaryOp>
+T2 reduce( const cw::list<T,U,A>& v, T2 init, BinaryOp op ) {
 	return std::accumulate( v.values.begin(), v.values.end(), init, op );
 }
 
-template<typename T,typename U,typename T2>
-T2 accumulate( const cw::list<T,U>& v, T2 init ) {
-	return std::accumulate( v.values.begin(), v.values.end(), init );
+template<typename T,typename U,typename A,typename T2>
+T2 reduce( const cw::list<T,U,A>& v, T2 init ) {
+	return sum_values( v.values.data(), v.values.size(), init );
+}
+
+template<typename T,typename U,typename A,typename T2,typename BinaryOp>
+T2 reduce( const sequential_policy&, const cw::list<T,U,A>& v, T2 init, BinaryOp op ) {
+	return cw::reduce( v, init, op );
+}
+
+template<typename T,typename U,typename A,typename T2,typename BinaryOp>
+T2 reduce( const parallel_policy& policy, const cw::list<T,U,A>& v, T2 init, BinaryOp op ) {
+	const T* x = v.values.data();
+	size_t N = v.values.size();
+
+	// each chunk starts from its first value, so no identity is needed
+	std::vector<T2> partial( policy.num_chunks( N ), init );
+	std::vector<char> used( partial.size(), 0 );
+	policy.for_chunks( N, [&]( size_t first, size_t last, size_t c ) {
+		if( first == last ) return;
+		T2 r = T2( x[first] );
+		for(size_t i=first+1;i<last;++i) {
+			r = op( r, x[i] );
+		}
+		partial[c] = r;
+		used[c] = 1;
+	});
+
+	for(size_t c=0;c<partial.size();++c) {
+		if( used[c] ) init = op( init, partial[c] );
+	}
+	return init;
+}
+
+template<typename T,typename U,typename A,typename T2>
+T2 reduce( const sequential_policy&, const cw::list<T,U,A>& v, T2 init ) {
+	return cw::reduce( v, init );
+}
+
+template<typename T,typename U,typename A,typename T2>
+T2 reduce_sum( const parallel_policy& policy, const cw::list<T,U,A>& v, T2 init, std::false_type ) {
+	return cw::reduce( policy, v, init, std::plus<T2>() );
+}
+
+// arithmetic sums -- each chunk is summed from zero by the kernels
+template<typename T,typename U,typename A,typename T2>
+T2 reduce_sum( const parallel_policy& policy, const cw::list<T,U,A>& v, T2 init, std::true_type ) {
+	const T* x = v.values.data();
+	std::vector<T2> partial( policy.num_chunks( v.values.size() ), T2(0) );
+	policy.for_chunks( v.values.size(), [&]( size_t first, size_t last, size_t c ) {
+		partial[c] = sum_values( x + first, last - first, T2(0) );
+	});
+	for( auto&& p : partial ) {
+		init = T2( init + p );
+	}
+	return init;
+}
+
+template<typename T,typename U,typename A,typename T2>
+T2 reduce( const parallel_policy& policy, const cw::list<T,U,A>& v, T2 init ) {
+	return reduce_sum( policy, v, init, simd_summable<T,T2>() );
+}
+
+template<typename T,typename U,typename A,typename T2,typename BinaryOp>
+T2 accumulate( const cw::list<T,U,A>& v, T2 init, BinaryOp op ) {
+	return std::accumulate( v.values.begin(), v.values.end(), init, op );
+}
+
+template<typename T,typename U,typename A,typename T2>
+T2 accumulate( const cw::list<T,U,A>& v, T2 init ) {
+	return sum_values( v.values.data(), v.values.size(), init );
+}
+
+template<typename Policy,typename T,typename U,typename A,typename T2,typename BinaryOp>
+T2 accumulate( const Policy& policy, const cw::list<T,U,A>& v, T2 init, BinaryOp op ) {
+	return cw::reduce( policy, v, init, op );
+}
+
+template<typename Policy,typename T,typename U,typename A,typename T2>
+T2 accumulate( const Policy& policy, const cw::list<T,U,A>& v, T2 init ) {
+	return cw::reduce( policy, v, init );
 }
 
-template<typename T,typename U,typename Pred>
-bool all_of( const cw::list<T,U>& v, Pred pred ) {
+// Queries
+
+template<typename T,typename U,typename A,typename Pred>
+bool all_of( const cw::list<T,U,A>& v, Pred pred ) {
 	return std::all_of( v.values.begin(), v.values.end(), pred );
 }
 
-template<typename T,typename U,typename Pred>
-bool any_of( const cw::list<T,U>& v, Pred pred ) {
+template<typename T,typename U,typename A,typename Pred>
+bool any_of( const cw::list<T,U,A>& v, Pred pred ) {
 	return std::any_of( v.values.begin(), v.values.end(), pred );
 }
 
-template<typename T,typename U,typename Pred>
-bool none_of( const cw::list<T,U>& v, Pred pred ) {
+template<typename T,typename U,typename A,typename Pred>
+bool none_of( const cw::list<T,U,A>& v, Pred pred ) {
 	return std::none_of( v.values.begin(), v.values.end(), pred );
 }
 
-template<typename T,typename U,typename T2>
-typename cw::list<T,U>::difference_type count( const cw::list<T,U>& v, const T2& val ) {
-	return std::count( v.values.begin(), v.values.end(), val );
+template<typename T,typename U,typename A,typename Pred>
+bool any_of( const sequential_policy&, const cw::list<T,U,A>& v, Pred pred ) {
+	return cw::any_of( v, pred );
+}
+
+// chunks stop early once any chunk has found a match
+template<typename T,typename U,typename A,typename Pred>
+bool any_of( const parallel_policy& policy, const cw::list<T,U,A>& v, Pred pred ) {
+	const T* x = v.values.data();
+	std::atomic<bool> found( false );
+	policy.for_chunks( v.values.size(), [&]( size_t first, size_t last, size_t ) {
+		static const size_t stride = 1024;
+		for(size_t i=first;i<last;) {
+			size_t stop = std::min( i + stride, last );
+			for( ; i<stop; ++i ) {
+				if( pred( x[i] ) ) {
+					found = true;
+					return;
+				}
+			}
+			if( found.load( std::memory_order_relaxed ) ) return;
+		}
+	});
+	return found;
+}
+
+template<typename Policy,typename T,typename U,typename A,typename Pred>
+bool all_of( const Policy& policy, const cw::list<T,U,A>& v, Pred pred ) {
+	return !cw::any_of( policy, v, [&]( const T& x ){ return !pred(x); } );
 }
 
-template<typename T,typename U,typename Pred>
-typename cw::list<T,U>::difference_type count_if( const cw::list<T,U>& v, Pred pred ) {
+template<typename Policy,typename T,typename U,typename A,typename Pred>
+bool none_of( const Policy& policy, const cw::list<T,U,A>& v, Pred pred ) {
+	return !cw::any_of( policy, v, pred );
+}
+
+template<typename T,typename U,typename A,typename T2>
+typename cw::list<T,U,A>::difference_type count( const cw::list<T,U,A>& v, const T2& val ) {
+	return typename cw::list<T,U,A>::difference_type( count_values( v.values.data(), v.values.size(), val ) );
+}
+
+template<typename T,typename U,typename A,typename Pred>
+typename cw::list<T,U,A>::difference_type count_if( const cw::list<T,U,A>& v, Pred pred ) {
 	return std::count_if( v.values.begin(), v.values.end(), pred );
 }
 
-template<typename T,typename U,typename T2>
-void fill( const cw::list<T,U>& v, const T2& val ) {
-	return std::fill( v.values.begin(), v.values.end(), val );
+template<typename T,typename U,typename A,typename Pred>
+typename cw::list<T,U,A>::difference_type count_if( const sequential_policy&, const cw::list<T,U,A>& v, Pred pred ) {
+	return cw::count_if( v, pred );
+}
+
+template<typename T,typename U,typename A,typename Pred>
+typename cw::list<T,U,A>::difference_type count_if( const parallel_policy& policy, const cw::list<T,U,A>& v, Pred pred ) {
+	using difference_type = typename cw::list<T,U,A>::difference_type;
+	const T* x = v.values.data();
+	std::vector<difference_type> partial( policy.num_chunks( v.values.size() ), 0 );
+	policy.for_chunks( v.values.size(), [&]( size_t first, size_t last, size_t c ) {
+		partial[c] = std::count_if( x + first, x + last, pred );
+	});
+	return std::accumulate( partial.begin(), partial.end(), difference_type(0) );
+}
+
+template<typename T,typename U,typename A,typename T2>
+typename cw::list<T,U,A>::difference_type count( const sequential_policy&, const cw::list<T,U,A>& v, const T2& val ) {
+	return cw::count( v, val );
+}
+
+template<typename T,typename U,typename A,typename T2>
+typename cw::list<T,U,A>::difference_type count( const parallel_policy& policy, const cw::list<T,U,A>& v, const T2& val ) {
+	using difference_type = typename cw::list<T,U,A>::difference_type;
+	const T* x = v.values.data();
+	std::vector<difference_type> partial( policy.num_chunks( v.values.size() ), 0 );
+	policy.for_chunks( v.values.size(), [&]( size_t first, size_t last, size_t c ) {
+		partial[c] = difference_type( count_values( x + first, last - first, val ) );
+	});
+	return std::accumulate( partial.begin(), partial.end(), difference_type(0) );
+}
+
+// an element equal to val -- the first in storage order -- or end()
+template<typename T,typename U,typename A,typename T2>
+typename cw::list<T,U,A>::const_iterator find( const cw::list<T,U,A>& v, const T2& val ) {
+	using index_type = typename cw::list<T,U,A>::index_type;
+	size_t i = find_values( v.values.data(), v.values.size(), val );
+	return i < v.values.size() ? typename cw::list<T,U,A>::const_iterator( &v, index_type(i) ) : v.end();
+}
+
+template<typename T,typename U,typename A,typename T2>
+typename cw::list<T,U,A>::const_iterator find( const sequential_policy&, const cw::list<T,U,A>& v, const T2& val ) {
+	return cw::find( v, val );
+}
+
+template<typename T,typename U,typename A,typename T2>
+typename cw::list<T,U,A>::const_iterator find( const parallel_policy& policy, const cw::list<T,U,A>& v, const T2& val ) {
+	using index_type = typename cw::list<T,U,A>::index_type;
+	const T* x = v.values.data();
+	size_t N = v.values.size();
+	std::vector<size_t> partial( policy.num_chunks( N ), N );
+	policy.for_chunks( N, [&]( size_t first, size_t last, size_t c ) {
+		size_t i = find_values( x + first, last - first, val );
+		if( i < last - first ) partial[c] = first + i;
+	});
+	size_t i = *std::min_element( partial.begin(), partial.end() );
+	return i < N ? typename cw::list<T,U,A>::const_iterator( &v, index_type(i) ) : v.end();
+}
+
+// Extrema -- ties are broken by storage order, not list order. For float and
+// double values with the default comparison, the result is unspecified if the
+// values contain NaN.
+
+template<typename T,typename U,typename A,typename Comp>
+typename cw::list<T,U,A>::const_iterator min_element( const cw::list<T,U,A>& v, Comp comp ) {
+	using index_type = typename cw::list<T,U,A>::index_type;
+	if( v.empty() ) return v.end();
+	size_t i = extreme_index( v.values.data(), v.values.size(), comp );
+	return typename cw::list<T,U,A>::const_iterator( &v, index_type(i) );
+}
+
+template<typename T,typename U,typename A>
+typename cw::list<T,U,A>::const_iterator min_element( const cw::list<T,U,A>& v ) {
+	return cw::min_element( v, std::less<T>() );
+}
+
+template<typename T,typename U,typename A,typename Comp>
+typename cw::list<T,U,A>::const_iterator min_element( const sequential_policy&, const cw::list<T,U,A>& v, Comp comp ) {
+	return cw::min_element( v, comp );
+}
+
+template<typename T,typename U,typename A,typename Comp>
+typename cw::list<T,U,A>::const_iterator min_element( const parallel_policy& policy, const cw::list<T,U,A>& v, Comp comp ) {
+	using index_type = typename cw::list<T,U,A>::index_type;
+	if( v.empty() ) return v.end();
+	const T* x = v.values.data();
+	std::vector<size_t> partial( policy.num_chunks( v.values.size() ), 0 );
+	std::vector<char> used( partial.size(), 0 );
+	policy.for_chunks( v.values.size(), [&]( size_t first, size_t last, size_t c ) {
+		if( first == last ) return;
+		partial[c] = first + extreme_index( x + first, last - first, comp );
+		used[c] = 1;
+	});
+
+	size_t best = partial[0];
+	for(size_t c=1;c<partial.size();++c) {
+		if( used[c] && comp( x[ partial[c] ], x[best] ) ) best = partial[c];
+	}
+	return typename cw::list<T,U,A>::const_iterator( &v, index_type(best) );
+}
+
+template<typename Policy,typename T,typename U,typename A>
+typename cw::list<T,U,A>::const_iterator min_element( const Policy& policy, const cw::list<T,U,A>& v ) {
+	return cw::min_element( policy, v, std::less<T>() );
+}
+
+// the first maximum in storage order, as std::max_element
+template<typename Policy,typename T,typename U,typename A,typename Comp>
+typename cw::list<T,U,A>::const_iterator max_element( const Policy& policy, const cw::list<T,U,A>& v, Comp comp ) {
+	return cw::min_element( policy, v, [&]( const T& x, const T& y ){ return comp( y, x ); } );
+}
+
+template<typename Policy,typename T,typename U,typename A>
+typename cw::list<T,U,A>::const_iterator max_element( const Policy& policy, const cw::list<T,U,A>& v ) {
+	return cw::min_element( policy, v, std::greater<T>() );
+}
+
+template<typename T,typename U,typename A,typename Comp>
+typename cw::list<T,U,A>::const_iterator max_element( const cw::list<T,U,A>& v, Comp comp ) {
+	return cw::max_element( seq, v, comp );
 }
 
-template<typename T,typename U,typename T2>
-void replace( const cw::list<T,U>& v, const T2& old_val, const T2& new_val ) {
-	return std::replace( v.values.begin(), v.values.end(), old_val, new_val );
+template<typename T,typename U,typename A>
+typename cw::list<T,U,A>::const_iterator max_element( const cw::list<T,U,A>& v ) {
+	return cw::min_element( v, std::greater<T>() );
 }
 
-template<typename T,typename U,typename Pred,typename T2>
-void replace_if( const cw::list<T,U>& v, Pred pred, const T2& new_val ) {
-	return std::replace_if( v.values.begin(), v.values.end(), pred, new_val );
+// Modifiers
+
+template<typename T,typename U,typename A,typename F>
+F for_each( cw::list<T,U,A>& v, F f ) {
+	return std::for_each( v.values.begin(), v.values.end(), f );
+}
+
+template<typename T,typename U,typename A,typename F>
+void for_each( const sequential_policy&, cw::list<T,U,A>& v, F f ) {
+	cw::for_each( v, f );
+}
+
+// f is copied to each chunk
+template<typename T,typename U,typename A,typename F>
+void for_each( const parallel_policy& policy, cw::list<T,U,A>& v, F f ) {
+	T* x = v.values.data();
+	policy.for_chunks( v.values.size(), [&]( size_t first, size_t last, size_t ) {
+		std::for_each( x + first, x + last, f );
+	});
+}
+
+// replaces each value x with op(x)
+template<typename T,typename U,typename A,typename UnaryOp>
+void transform( cw::list<T,U,A>& v, UnaryOp op ) {
+	std::transform( v.values.begin(), v.values.end(), v.values.begin(), op );
+}
+
+template<typename Policy,typename T,typename U,typename A,typename UnaryOp>
+void transform( const Policy& policy, cw::list<T,U,A>& v, UnaryOp op ) {
+	cw::for_each( policy, v, [&]( T& x ){ x = op(x); } );
+}
+
+template<typename T,typename U,typename A,typename T2>
+void fill( cw::list<T,U,A>& v, const T2& val ) {
+	std::fill( v.values.begin(), v.values.end(), val );
+}
+
+template<typename Policy,typename T,typename U,typename A,typename T2>
+void fill( const Policy& policy, cw::list<T,U,A>& v, const T2& val ) {
+	cw::for_each( policy, v, [&]( T& x ){ x = val; } );
+}
+
+template<typename T,typename U,typename A,typename T2>
+void replace( cw::list<T,U,A>& v, const T2& old_val, const T2& new_val ) {
+	replace_values( v.values.data(), v.values.size(), old_val, new_val );
+}
+
+template<typename T,typename U,typename A,typename T2>
+void replace( const sequential_policy&, cw::list<T,U,A>& v, const T2& old_val, const T2& new_val ) {
+	cw::replace( v, old_val, new_val );
+}
+
+template<typename T,typename U,typename A,typename T2>
+void replace( const parallel_policy& policy, cw::list<T,U,A>& v, const T2& old_val, const T2& new_val ) {
+	T* x = v.values.data();
+	policy.for_chunks( v.values.size(), [&]( size_t first, size_t last, size_t ) {
+		replace_values( x + first, last - first, old_val, new_val );
+	});
+}
+
+template<typename T,typename U,typename A,typename Pred,typename T2>
+void replace_if( cw::list<T,U,A>& v, Pred pred, const T2& new_val ) {
+	std::replace_if( v.values.begin(), v.values.end(), pred, new_val );
+}
+
+template<typename Policy,typename T,typename U,typename A,typename Pred,typename T2>
+void replace_if( const Policy& policy, cw::list<T,U,A>& v, Pred pred, const T2& new_val ) {
+	cw::for_each( policy, v, [&]( T& x ){ if( pred(x) ) x = new_val; } );
+}
+
+// Ordered traversal
+
+// for_each_ordered( v, f, distance ) calls f on each value in list order, as
+// std::for_each over the iterators does, for any erase policy and storage layout.
+//
+// Following the links is a chain of dependent loads, which prefetching further
+// along the same chain cannot shorten. A fragmented list is instead cut at evenly
+// spaced slots into 4 * distance segments, which are walked in lockstep so their
+// misses overlap. The values are then visited segment by segment, prefetched
+// distance elements ahead. This takes O(N) index_type of scratch space.
+//
+// A linear list is visited in storage order. A list whose sampled links mostly
+// stay within a page is walked directly, as the hardware prefetcher already
+// covers it. A distance of 0 always walks directly.
+
+// samples the links from the head -- fragmented if most hops leave the page
+template<typename L>
+bool fragmented_links( const L& v ) {
+	using I = typename L::index_type;
+	const size_t page = std::max( size_t(4096) / ( 2 * sizeof(typename L::link_type) ), size_t(1) );
+	size_t hops = 0, far = 0;
+	for( I i = v.head; i != v.terminator && hops < 64; ++hops ) {
+		I next = v.next_link(i);
+		if( next != v.terminator && size_t( next > i ? next - i : i - next ) >= page ) {
+			++far;
+		}
+		i = next;
+	}
+	return 2 * far > hops;
+}
+
+template<typename L,typename Value,typename F>
+void for_each_segmented( const L& v, Value value, F& f, size_t distance ) {
+	using I = typename L::index_type;
+	const I t = v.terminator;
+	size_t M = v.slots();
+	size_t K = std::min( 4 * distance, M );
+
+	// segments start at the head and at evenly spaced live slots
+	std::vector<bool> start( M );
+	std::vector<I> cur( 1, v.head );
+	start[ v.head ] = true;
+	for(size_t k=1;k<K;++k) {
+		I s = I( k * M / K );
+		if( !start[s] && !v.is_free(s) ) {
+			start[s] = true;
+			cur.push_back(s);
+		}
+	}
+
+	// walk every segment one hop at a time, until it reaches the start of another
+	size_t S = cur.size();
+	std::vector<std::vector<I>> segments( S );
+	std::vector<I> follow( S, t );
+	std::vector<size_t> active( S );
+	for(size_t j=0;j<S;++j) {
+		segments[j].reserve( 2 * M / S );
+		active[j] = j;
+	}
+	while( !active.empty() ) {
+		size_t live = 0;
+		for( auto j : active ) {
+			I i = cur[j];
+			segments[j].push_back(i);
+			I next = v.next_link(i);
+			if( next == t || start[next] ) {
+				follow[j] = next;
+			} else {
+				cur[j] = next;
+				active[ live++ ] = j;
+			}
+		}
+		active.resize( live );
+	}
+
+	// visit the segments in list order, starting from the head's
+	std::vector<std::pair<I,size_t>> firsts( S );
+	for(size_t j=0;j<S;++j) {
+		firsts[j] = { segments[j].front(), j };
+	}
+	std::sort( firsts.begin(), firsts.end() );
+	for( size_t j = 0;; ) {
+		const auto& segment = segments[j];
+		size_t n = segment.size();
+		for(size_t k=0;k<n;++k) {
+			if( k + distance < n ) {
+				simd::prefetch( &value( segment[ k + distance ] ) );
+			}
+			f( value( segment[k] ) );
+		}
+		if( follow[j] == t ) break;
+		j = std::lower_bound( firsts.begin(), firsts.end(), std::make_pair( follow[j], size_t(0) ) )->second;
+	}
+}
+
+// value(i) is the value in slot i
+template<typename L,typename Value,typename F>
+void for_each_ordered_values( const L& v, Value value, F& f, size_t distance ) {
+	using I = typename L::index_type;
+	if( v.empty() ) return;
+	if( v.linear() ) {
+		for( I i = 0, last = I( v.size() ); i != last; ++i ) {
+			f( value(i) );
+		}
+	} else if( distance == 0 || !fragmented_links(v) ) {
+		for( I i = v.head; i != v.terminator; i = v.next_link(i) ) {
+			f( value(i) );
+		}
+	} else {
+		for_each_segmented( v, value, f, distance );
+	}
+}
+
+template<typename T,typename U,typename A,typename E,typename L,typename F>
+F for_each_ordered( cw::list<T,U,A,E,L>& v, F f, size_t distance = 16 ) {
+	for_each_ordered_values( v, [&v]( U i ) -> T& { return v.slot_value(i); }, f, distance );
+	return f;
+}
+
+template<typename T,typename U,typename A,typename E,typename L,typename F>
+F for_each_ordered( const cw::list<T,U,A,E,L>& v, F f, size_t distance = 16 ) {
+	for_each_ordered_values( v, [&v]( U i ) -> const T& { return v.slot_value(i); }, f, distance );
+	return f;
 }
 
 }
@@ -67,12 +689,12 @@ namespace std {
 // This will effectively swap any iterators pointing to the two elements,
 // which causes problems in algorithms not expecting it.
 
-template<typename T,typename U>
-void iter_swap( cw::list_iterator<T,U>& lhs, cw::list_iterator<T,U>& rhs ) {
+template<typename L>
+void iter_swap( cw::list_iterator<L>& lhs, cw::list_iterator<L>& rhs ) {
 	lhs.iter_swap(rhs);
 }
 */
-	
+
 }
 
 
@@ -0,0 +1,350 @@
+#ifndef INCLUDED_CW_LIST_IO
+#define INCLUDED_CW_LIST_IO
+#include <cstdint>
+#include <cstring>
+#include <algorithm>
+#include <vector>
+#include <istream>
+#include <ostream>
+#include <exception>
+#include <limits>
+#include <type_traits>
+#include "list.h"
+
+namespace cw {
+
+// Binary save and load of a list. These take only the default erase_swap
+// policy, whose storage has no free slots.
+//
+// A file is a header, then the values, then, for a file in storage order, the
+// nodes {prev,next} with links of the list's index width. A file in list order
+// omits the nodes, and loads as a straight chain. A linear list is the same in
+// either order, so it is always written without nodes.
+//
+// A trivially copyable T is written as raw bytes. The values and the SoA nodes
+// are read and written in place, in one call each; the other layouts go
+// through a buffer of a bounded number of slots. Any other T is written by a
+// codec, one value at a time and in list order:
+//
+//     struct codec {
+//         void write( std::ostream& out, const T& x );
+//         T read( std::istream& in );
+//     };
+//
+// The files are only readable on a machine with the same byte order.
+
+enum class save_order { storage, list };
+
+struct list_file_header {
+	char magic[8];
+	uint32_t value_size;          // sizeof(T), or 0 for values written by a codec
+	uint32_t index_size;          // sizeof(U), or 0 if no nodes follow the values
+	uint64_t count;
+	uint64_t head, tail;          // all ones for the terminator
+	uint64_t scattered;           // informational -- load() counts it from the links
+};
+
+// the slots passed through a buffer at a time, by the layouts that aren't read in place
+static const size_t list_io_chunk = 1 << 12;
+
+inline void write_bytes( std::ostream& out, const void* p, size_t n ) {
+	if( !out.write( static_cast<const char*>(p), std::streamsize(n) ) ) {
+		throw std::exception("cw::save() -- write failed");
+	}
+}
+
+inline void read_bytes( std::istream& in, void* p, size_t n ) {
+	if( !in.read( static_cast<char*>(p), std::streamsize(n) ) ) {
+		throw std::exception("cw::load() -- unexpected end of file");
+	}
+}
+
+inline list_file_header make_list_header( uint64_t value_size, uint64_t index_size, uint64_t count ) {
+	list_file_header h;
+	std::memset( &h, 0, sizeof(h) );
+	std::memcpy( h.magic, "cwlfile\0", 8 );
+	h.value_size = uint32_t(value_size);
+	h.index_size = uint32_t(index_size);
+	h.count = count;
+	h.head = count > 0 ? 0 : std::numeric_limits<uint64_t>::max();
+	h.tail = count > 0 ? count - 1 : std::numeric_limits<uint64_t>::max();
+	h.scattered = 0;
+	return h;
+}
+
+inline list_file_header read_list_header( std::istream& in ) {
+	list_file_header h;
+	read_bytes( in, &h, sizeof(h) );
+	if( std::memcmp( h.magic, "cwlfile\0", 8 ) != 0 ) {
+		throw std::exception("cw::load() -- not a list file");
+	}
+	return h;
+}
+
+// Values
+
+// contiguous layouts -- the values in storage order straight from the vector
+
+template<typename List>
+void write_values( std::ostream& out, const List& l, std::true_type ) {
+	write_bytes( out, l.data(), l.size() * sizeof(typename List::value_type) );
+}
+
+template<typename List>
+void write_values( std::ostream& out, const List& l, std::false_type ) {
+	using T = typename List::value_type;
+	using I = typename List::index_type;
+	std::vector<T> buffer;
+	buffer.reserve( std::min( l.size(), list_io_chunk ) );
+	for(size_t i=0;i<l.size();) {
+		buffer.clear();
+		for( ; i < l.size() && buffer.size() < list_io_chunk; ++i ) {
+			buffer.push_back( l.slot_value( I(i) ) );
+		}
+		write_bytes( out, buffer.data(), buffer.size() * sizeof(T) );
+	}
+}
+
+// the values in list order, a chunk at a time
+template<typename List>
+void write_values_in_order( std::ostream& out, const List& l ) {
+	using T = typename List::value_type;
+	std::vector<T> buffer;
+	buffer.reserve( std::min( l.size(), list_io_chunk ) );
+	for( auto it = l.begin(); it != l.end(); ) {
+		buffer.clear();
+		for( ; it != l.end() && buffer.size() < list_io_chunk; ++it ) {
+			buffer.push_back( *it );
+		}
+		write_bytes( out, buffer.data(), buffer.size() * sizeof(T) );
+	}
+}
+
+// Nodes
+
+// SoA -- the nodes in place
+template<typename List>
+void write_nodes( std::ostream& out, const List& l, layout_soa ) {
+	write_bytes( out, l.nodes.data(), l.size() * sizeof(typename List::storage_type::node) );
+}
+
+template<typename List,typename Layout>
+void write_nodes( std::ostream& out, const List& l, Layout ) {
+	using I = typename List::index_type;
+	using node = list_node<typename List::link_type>;
+	std::vector<node> buffer;
+	buffer.reserve( std::min( l.size(), list_io_chunk ) );
+	for(size_t i=0;i<l.size();) {
+		buffer.clear();
+		for( ; i < l.size() && buffer.size() < list_io_chunk; ++i ) {
+			node n;
+			n.prev = l.prev_link( I(i) );
+			n.next = l.next_link( I(i) );
+			buffer.push_back( n );
+		}
+		write_bytes( out, buffer.data(), buffer.size() * sizeof(node) );
+	}
+}
+
+// a link read from a file must be an element or the terminator. a bad one
+// leaves l empty, as its links are already part overwritten.
+template<typename List>
+void check_link( List& l, typename List::index_type link ) {
+	if( link >= l.size() && link != List::terminator ) {
+		l.clear();
+		throw std::exception("cw::load() -- link out of range");
+	}
+}
+
+template<typename List>
+void read_nodes( std::istream& in, List& l, layout_soa ) {
+	using I = typename List::index_type;
+	read_bytes( in, l.nodes.data(), l.size() * sizeof(typename List::storage_type::node) );
+	for(size_t i=0;i<l.size();++i) {
+		check_link( l, I( l.nodes[i].prev ) );
+		check_link( l, I( l.nodes[i].next ) );
+	}
+}
+
+template<typename List,typename Layout>
+void read_nodes( std::istream& in, List& l, Layout ) {
+	using I = typename List::index_type;
+	using node = list_node<typename List::link_type>;
+	std::vector<node> buffer( std::min( l.size(), list_io_chunk ) );
+	for(size_t i=0;i<l.size();) {
+		size_t n = std::min( l.size() - i, list_io_chunk );
+		read_bytes( in, buffer.data(), n * sizeof(node) );
+		for(size_t j=0;j<n;++j,++i) {
+			check_link( l, I( buffer[j].prev ) );
+			check_link( l, I( buffer[j].next ) );
+			l.set_links( I(i), buffer[j].prev, buffer[j].next );
+		}
+	}
+}
+
+// Walk the chain from head -- it must reach tail in exactly size() steps, each
+// element's prev link naming the one before. This rules out cycles and
+// elements reached twice. Returns the number of elements out of their storage
+// place, the scattered count, which is 0 only for a straight chain. A bad chain
+// leaves l empty.
+template<typename List>
+size_t check_chain( List& l ) {
+	using I = typename List::index_type;
+	size_t out_of_place = 0;
+	I prev = List::terminator;
+	I i = l.head;
+	for(size_t n=0;n<l.size();++n) {
+		if( i == List::terminator || I( l.prev_link(i) ) != prev ) {
+			l.clear();
+			throw std::exception("cw::load() -- links don't form a chain");
+		}
+		if( i != I(n) ) {
+			++out_of_place;
+		}
+		prev = i;
+		i = I( l.next_link(i) );
+	}
+	if( i != List::terminator || prev != l.tail ) {
+		l.clear();
+		throw std::exception("cw::load() -- links don't form a chain");
+	}
+	return out_of_place;
+}
+
+// Save
+
+// Write l to out, in storage order with its nodes, or in list order without.
+template<typename T,typename U,typename A,typename L>
+void save( std::ostream& out, const list<T,U,A,erase_swap,L>& l, save_order order = save_order::storage ) {
+	using list_type = list<T,U,A,erase_swap,L>;
+	static_assert( std::is_trivially_copyable<T>::value, "cw::save() -- a value type that isn't trivially copyable needs a codec" );
+
+	bool links = order == save_order::storage && !l.linear();
+	list_file_header h = make_list_header( sizeof(T), links ? sizeof(U) : 0, l.size() );
+	if( links ) {
+		h.head = l.head;
+		h.tail = l.tail;
+		h.scattered = l.scattered;
+	}
+	write_bytes( out, &h, sizeof(h) );
+
+	if( links || l.linear() ) {
+		write_values( out, l, std::integral_constant<bool,list_type::contiguous>() );
+	} else {
+		write_values_in_order( out, l );
+	}
+	if( links ) {
+		write_nodes( out, l, typename list_type::layout_policy() );
+	}
+}
+
+// Write l to out in list order, each value by codec.write( out, x ).
+template<typename T,typename U,typename A,typename L,typename Codec,typename = typename std::enable_if<!std::is_same<typename std::decay<Codec>::type,save_order>::value>::type>
+void save( std::ostream& out, const list<T,U,A,erase_swap,L>& l, Codec&& codec ) {
+	list_file_header h = make_list_header( 0, 0, l.size() );
+	write_bytes( out, &h, sizeof(h) );
+	for( const auto& x : l ) {
+		codec.write( out, x );
+	}
+	if( !out ) {
+		throw std::exception("cw::save() -- write failed");
+	}
+}
+
+// Load
+
+// Replace the elements of l with those saved in a file. The values, and the
+// SoA nodes, are each read in one call. The nodes must form one chain from
+// head to tail, or load() throws and leaves l empty. O(N).
+template<typename T,typename U,typename A,typename L>
+void load( std::istream& in, list<T,U,A,erase_swap,L>& l ) {
+	using list_type = list<T,U,A,erase_swap,L>;
+	using values_type = typename list_type::values_type;
+	using index_type = typename list_type::index_type;
+	static_assert( std::is_trivially_copyable<T>::value, "cw::load() -- a value type that isn't trivially copyable needs a codec" );
+
+	list_file_header h = read_list_header( in );
+	if( h.value_size != sizeof(T) ) {
+		throw std::exception("cw::load() -- file has a different value type");
+	}
+	if( h.index_size != 0 && h.index_size != sizeof(U) ) {
+		throw std::exception("cw::load() -- file has a different index type");
+	}
+	if( h.count > l.max_size() ) {
+		throw std::exception("cw::load() -- size too big for index_type");
+	}
+	const uint64_t none = std::numeric_limits<uint64_t>::max();
+	if( h.index_size != 0 && !( h.count > 0 ? h.head < h.count && h.tail < h.count : h.head == none && h.tail == none ) ) {
+		throw std::exception("cw::load() -- head or tail out of range");
+	}
+
+	values_type values( typename values_type::allocator_type( l.get_allocator() ) );
+	values.resize( size_t(h.count) );
+	read_bytes( in, values.data(), values.size() * sizeof(T) );
+
+	// a straight chain, which the nodes of a file in storage order then replace
+	l = std::move( values );
+	if( h.index_size != 0 ) {
+		read_nodes( in, l, typename list_type::layout_policy() );
+		l.head = index_type( h.head );
+		l.tail = index_type( h.tail );
+		l.scattered = check_chain( l );
+		if( l.positions_indexed() ) {
+			l.index_positions( true );
+		}
+	}
+}
+
+// Replace the elements of l with those saved by a codec, each value by codec.read( in ).
+template<typename T,typename U,typename A,typename L,typename Codec>
+void load( std::istream& in, list<T,U,A,erase_swap,L>& l, Codec&& codec ) {
+	using values_type = typename list<T,U,A,erase_swap,L>::values_type;
+
+	list_file_header h = read_list_header( in );
+	if( h.value_size != 0 ) {
+		throw std::exception("cw::load() -- file was not written by a codec");
+	}
+	if( h.count > l.max_size() ) {
+		throw std::exception("cw::load() -- size too big for index_type");
+	}
+
+	values_type values( typename values_type::allocator_type( l.get_allocator() ) );
+	values.reserve( size_t(h.count) );
+	for(uint64_t i=0;i<h.count;++i) {
+		values.push_back( codec.read( in ) );
+	}
+	if( !in ) {
+		throw std::exception("cw::load() -- unexpected end of file");
+	}
+	l = std::move( values );
+}
+
+// Streaming -- call f( first, last ) on the values of a file of T, chunk at a
+// time, without building a list. Memory is bounded by the chunk. The values
+// come in the order of the file, which is list order unless it has nodes.
+// Returns the number of values.
+template<typename T,typename F>
+size_t load_chunks( std::istream& in, F f, size_t chunk = 1 << 16 ) {
+	static_assert( std::is_trivially_copyable<T>::value, "cw::load_chunks() -- the value type must be trivially copyable" );
+
+	list_file_header h = read_list_header( in );
+	if( h.value_size != sizeof(T) ) {
+		throw std::exception("cw::load_chunks() -- file has a different value type");
+	}
+	std::vector<T> buffer( size_t( std::min<uint64_t>( h.count, std::max<size_t>( chunk, 1 ) ) ) );
+	for(uint64_t i=0;i<h.count;) {
+		size_t n = size_t( std::min<uint64_t>( h.count - i, buffer.size() ) );
+		read_bytes( in, buffer.data(), n * sizeof(T) );
+		f( static_cast<const T*>( buffer.data() ), static_cast<const T*>( buffer.data() + n ) );
+		i += n;
+	}
+	// step over the nodes
+	if( h.index_size != 0 ) {
+		in.ignore( std::streamsize( h.count * 2 * h.index_size ) );
+	}
+	return size_t( h.count );
+}
+
+}
+
+#endif
@@ -0,0 +1,760 @@
+#ifndef INCLUDED_CW_MAPPED_LIST
+#define INCLUDED_CW_MAPPED_LIST
+#include <cstdint>
+#include <cstring>
+#include <algorithm>
+#include <string>
+#include <vector>
+#include <utility>
+#include <stdexcept>
+#include <limits>
+#include <iterator>
+#include <type_traits>
+
+#ifdef _WIN32
+#include <Windows.h>
+
+#ifdef max
+#undef max
+#endif
+
+#ifdef min
+#undef min
+#endif
+
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#if _MSC_VER <= 1800
+#define noexcept throw()
+#endif
+
+namespace cw {
+
+// A file mapped read-write into memory, which can be resized in place.
+struct mapped_file {
+	unsigned char* data = nullptr;
+	size_t size = 0;
+
+#ifdef _WIN32
+	HANDLE file = INVALID_HANDLE_VALUE;
+	HANDLE mapping = nullptr;
+#else
+	int fd = -1;
+#endif
+
+	mapped_file() = default;
+
+	// open the file at path, creating it empty if it doesn't exist
+	explicit mapped_file( const char* path ) {
+#ifdef _WIN32
+		file = ::CreateFileA( path, GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ, nullptr, OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr );
+		if( file == INVALID_HANDLE_VALUE ) {
+			throw std::runtime_error("cw::mapped_file -- cannot open file");
+		}
+		LARGE_INTEGER bytes;
+		if( !::GetFileSizeEx( file, &bytes ) ) {
+			close();
+			throw std::runtime_error("cw::mapped_file -- cannot read file size");
+		}
+		size = size_t( bytes.QuadPart );
+#else
+		fd = ::open( path, O_RDWR | O_CREAT, 0644 );
+		if( fd < 0 ) {
+			throw std::runtime_error("cw::mapped_file -- cannot open file");
+		}
+		struct stat st;
+		if( ::fstat( fd, &st ) != 0 ) {
+			close();
+			throw std::runtime_error("cw::mapped_file -- cannot read file size");
+		}
+		size = size_t( st.st_size );
+#endif
+		if( size > 0 ) {
+			map();
+		}
+	}
+
+	mapped_file( mapped_file&& rhs ) noexcept {
+		swap( rhs );
+	}
+
+	mapped_file& operator=( mapped_file&& rhs ) noexcept {
+		swap( rhs );
+		return *this;
+	}
+
+	mapped_file( const mapped_file& ) = delete;
+
+	mapped_file& operator=( const mapped_file& ) = delete;
+
+	~mapped_file() {
+		close();
+	}
+
+	bool is_open() const noexcept {
+#ifdef _WIN32
+		return file != INVALID_HANDLE_VALUE;
+#else
+		return fd >= 0;
+#endif
+	}
+
+	// set the length of the file to n bytes and map all of it. the data may move.
+	void resize( size_t n ) {
+#ifdef _WIN32
+		// a file can't change length while a view of it is open
+		unmap();
+		LARGE_INTEGER bytes;
+		bytes.QuadPart = LONGLONG(n);
+		if( !::SetFilePointerEx( file, bytes, nullptr, FILE_BEGIN ) || !::SetEndOfFile( file ) ) {
+			throw std::runtime_error("cw::mapped_file::resize() -- cannot set file size");
+		}
+		size = n;
+		map();
+#else
+		if( ::ftruncate( fd, off_t(n) ) != 0 ) {
+			throw std::runtime_error("cw::mapped_file::resize() -- cannot set file size");
+		}
+#ifdef __linux__
+		if( data ) {
+			void* p = ::mremap( data, size, n, MREMAP_MAYMOVE );
+			if( p == MAP_FAILED ) {
+				data = nullptr;
+				size = 0;
+				throw std::runtime_error("cw::mapped_file::resize() -- cannot map file");
+			}
+			data = static_cast<unsigned char*>(p);
+			size = n;
+			return;
+		}
+#endif
+		unmap();
+		size = n;
+		map();
+#endif
+	}
+
+	// write the dirty pages of the mapping and the file metadata to disk
+	void sync() {
+		if( !data ) return;
+#ifdef _WIN32
+		if( !::FlushViewOfFile( data, 0 ) || !::FlushFileBuffers( file ) ) {
+			throw std::runtime_error("cw::mapped_file::sync() -- cannot flush file");
+		}
+#else
+		if( ::msync( data, size, MS_SYNC ) != 0 || ::fsync( fd ) != 0 ) {
+			throw std::runtime_error("cw::mapped_file::sync() -- cannot flush file");
+		}
+#endif
+	}
+
+	void close() noexcept {
+		unmap();
+#ifdef _WIN32
+		if( file != INVALID_HANDLE_VALUE ) {
+			::CloseHandle( file );
+			file = INVALID_HANDLE_VALUE;
+		}
+#else
+		if( fd >= 0 ) {
+			::close( fd );
+			fd = -1;
+		}
+#endif
+		size = 0;
+	}
+
+	void swap( mapped_file& rhs ) noexcept {
+		std::swap( data, rhs.data );
+		std::swap( size, rhs.size );
+#ifdef _WIN32
+		std::swap( file, rhs.file );
+		std::swap( mapping, rhs.mapping );
+#else
+		std::swap( fd, rhs.fd );
+#endif
+	}
+
+protected:
+
+	void map() {
+#ifdef _WIN32
+		mapping = ::CreateFileMappingA( file, nullptr, PAGE_READWRITE, DWORD( uint64_t(size) >> 32 ), DWORD( size ), nullptr );
+		if( !mapping ) {
+			throw std::runtime_error("cw::mapped_file -- cannot map file");
+		}
+		data = static_cast<unsigned char*>( ::MapViewOfFile( mapping, FILE_MAP_ALL_ACCESS, 0, 0, size ) );
+		if( !data ) {
+			::CloseHandle( mapping );
+			mapping = nullptr;
+			throw std::runtime_error("cw::mapped_file -- cannot map file");
+		}
+#else
+		void* p = ::mmap( nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0 );
+		if( p == MAP_FAILED ) {
+			throw std::runtime_error("cw::mapped_file -- cannot map file");
+		}
+		data = static_cast<unsigned char*>(p);
+#endif
+	}
+
+	void unmap() noexcept {
+#ifdef _WIN32
+		if( data ) {
+			::UnmapViewOfFile( data );
+		}
+		if( mapping ) {
+			::CloseHandle( mapping );
+			mapping = nullptr;
+		}
+#else
+		if( data ) {
+			::munmap( data, size );
+		}
+#endif
+		data = nullptr;
+	}
+};
+
+// A doubly linked list whose storage is a memory-mapped file. The links are
+// indices, so the values and nodes mean the same wherever the file is mapped,
+// and a list is reopened where it was left without reading or rebuilding it.
+//
+// The file holds a header, then capacity() values, then capacity() nodes
+// {prev,next}. Opening maps the file and checks the header, so it costs the
+// same at any size and the pages are read in as they are first touched.
+// Growing extends the file, remaps it and moves the nodes up past the new
+// values. Changes reach the file as the OS writes back the pages; sync()
+// flushes them to disk.
+//
+// As cw::list, erasure moves the element at the back of the storage into the
+// erased slot, so the storage stays dense. T must be trivially copyable, and
+// the file is only readable on a machine with the same byte order.
+
+struct mapped_list_header {
+	char magic[8];
+	uint32_t value_size;
+	uint32_t index_size;
+	uint64_t capacity;
+	uint64_t count;
+	uint64_t head, tail;
+	unsigned char padding[16];
+};
+
+template<typename U>
+struct mapped_list_node {
+	U prev, next;
+};
+
+template<typename L,bool is_const>
+struct mapped_list_iterator {
+	using value_type             = typename L::value_type;
+	using index_type             = typename L::index_type;
+	using size_type              = size_t;
+	using difference_type        = std::ptrdiff_t;
+	using reference              = typename std::conditional<is_const,const value_type&,value_type&>::type;
+	using pointer                = typename std::conditional<is_const,const value_type*,value_type*>::type;
+	using iterator_category      = std::bidirectional_iterator_tag;
+	using list_type              = typename std::conditional<is_const,const L,L>::type;
+
+	mapped_list_iterator() = default;
+
+	mapped_list_iterator( list_type* p, index_type index ) : p(p), index(index) {}
+
+	// iterator to const_iterator
+	template<bool rhs_const,typename = typename std::enable_if<is_const && !rhs_const>::type>
+	mapped_list_iterator( const mapped_list_iterator<L,rhs_const>& it ) : p(it.p), index(it.index) {}
+
+	reference operator*() const {
+		return p->values[index];
+	}
+
+	pointer operator->() const {
+		return &p->values[index];
+	}
+
+	mapped_list_iterator& operator++() {
+		index = p->next_index(index);
+		return *this;
+	}
+
+	mapped_list_iterator& operator--() {
+		index = p->prev_index(index);
+		return *this;
+	}
+
+	mapped_list_iterator operator++(int) {
+		auto old = *this;
+		++(*this);
+		return old;
+	}
+
+	mapped_list_iterator operator--(int) {
+		auto old = *this;
+		--(*this);
+		return old;
+	}
+
+	bool operator==( const mapped_list_iterator& rhs ) const {
+		return (p == rhs.p) && (index == rhs.index);
+	}
+
+	bool operator!=( const mapped_list_iterator& rhs ) const {
+		return !( *this == rhs );
+	}
+
+	list_type* p;
+	index_type index;
+};
+
+// T -- the value type, trivially copyable
+// U -- the index type, an unsigned integer type
+template<typename T,typename U = uint32_t>
+struct mapped_list {
+	using value_type             = T;
+	using index_type             = U;
+	using size_type              = size_t;
+	using difference_type        = std::ptrdiff_t;
+	using reference              = T&;
+	using const_reference        = const T&;
+	using pointer                = T*;
+	using const_pointer          = const T*;
+	using list_type              = mapped_list<T,U>;
+	using iterator               = mapped_list_iterator<list_type,false>;
+	using const_iterator         = mapped_list_iterator<list_type,true>;
+	using reverse_iterator       = std::reverse_iterator<iterator>;
+	using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+	using node_type              = mapped_list_node<U>;
+	using header_type            = mapped_list_header;
+
+	static_assert( std::is_trivially_copyable<T>::value, "cw::mapped_list -- the value type must be trivially copyable" );
+	static_assert( std::is_unsigned<U>::value, "cw::mapped_list -- the index type must be an unsigned integer type" );
+	static_assert( alignof(T) <= sizeof(header_type), "cw::mapped_list -- the value type is aligned beyond the header" );
+
+	// SFINAE guard for the iterator-pair overloads
+	template<typename It>
+	using is_input_iterator = typename std::enable_if<std::is_convertible<typename std::iterator_traits<It>::iterator_category,std::input_iterator_tag>::value>::type;
+
+	static const index_type terminator = index_type(-1);
+
+	mapped_file file;
+
+	// into the mapping, refreshed whenever it moves
+	header_type* header = nullptr;
+	T* values = nullptr;
+	node_type* nodes = nullptr;
+
+	// open the list stored at path, or create an empty one there.
+	// throws if the file holds something other than a list of T and U.
+	explicit mapped_list( const char* path ) : file( path ) {
+		if( file.size == 0 ) {
+			file.resize( sizeof(header_type) );
+			refresh();
+			std::memset( header, 0, sizeof(header_type) );
+			std::memcpy( header->magic, "cwlist\0\0", 8 );
+			header->value_size = uint32_t( sizeof(T) );
+			header->index_size = uint32_t( sizeof(U) );
+			header->head = header->tail = terminator;
+			return;
+		}
+		if( file.size < sizeof(header_type) ) {
+			throw std::runtime_error("cw::mapped_list -- file is not a list");
+		}
+		refresh();
+		if( std::memcmp( header->magic, "cwlist\0\0", 8 ) != 0 ||
+		    header->value_size != sizeof(T) ||
+		    header->index_size != sizeof(U) ) {
+			throw std::runtime_error("cw::mapped_list -- file is not a list of this value and index type");
+		}
+		if( header->count > header->capacity || file.size < file_size( size_type( header->capacity ) ) ) {
+			throw std::runtime_error("cw::mapped_list -- file is truncated");
+		}
+	}
+
+	explicit mapped_list( const std::string& path ) : mapped_list( path.c_str() ) {}
+
+	mapped_list( mapped_list&& rhs ) noexcept {
+		swap( rhs );
+	}
+
+	mapped_list& operator=( mapped_list&& rhs ) noexcept {
+		swap( rhs );
+		return *this;
+	}
+
+	mapped_list( const mapped_list& ) = delete;
+
+	mapped_list& operator=( const mapped_list& ) = delete;
+
+	// Assignment
+
+	template<typename InputIt,typename = is_input_iterator<InputIt>>
+	void assign( InputIt first, InputIt last ) {
+		clear();
+		for( ; first != last; ++first ) {
+			push_back( *first );
+		}
+	}
+
+	void assign( const std::initializer_list<T>& rhs ) {
+		assign( std::begin(rhs), std::end(rhs) );
+	}
+
+	// Element Access
+
+	value_type& front() { return values[ head() ]; }
+
+	const value_type& front() const { return values[ head() ]; }
+
+	value_type& back() { return values[ tail() ]; }
+
+	const value_type& back() const { return values[ tail() ]; }
+
+	// the values in storage order
+	T* data() noexcept { return values; }
+
+	const T* data() const noexcept { return values; }
+
+	// Capacity
+
+	bool empty() const noexcept { return size() == 0; }
+
+	size_type size() const noexcept { return size_type( header->count ); }
+
+	size_type max_size() const noexcept { return size_type( std::numeric_limits<U>::max() ); }
+
+	size_type capacity() const noexcept { return size_type( header->capacity ); }
+
+	// grow the file to hold N elements
+	void reserve( size_type N ) {
+		if( N > max_size() ) {
+			throw std::runtime_error("cw::mapped_list::reserve() -- size too big for index_type");
+		}
+		if( N > capacity() ) {
+			set_capacity( N );
+		}
+	}
+
+	// shrink the file to the elements it holds
+	void shrink_to_fit() {
+		if( size() < capacity() ) {
+			set_capacity( size() );
+		}
+	}
+
+	// Modifiers
+
+	void clear() noexcept {
+		header->count = 0;
+		header->head = header->tail = terminator;
+	}
+
+	iterator insert( const_iterator pos, const value_type& x ) {
+		return iterator( this, link_before( new_slot( x ), pos.index ) );
+	}
+
+	template<typename InputIt,typename = is_input_iterator<InputIt>>
+	iterator insert( const_iterator pos, InputIt first, InputIt last ) {
+		if( first == last ) return iterator( this, pos.index );
+		index_type first_index = link_before( new_slot( *first ), pos.index );
+		for( ++first; first != last; ++first ) {
+			link_before( new_slot( *first ), pos.index );
+		}
+		return iterator( this, first_index );
+	}
+
+	template<typename... Ts>
+	iterator emplace( const_iterator pos, Ts&&... xs ) {
+		return insert( pos, value_type( std::forward<Ts>(xs)... ) );
+	}
+
+	// erase the element at pos, returning an iterator to the element that followed it.
+	// invalidates iterators to the element at the back of the storage.
+	iterator erase( const_iterator pos ) {
+		return iterator( this, erase_index( pos.index ) );
+	}
+
+	iterator erase( const_iterator first, const_iterator last ) {
+		index_type follow = last.index;
+		for( index_type i = first.index; i != follow; ) {
+			// the back element fills the erased slot, and may be the one at last
+			index_type back = index_type( size() - 1 );
+			index_type next = erase_index(i);
+			if( follow == back && i != back ) {
+				follow = i;
+			}
+			i = next;
+		}
+		return iterator( this, follow );
+	}
+
+	void push_front( const value_type& x ) {
+		link_before( new_slot( x ), head() );
+	}
+
+	void push_back( const value_type& x ) {
+		link_before( new_slot( x ), terminator );
+	}
+
+	template<typename... Ts>
+	void emplace_front( Ts&&... xs ) {
+		push_front( value_type( std::forward<Ts>(xs)... ) );
+	}
+
+	template<typename... Ts>
+	void emplace_back( Ts&&... xs ) {
+		push_back( value_type( std::forward<Ts>(xs)... ) );
+	}
+
+	void pop_front() {
+		erase_index( head() );
+	}
+
+	void pop_back() {
+		erase_index( tail() );
+	}
+
+	void swap( mapped_list& rhs ) noexcept {
+		file.swap( rhs.file );
+		std::swap( header, rhs.header );
+		std::swap( values, rhs.values );
+		std::swap( nodes, rhs.nodes );
+	}
+
+	// Iterators
+
+	iterator begin() noexcept {
+		return iterator( this, head() );
+	}
+
+	iterator end() noexcept {
+		return iterator( this, terminator );
+	}
+
+	const_iterator begin() const noexcept {
+		return const_iterator( this, head() );
+	}
+
+	const_iterator end() const noexcept {
+		return const_iterator( this, terminator );
+	}
+
+	const_iterator cbegin() const noexcept {
+		return begin();
+	}
+
+	const_iterator cend() const noexcept {
+		return end();
+	}
+
+	reverse_iterator rbegin() noexcept {
+		return reverse_iterator( end() );
+	}
+
+	reverse_iterator rend() noexcept {
+		return reverse_iterator( begin() );
+	}
+
+	const_reverse_iterator rbegin() const noexcept {
+		return const_reverse_iterator( end() );
+	}
+
+	const_reverse_iterator rend() const noexcept {
+		return const_reverse_iterator( begin() );
+	}
+
+	const_reverse_iterator crbegin() const noexcept {
+		return rbegin();
+	}
+
+	const_reverse_iterator crend() const noexcept {
+		return rend();
+	}
+
+	// Compaction
+
+	// Rewrite the storage into traversal order, so the element at position i
+	// is stored at index i and its links are i-1 and i+1. O(N) with a copy of
+	// the values. Invalidates all iterators.
+	void compact() {
+		std::vector<T> ordered;
+		ordered.reserve( size() );
+		for( index_type i = head(); i != terminator; i = nodes[i].next ) {
+			ordered.push_back( values[i] );
+		}
+		std::copy( std::begin(ordered), std::end(ordered), values );
+		set_default_nodes();
+	}
+
+	// Persistence
+
+	// flush the list to disk. it is otherwise written back when the OS chooses.
+	void sync() {
+		file.sync();
+	}
+
+	friend iterator;
+	friend const_iterator;
+
+protected:
+
+	// the header, the values and the nodes, with the nodes aligned after the values
+	static size_type nodes_offset( size_type capacity ) noexcept {
+		size_type end = sizeof(header_type) + capacity * sizeof(T);
+		return ( end + alignof(node_type) - 1 ) / alignof(node_type) * alignof(node_type);
+	}
+
+	static size_type file_size( size_type capacity ) noexcept {
+		return nodes_offset( capacity ) + capacity * sizeof(node_type);
+	}
+
+	// point into the mapping after it may have moved
+	void refresh() noexcept {
+		header = reinterpret_cast<header_type*>( file.data );
+		values = reinterpret_cast<T*>( file.data + sizeof(header_type) );
+		nodes = reinterpret_cast<node_type*>( file.data + nodes_offset( size_type( header->capacity ) ) );
+	}
+
+	// resize the file for N slots, moving the nodes to follow N values
+	void set_capacity( size_type N ) {
+		size_type count = size();
+		size_type old_offset = nodes_offset( capacity() );
+		size_type new_offset = nodes_offset( N );
+		if( new_offset < old_offset ) {
+			std::memmove( file.data + new_offset, file.data + old_offset, count * sizeof(node_type) );
+		}
+		file.resize( file_size( N ) );
+		if( new_offset > old_offset ) {
+			std::memmove( file.data + new_offset, file.data + old_offset, count * sizeof(node_type) );
+		}
+		reinterpret_cast<header_type*>( file.data )->capacity = N;
+		refresh();
+	}
+
+	index_type head() const noexcept { return index_type( header->head ); }
+
+	index_type tail() const noexcept { return index_type( header->tail ); }
+
+	// Assignment
+
+	// link the slots as a straight chain
+	void set_default_nodes() noexcept {
+		size_type N = size();
+		if( N == 0 ) {
+			header->head = header->tail = terminator;
+			return;
+		}
+		for(size_type i=0;i<N;++i) {
+			nodes[i] = { index_type(i-1), index_type(i+1) };
+		}
+		nodes[N-1].next = terminator;
+		header->head = 0;
+		header->tail = N - 1;
+	}
+
+	// Iteration
+
+	index_type prev_index( index_type i ) const noexcept {
+		if( i == terminator ) return tail();
+		return nodes[i].prev;
+	}
+
+	index_type next_index( index_type i ) const noexcept {
+		if( i == terminator ) return head();
+		return nodes[i].next;
+	}
+
+	// Modifiers
+
+	// copy a value to the back of the storage, growing the file by half again if
+	// it is full. returns the index of the slot; its node is unlinked.
+	// x may be an element of the list, so it is copied before the mapping can move.
+	index_type new_slot( const value_type& x ) {
+		size_type N = size();
+		if( N >= max_size() ) {
+			throw std::runtime_error("cw::mapped_list -- size too big for index_type");
+		}
+		value_type copy = x;
+		if( N == capacity() ) {
+			set_capacity( std::min( std::max<size_type>( N + N / 2, 16 ), max_size() ) );
+		}
+		values[N] = copy;
+		header->count = N + 1;
+		return index_type(N);
+	}
+
+	// link the unlinked slot N in before index, returning N
+	index_type link_before( index_type N, index_type index ) noexcept {
+		index_type prev = prev_index( index );
+		nodes[N] = { prev, index };
+		if( prev == terminator ) {
+			header->head = N;
+		} else {
+			nodes[prev].next = N;
+		}
+		if( index == terminator ) {
+			header->tail = N;
+		} else {
+			nodes[index].prev = N;
+		}
+		return N;
+	}
+
+	// unlink the element at index and fill its slot from the back of the
+	// storage, returning the new index of the element that followed it
+	index_type erase_index( index_type index ) noexcept {
+		index_type prev = nodes[index].prev;
+		index_type next = nodes[index].next;
+		if( prev == terminator ) {
+			header->head = next;
+		} else {
+			nodes[prev].next = next;
+		}
+		if( next == terminator ) {
+			header->tail = prev;
+		} else {
+			nodes[next].prev = prev;
+		}
+
+		index_type last = index_type( size() - 1 );
+		if( index != last ) {
+			move_slot( last, index );
+			if( next == last ) {
+				next = index;
+			}
+		}
+		header->count = last;
+		return next;
+	}
+
+	// move the element in slot from to the unused slot to, keeping its position
+	void move_slot( index_type from, index_type to ) noexcept {
+		index_type prev = nodes[from].prev;
+		index_type next = nodes[from].next;
+		values[to] = values[from];
+		nodes[to] = { prev, next };
+		if( prev == terminator ) {
+			header->head = to;
+		} else {
+			nodes[prev].next = to;
+		}
+		if( next == terminator ) {
+			header->tail = to;
+		} else {
+			nodes[next].prev = to;
+		}
+	}
+};
+
+}
+
+#if _MSC_VER <= 1800
+#undef noexcept
+#endif
+
+#endif
@@ -0,0 +1,697 @@
+#ifndef INCLUDED_CW_SIMD
+#define INCLUDED_CW_SIMD
+#include <cstdint>
+#include <cstddef>
+#include <algorithm>
+#include <numeric>
+#include <type_traits>
+
+// Explicitly vectorized kernels for scanning arrays of arithmetic values,
+// with the instruction set chosen at runtime: SSE2, AVX2 or AVX-512 (F and BW).
+// Vectorized on x86-64 only; elsewhere every function is the standard algorithm.
+
+#if defined(_M_X64) || defined(__x86_64__)
+#define CW_SIMD_X86
+#endif
+
+#ifdef CW_SIMD_X86
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#else
+#include <x86intrin.h>
+#include <cpuid.h>
+#endif
+
+// MSVC compiles any intrinsic anywhere; GCC and Clang need the instruction set
+// enabled on each function using it.
+#ifdef _MSC_VER
+#define CW_SIMD_TARGET_SSE2
+#define CW_SIMD_TARGET_AVX2
+#define CW_SIMD_TARGET_AVX512
+#else
+#define CW_SIMD_TARGET_SSE2   __attribute__((target("sse2")))
+#define CW_SIMD_TARGET_AVX2   __attribute__((target("avx2,popcnt")))
+#define CW_SIMD_TARGET_AVX512 __attribute__((target("avx512f,avx512bw,popcnt")))
+#endif
+
+// AVX-512 intrinsics arrived in Visual Studio 2017
+#if !defined(_MSC_VER) || _MSC_VER >= 1911
+#define CW_SIMD_AVX512
+#endif
+
+#endif
+
+namespace cw {
+namespace simd {
+
+enum class isa { none, sse2, avx2, avx512 };
+
+#ifdef CW_SIMD_X86
+
+// Instruction set detection
+
+inline void cpuid( int leaf, int subleaf, unsigned r[4] ) {
+#ifdef _MSC_VER
+	int x[4];
+	__cpuidex( x, leaf, subleaf );
+	for(int i=0;i<4;++i) r[i] = unsigned(x[i]);
+#else
+	__cpuid_count( leaf, subleaf, r[0], r[1], r[2], r[3] );
+#endif
+}
+
+// the register state the OS saves on a context switch
+inline uint64_t xgetbv0() {
+#ifdef _MSC_VER
+	return _xgetbv(0);
+#else
+	unsigned lo, hi;
+	__asm__( "xgetbv" : "=a"(lo), "=d"(hi) : "c"(0) );
+	return ( uint64_t(hi) << 32 ) | lo;
+#endif
+}
+
+inline isa detect_isa() {
+	unsigned r[4];
+	cpuid( 0, 0, r );
+	unsigned max_leaf = r[0];
+	cpuid( 1, 0, r );
+	bool sse2 = ( r[3] & ( 1u << 26 ) ) != 0;
+	bool popcnt = ( r[2] & ( 1u << 23 ) ) != 0;
+	bool osxsave = ( r[2] & ( 1u << 27 ) ) != 0;
+	if( !sse2 ) return isa::none;
+	if( max_leaf < 7 || !osxsave || !popcnt ) return isa::sse2;
+
+	uint64_t xcr0 = xgetbv0();
+	cpuid( 7, 0, r );
+	bool avx2 = ( r[1] & ( 1u << 5 ) ) != 0 && ( xcr0 & 0x06 ) == 0x06;
+	bool avx512 = ( r[1] & ( 1u << 16 ) ) != 0 && ( r[1] & ( 1u << 30 ) ) != 0 && ( xcr0 & 0xe6 ) == 0xe6;
+#ifdef CW_SIMD_AVX512
+	if( avx2 && avx512 ) return isa::avx512;
+#else
+	(void)avx512;
+#endif
+	return avx2 ? isa::avx2 : isa::sse2;
+}
+
+#else
+
+inline isa detect_isa() { return isa::none; }
+
+#endif
+
+// the best instruction set of this CPU, detected once
+inline isa supported_isa() {
+	static const isa i = detect_isa();
+	return i;
+}
+
+// the instruction set the kernels use -- the supported one unless lowered by
+// set_isa(), which is for testing and benchmarking and is not thread-safe
+inline isa& active_isa() {
+	static isa i = supported_isa();
+	return i;
+}
+
+// returns the instruction set now in use, which is no better than supported_isa()
+inline isa set_isa( isa i ) {
+	active_isa() = std::min( i, supported_isa() );
+	return active_isa();
+}
+
+// hint that the cache line holding p will be read soon
+inline void prefetch( const void* p ) noexcept {
+#if defined(CW_SIMD_X86)
+	_mm_prefetch( static_cast<const char*>(p), _MM_HINT_T0 );
+#elif defined(__GNUC__)
+	__builtin_prefetch( p );
+#else
+	(void)p;
+#endif
+}
+
+// the value types with kernels -- integral types other than bool, float and double
+template<typename T>
+struct has_kernels : std::integral_constant<bool,
+	( std::is_integral<T>::value && !std::is_same<T,bool>::value && sizeof(T) <= 8 ) ||
+	std::is_same<T,float>::value || std::is_same<T,double>::value
+> {};
+
+#ifdef CW_SIMD_X86
+
+inline unsigned ctz64( uint64_t x ) {
+#ifdef _MSC_VER
+	unsigned long i;
+	_BitScanForward64( &i, x );
+	return unsigned(i);
+#else
+	return unsigned( __builtin_ctzll(x) );
+#endif
+}
+
+// SSE2 alone doesn't guarantee the popcnt instruction
+inline unsigned popcount64_soft( uint64_t x ) {
+	x = x - ( ( x >> 1 ) & 0x5555555555555555ull );
+	x = ( x & 0x3333333333333333ull ) + ( ( x >> 2 ) & 0x3333333333333333ull );
+	x = ( x + ( x >> 4 ) ) & 0x0f0f0f0f0f0f0f0full;
+	return unsigned( ( x * 0x0101010101010101ull ) >> 56 );
+}
+
+#ifdef _MSC_VER
+#define CW_SIMD_POPCOUNT_HW(x) unsigned( __popcnt64(x) )
+#else
+#define CW_SIMD_POPCOUNT_HW(x) unsigned( __builtin_popcountll(x) )
+#endif
+
+// SSE2
+
+namespace sse2 {
+
+#define CW_SIMD_TARGET CW_SIMD_TARGET_SSE2
+
+// W-byte integer lanes, S -- signed
+template<size_t W,bool S>
+struct ivec_base {
+	using type = __m128i;
+	using mask_type = __m128i;
+	static const size_t lanes = 16 / W;
+	static const size_t bits_per_lane = W;
+
+	CW_SIMD_TARGET static type load( const void* p ) { return _mm_loadu_si128( (const __m128i*)p ); }
+	CW_SIMD_TARGET static void store( void* p, type v ) { _mm_storeu_si128( (__m128i*)p, v ); }
+	CW_SIMD_TARGET static type zero() { return _mm_setzero_si128(); }
+	CW_SIMD_TARGET static uint64_t bits( mask_type m ) { return uint32_t( _mm_movemask_epi8(m) ); }
+	CW_SIMD_TARGET static type select( mask_type m, type a, type b ) { return _mm_or_si128( _mm_and_si128( m, a ), _mm_andnot_si128( m, b ) ); }
+
+	// extend and add the lanes of v into the 64-bit lanes of acc
+	CW_SIMD_TARGET static type sum_step32( type acc, type v ) {
+		type sign = S ? _mm_srai_epi32( v, 31 ) : _mm_setzero_si128();
+		acc = _mm_add_epi64( acc, _mm_unpacklo_epi32( v, sign ) );
+		return _mm_add_epi64( acc, _mm_unpackhi_epi32( v, sign ) );
+	}
+};
+
+template<size_t W,bool S>
+struct ivec;
+
+template<bool S>
+struct ivec<1,S> : ivec_base<1,S> {
+	using typename ivec_base<1,S>::type;
+	static const bool has_minmax = true;
+	static const int64_t sum_bias = S ? -128 : 0;
+
+	template<typename T>
+	CW_SIMD_TARGET static type set1( T x ) { return _mm_set1_epi8( char(x) ); }
+	CW_SIMD_TARGET static type eq( type a, type b ) { return _mm_cmpeq_epi8( a, b ); }
+	CW_SIMD_TARGET static type bias( type a ) { return S ? _mm_xor_si128( a, _mm_set1_epi8( char(0x80) ) ) : a; }
+	CW_SIMD_TARGET static type min( type a, type b ) { return bias( _mm_min_epu8( bias(a), bias(b) ) ); }
+	CW_SIMD_TARGET static type max( type a, type b ) { return bias( _mm_max_epu8( bias(a), bias(b) ) ); }
+	CW_SIMD_TARGET static type sum_step( type acc, type v ) { return _mm_add_epi64( acc, _mm_sad_epu8( bias(v), _mm_setzero_si128() ) ); }
+};
+
+template<bool S>
+struct ivec<2,S> : ivec_base<2,S> {
+	using typename ivec_base<2,S>::type;
+	static const bool has_minmax = true;
+	static const int64_t sum_bias = S ? 0 : 32768;
+
+	template<typename T>
+	CW_SIMD_TARGET static type set1( T x ) { return _mm_set1_epi16( short(x) ); }
+	CW_SIMD_TARGET static type eq( type a, type b ) { return _mm_cmpeq_epi16( a, b ); }
+	CW_SIMD_TARGET static type bias( type a ) { return S ? a : _mm_xor_si128( a, _mm_set1_epi16( short(0x8000) ) ); }
+	CW_SIMD_TARGET static type min( type a, type b ) { return bias( _mm_min_epi16( bias(a), bias(b) ) ); }
+	CW_SIMD_TARGET static type max( type a, type b ) { return bias( _mm_max_epi16( bias(a), bias(b) ) ); }
+	CW_SIMD_TARGET static type sum_step( type acc, type v ) {
+		type pairs = _mm_madd_epi16( bias(v), _mm_set1_epi16(1) );
+		type sign = _mm_srai_epi32( pairs, 31 );
+		acc = _mm_add_epi64( acc, _mm_unpacklo_epi32( pairs, sign ) );
+		return _mm_add_epi64( acc, _mm_unpackhi_epi32( pairs, sign ) );
+	}
+};
+
+template<bool S>
+struct ivec<4,S> : ivec_base<4,S> {
+	using typename ivec_base<4,S>::type;
+	static const bool has_minmax = true;
+	static const int64_t sum_bias = 0;
+
+	template<typename T>
+	CW_SIMD_TARGET static type set1( T x ) { return _mm_set1_epi32( int(x) ); }
+	CW_SIMD_TARGET static type eq( type a, type b ) { return _mm_cmpeq_epi32( a, b ); }
+	CW_SIMD_TARGET static type bias( type a ) { return S ? a : _mm_xor_si128( a, _mm_set1_epi32( int(0x80000000) ) ); }
+	CW_SIMD_TARGET static type min( type a, type b ) { return ivec_base<4,S>::select( _mm_cmpgt_epi32( bias(a), bias(b) ), b, a ); }
+	CW_SIMD_TARGET static type max( type a, type b ) { return ivec_base<4,S>::select( _mm_cmpgt_epi32( bias(a), bias(b) ), a, b ); }
+	CW_SIMD_TARGET static type sum_step( type acc, type v ) { return ivec_base<4,S>::sum_step32( acc, v ); }
+};
+
+// no 64-bit compare before SSE4.2
+template<bool S>
+struct ivec<8,S> : ivec_base<8,S> {
+	using typename ivec_base<8,S>::type;
+	static const bool has_minmax = false;
+	static const int64_t sum_bias = 0;
+
+	template<typename T>
+	CW_SIMD_TARGET static type set1( T x ) { return _mm_set1_epi64x( (long long)x ); }
+	CW_SIMD_TARGET static type eq( type a, type b ) {
+		type e = _mm_cmpeq_epi32( a, b );
+		return _mm_and_si128( e, _mm_shuffle_epi32( e, _MM_SHUFFLE(2,3,0,1) ) );
+	}
+	CW_SIMD_TARGET static type sum_step( type acc, type v ) { return _mm_add_epi64( acc, v ); }
+};
+
+template<typename T>
+struct fvec;
+
+template<>
+struct fvec<float> {
+	using type = __m128;
+	using mask_type = __m128;
+	static const size_t lanes = 4;
+	static const size_t bits_per_lane = 4;
+	static const bool has_minmax = true;
+
+	CW_SIMD_TARGET static type load( const void* p ) { return _mm_loadu_ps( (const float*)p ); }
+	CW_SIMD_TARGET static void store( void* p, type v ) { _mm_storeu_ps( (float*)p, v ); }
+	CW_SIMD_TARGET static type zero() { return _mm_setzero_ps(); }
+	CW_SIMD_TARGET static type set1( float x ) { return _mm_set1_ps(x); }
+	CW_SIMD_TARGET static mask_type eq( type a, type b ) { return _mm_cmpeq_ps( a, b ); }
+	CW_SIMD_TARGET static uint64_t bits( mask_type m ) { return uint32_t( _mm_movemask_epi8( _mm_castps_si128(m) ) ); }
+	CW_SIMD_TARGET static type select( mask_type m, type a, type b ) { return _mm_or_ps( _mm_and_ps( m, a ), _mm_andnot_ps( m, b ) ); }
+	CW_SIMD_TARGET static type add( type a, type b ) { return _mm_add_ps( a, b ); }
+	CW_SIMD_TARGET static type min( type a, type b ) { return _mm_min_ps( a, b ); }
+	CW_SIMD_TARGET static type max( type a, type b ) { return _mm_max_ps( a, b ); }
+};
+
+template<>
+struct fvec<double> {
+	using type = __m128d;
+	using mask_type = __m128d;
+	static const size_t lanes = 2;
+	static const size_t bits_per_lane = 8;
+	static const bool has_minmax = true;
+
+	CW_SIMD_TARGET static type load( const void* p ) { return _mm_loadu_pd( (const double*)p ); }
+	CW_SIMD_TARGET static void store( void* p, type v ) { _mm_storeu_pd( (double*)p, v ); }
+	CW_SIMD_TARGET static type zero() { return _mm_setzero_pd(); }
+	CW_SIMD_TARGET static type set1( double x ) { return _mm_set1_pd(x); }
+	CW_SIMD_TARGET static mask_type eq( type a, type b ) { return _mm_cmpeq_pd( a, b ); }
+	CW_SIMD_TARGET static uint64_t bits( mask_type m ) { return uint32_t( _mm_movemask_epi8( _mm_castpd_si128(m) ) ); }
+	CW_SIMD_TARGET static type select( mask_type m, type a, type b ) { return _mm_or_pd( _mm_and_pd( m, a ), _mm_andnot_pd( m, b ) ); }
+	CW_SIMD_TARGET static type add( type a, type b ) { return _mm_add_pd( a, b ); }
+	CW_SIMD_TARGET static type min( type a, type b ) { return _mm_min_pd( a, b ); }
+	CW_SIMD_TARGET static type max( type a, type b ) { return _mm_max_pd( a, b ); }
+};
+
+template<typename T>
+using vec = typename std::conditional< std::is_floating_point<T>::value, fvec<T>, ivec<sizeof(T),std::is_signed<T>::value> >::type;
+
+#define CW_SIMD_POPCOUNT(x) popcount64_soft(x)
+#include "simd_kernels.inl"
+#undef CW_SIMD_POPCOUNT
+#undef CW_SIMD_TARGET
+
+}
+
+// AVX2
+
+namespace avx2 {
+
+#define CW_SIMD_TARGET CW_SIMD_TARGET_AVX2
+
+template<size_t W,bool S>
+struct ivec_base {
+	using type = __m256i;
+	using mask_type = __m256i;
+	static const size_t lanes = 32 / W;
+	static const size_t bits_per_lane = W;
+	static const bool has_minmax = true;
+
+	CW_SIMD_TARGET static type load( const void* p ) { return _mm256_loadu_si256( (const __m256i*)p ); }
+	CW_SIMD_TARGET static void store( void* p, type v ) { _mm256_storeu_si256( (__m256i*)p, v ); }
+	CW_SIMD_TARGET static type zero() { return _mm256_setzero_si256(); }
+	CW_SIMD_TARGET static uint64_t bits( mask_type m ) { return uint32_t( _mm256_movemask_epi8(m) ); }
+	CW_SIMD_TARGET static type select( mask_type m, type a, type b ) { return _mm256_blendv_epi8( b, a, m ); }
+
+	CW_SIMD_TARGET static type sum_step32( type acc, type v ) {
+		type sign = S ? _mm256_srai_epi32( v, 31 ) : _mm256_setzero_si256();
+		acc = _mm256_add_epi64( acc, _mm256_unpacklo_epi32( v, sign ) );
+		return _mm256_add_epi64( acc, _mm256_unpackhi_epi32( v, sign ) );
+	}
+};
+
+template<size_t W,bool S>
+struct ivec;
+
+template<bool S>
+struct ivec<1,S> : ivec_base<1,S> {
+	using typename ivec_base<1,S>::type;
+	static const int64_t sum_bias = S ? -128 : 0;
+
+	template<typename T>
+	CW_SIMD_TARGET static type set1( T x ) { return _mm256_set1_epi8( char(x) ); }
+	CW_SIMD_TARGET static type eq( type a, type b ) { return _mm256_cmpeq_epi8( a, b ); }
+	CW_SIMD_TARGET static type min( type a, type b ) { return S ? _mm256_min_epi8( a, b ) : _mm256_min_epu8( a, b ); }
+	CW_SIMD_TARGET static type max( type a, type b ) { return S ? _mm256_max_epi8( a, b ) : _mm256_max_epu8( a, b ); }
+	CW_SIMD_TARGET static type sum_step( type acc, type v ) {
+		type u = S ? _mm256_xor_si256( v, _mm256_set1_epi8( char(0x80) ) ) : v;
+		return _mm256_add_epi64( acc, _mm256_sad_epu8( u, _mm256_setzero_si256() ) );
+	}
+};
+
+template<bool S>
+struct ivec<2,S> : ivec_base<2,S> {
+	using typename ivec_base<2,S>::type;
+	static const int64_t sum_bias = S ? 0 : 32768;
+
+	template<typename T>
+	CW_SIMD_TARGET static type set1( T x ) { return _mm256_set1_epi16( short(x) ); }
+	CW_SIMD_TARGET static type eq( type a, type b ) { return _mm256_cmpeq_epi16( a, b ); }
+	CW_SIMD_TARGET static type min( type a, type b ) { return S ? _mm256_min_epi16( a, b ) : _mm256_min_epu16( a, b ); }
+	CW_SIMD_TARGET static type max( type a, type b ) { return S ? _mm256_max_epi16( a, b ) : _mm256_max_epu16( a, b ); }
+	CW_SIMD_TARGET static type sum_step( type acc, type v ) {
+		type s = S ? v : _mm256_xor_si256( v, _mm256_set1_epi16( short(0x8000) ) );
+		type pairs = _mm256_madd_epi16( s, _mm256_set1_epi16(1) );
+		type sign = _mm256_srai_epi32( pairs, 31 );
+		acc = _mm256_add_epi64( acc, _mm256_unpacklo_epi32( pairs, sign ) );
+		return _mm256_add_epi64( acc, _mm256_unpackhi_epi32( pairs, sign ) );
+	}
+};
+
+template<bool S>
+struct ivec<4,S> : ivec_base<4,S> {
+	using typename ivec_base<4,S>::type;
+	static const int64_t sum_bias = 0;
+
+	template<typename T>
+	CW_SIMD_TARGET static type set1( T x ) { return _mm256_set1_epi32( int(x) ); }
+	CW_SIMD_TARGET static type eq( type a, type b ) { return _mm256_cmpeq_epi32( a, b ); }
+	CW_SIMD_TARGET static type min( type a, type b ) { return S ? _mm256_min_epi32( a, b ) : _mm256_min_epu32( a, b ); }
+	CW_SIMD_TARGET static type max( type a, type b ) { return S ? _mm256_max_epi32( a, b ) : _mm256_max_epu32( a, b ); }
+	CW_SIMD_TARGET static type sum_step( type acc, type v ) { return ivec_base<4,S>::sum_step32( acc, v ); }
+};
+
+template<bool S>
+struct ivec<8,S> : ivec_base<8,S> {
+	using typename ivec_base<8,S>::type;
+	static const int64_t sum_bias = 0;
+
+	template<typename T>
+	CW_SIMD_TARGET static type set1( T x ) { return _mm256_set1_epi64x( (long long)x ); }
+	CW_SIMD_TARGET static type eq( type a, type b ) { return _mm256_cmpeq_epi64( a, b ); }
+	CW_SIMD_TARGET static type greater( type a, type b ) {
+		type bias = S ? _mm256_setzero_si256() : _mm256_set1_epi64x( (long long)0x8000000000000000ull );
+		return _mm256_cmpgt_epi64( _mm256_xor_si256( a, bias ), _mm256_xor_si256( b, bias ) );
+	}
+	CW_SIMD_TARGET static type min( type a, type b ) { return _mm256_blendv_epi8( a, b, greater( a, b ) ); }
+	CW_SIMD_TARGET static type max( type a, type b ) { return _mm256_blendv_epi8( b, a, greater( a, b ) ); }
+	CW_SIMD_TARGET static type sum_step( type acc, type v ) { return _mm256_add_epi64( acc, v ); }
+};
+
+template<typename T>
+struct fvec;
+
+template<>
+struct fvec<float> {
+	using type = __m256;
+	using mask_type = __m256;
+	static const size_t lanes = 8;
+	static const size_t bits_per_lane = 4;
+	static const bool has_minmax = true;
+
+	CW_SIMD_TARGET static type load( const void* p ) { return _mm256_loadu_ps( (const float*)p ); }
+	CW_SIMD_TARGET static void store( void* p, type v ) { _mm256_storeu_ps( (float*)p, v ); }
+	CW_SIMD_TARGET static type zero() { return _mm256_setzero_ps(); }
+	CW_SIMD_TARGET static type set1( float x ) { return _mm256_set1_ps(x); }
+	CW_SIMD_TARGET static mask_type eq( type a, type b ) { return _mm256_cmp_ps( a, b, _CMP_EQ_OQ ); }
+	CW_SIMD_TARGET static uint64_t bits( mask_type m ) { return uint32_t( _mm256_movemask_epi8( _mm256_castps_si256(m) ) ); }
+	CW_SIMD_TARGET static type select( mask_type m, type a, type b ) { return _mm256_blendv_ps( b, a, m ); }
+	CW_SIMD_TARGET static type add( type a, type b ) { return _mm256_add_ps( a, b ); }
+	CW_SIMD_TARGET static type min( type a, type b ) { return _mm256_min_ps( a, b ); }
+	CW_SIMD_TARGET static type max( type a, type b ) { return _mm256_max_ps( a, b ); }
+};
+
+template<>
+struct fvec<double> {
+	using type = __m256d;
+	using mask_type = __m256d;
+	static const size_t lanes = 4;
+	static const size_t bits_per_lane = 8;
+	static const bool has_minmax = true;
+
+	CW_SIMD_TARGET static type load( const void* p ) { return _mm256_loadu_pd( (const double*)p ); }
+	CW_SIMD_TARGET static void store( void* p, type v ) { _mm256_storeu_pd( (double*)p, v ); }
+	CW_SIMD_TARGET static type zero() { return _mm256_setzero_pd(); }
+	CW_SIMD_TARGET static type set1( double x ) { return _mm256_set1_pd(x); }
+	CW_SIMD_TARGET static mask_type eq( type a, type b ) { return _mm256_cmp_pd( a, b, _CMP_EQ_OQ ); }
+	CW_SIMD_TARGET static uint64_t bits( mask_type m ) { return uint32_t( _mm256_movemask_epi8( _mm256_castpd_si256(m) ) ); }
+	CW_SIMD_TARGET static type select( mask_type m, type a, type b ) { return _mm256_blendv_pd( b, a, m ); }
+	CW_SIMD_TARGET static type add( type a, type b ) { return _mm256_add_pd( a, b ); }
+	CW_SIMD_TARGET static type min( type a, type b ) { return _mm256_min_pd( a, b ); }
+	CW_SIMD_TARGET static type max( type a, type b ) { return _mm256_max_pd( a, b ); }
+};
+
+template<typename T>
+using vec = typename std::conditional< std::is_floating_point<T>::value, fvec<T>, ivec<sizeof(T),std::is_signed<T>::value> >::type;
+
+#define CW_SIMD_POPCOUNT(x) CW_SIMD_POPCOUNT_HW(x)
+#include "simd_kernels.inl"
+#undef CW_SIMD_POPCOUNT
+#undef CW_SIMD_TARGET
+
+}
+
+// AVX-512 -- compares produce a bit per lane in a mask register
+
+#ifdef CW_SIMD_AVX512
+namespace avx512 {
+
+#define CW_SIMD_TARGET CW_SIMD_TARGET_AVX512
+
+template<size_t W,bool S>
+struct ivec_base {
+	using type = __m512i;
+	static const size_t lanes = 64 / W;
+	static const size_t bits_per_lane = 1;
+	static const bool has_minmax = true;
+
+	CW_SIMD_TARGET static type load( const void* p ) { return _mm512_loadu_si512( p ); }
+	CW_SIMD_TARGET static void store( void* p, type v ) { _mm512_storeu_si512( p, v ); }
+	CW_SIMD_TARGET static type zero() { return _mm512_setzero_si512(); }
+	template<typename M>
+	CW_SIMD_TARGET static uint64_t bits( M m ) { return uint64_t(m); }
+
+	CW_SIMD_TARGET static type sum_step32( type acc, type v ) {
+		type sign = S ? _mm512_srai_epi32( v, 31 ) : _mm512_setzero_si512();
+		acc = _mm512_add_epi64( acc, _mm512_unpacklo_epi32( v, sign ) );
+		return _mm512_add_epi64( acc, _mm512_unpackhi_epi32( v, sign ) );
+	}
+};
+
+template<size_t W,bool S>
+struct ivec;
+
+template<bool S>
+struct ivec<1,S> : ivec_base<1,S> {
+	using typename ivec_base<1,S>::type;
+	using mask_type = __mmask64;
+	static const int64_t sum_bias = S ? -128 : 0;
+
+	template<typename T>
+	CW_SIMD_TARGET static type set1( T x ) { return _mm512_set1_epi8( char(x) ); }
+	CW_SIMD_TARGET static mask_type eq( type a, type b ) { return _mm512_cmpeq_epi8_mask( a, b ); }
+	CW_SIMD_TARGET static type select( mask_type m, type a, type b ) { return _mm512_mask_blend_epi8( m, b, a ); }
+	CW_SIMD_TARGET static type min( type a, type b ) { return S ? _mm512_min_epi8( a, b ) : _mm512_min_epu8( a, b ); }
+	CW_SIMD_TARGET static type max( type a, type b ) { return S ? _mm512_max_epi8( a, b ) : _mm512_max_epu8( a, b ); }
+	CW_SIMD_TARGET static type sum_step( type acc, type v ) {
+		type u = S ? _mm512_xor_si512( v, _mm512_set1_epi8( char(0x80) ) ) : v;
+		return _mm512_add_epi64( acc, _mm512_sad_epu8( u, _mm512_setzero_si512() ) );
+	}
+};
+
+template<bool S>
+struct ivec<2,S> : ivec_base<2,S> {
+	using typename ivec_base<2,S>::type;
+	using mask_type = __mmask32;
+	static const int64_t sum_bias = S ? 0 : 32768;
+
+	template<typename T>
+	CW_SIMD_TARGET static type set1( T x ) { return _mm512_set1_epi16( short(x) ); }
+	CW_SIMD_TARGET static mask_type eq( type a, type b ) { return _mm512_cmpeq_epi16_mask( a, b ); }
+	CW_SIMD_TARGET static type select( mask_type m, type a, type b ) { return _mm512_mask_blend_epi16( m, b, a ); }
+	CW_SIMD_TARGET static type min( type a, type b ) { return S ? _mm512_min_epi16( a, b ) : _mm512_min_epu16( a, b ); }
+	CW_SIMD_TARGET static type max( type a, type b ) { return S ? _mm512_max_epi16( a, b ) : _mm512_max_epu16( a, b ); }
+	CW_SIMD_TARGET static type sum_step( type acc, type v ) {
+		type s = S ? v : _mm512_xor_si512( v, _mm512_set1_epi16( short(0x8000) ) );
+		type pairs = _mm512_madd_epi16( s, _mm512_set1_epi16(1) );
+		type sign = _mm512_srai_epi32( pairs, 31 );
+		acc = _mm512_add_epi64( acc, _mm512_unpacklo_epi32( pairs, sign ) );
+		return _mm512_add_epi64( acc, _mm512_unpackhi_epi32( pairs, sign ) );
+	}
+};
+
+template<bool S>
+struct ivec<4,S> : ivec_base<4,S> {
+	using typename ivec_base<4,S>::type;
+	using mask_type = __mmask16;
+	static const int64_t sum_bias = 0;
+
+	template<typename T>
+	CW_SIMD_TARGET static type set1( T x ) { return _mm512_set1_epi32( int(x) ); }
+	CW_SIMD_TARGET static mask_type eq( type a, type b ) { return _mm512_cmpeq_epi32_mask( a, b ); }
+	CW_SIMD_TARGET static type select( mask_type m, type a, type b ) { return _mm512_mask_blend_epi32( m, b, a ); }
+	CW_SIMD_TARGET static type min( type a, type b ) { return S ? _mm512_min_epi32( a, b ) : _mm512_min_epu32( a, b ); }
+	CW_SIMD_TARGET static type max( type a, type b ) { return S ? _mm512_max_epi32( a, b ) : _mm512_max_epu32( a, b ); }
+	CW_SIMD_TARGET static type sum_step( type acc, type v ) { return ivec_base<4,S>::sum_step32( acc, v ); }
+};
+
+template<bool S>
+struct ivec<8,S> : ivec_base<8,S> {
+	using typename ivec_base<8,S>::type;
+	using mask_type = __mmask8;
+	static const int64_t sum_bias = 0;
+
+	template<typename T>
+	CW_SIMD_TARGET static type set1( T x ) { return _mm512_set1_epi64( (long long)x ); }
+	CW_SIMD_TARGET static mask_type eq( type a, type b ) { return _mm512_cmpeq_epi64_mask( a, b ); }
+	CW_SIMD_TARGET static type select( mask_type m, type a, type b ) { return _mm512_mask_blend_epi64( m, b, a ); }
+	CW_SIMD_TARGET static type min( type a, type b ) { return S ? _mm512_min_epi64( a, b ) : _mm512_min_epu64( a, b ); }
+	CW_SIMD_TARGET static type max( type a, type b ) { return S ? _mm512_max_epi64( a, b ) : _mm512_max_epu64( a, b ); }
+	CW_SIMD_TARGET static type sum_step( type acc, type v ) { return _mm512_add_epi64( acc, v ); }
+};
+
+template<typename T>
+struct fvec;
+
+template<>
+struct fvec<float> {
+	using type = __m512;
+	using mask_type = __mmask16;
+	static const size_t lanes = 16;
+	static const size_t bits_per_lane = 1;
+	static const bool has_minmax = true;
+
+	CW_SIMD_TARGET static type load( const void* p ) { return _mm512_loadu_ps( p ); }
+	CW_SIMD_TARGET static void store( void* p, type v ) { _mm512_storeu_ps( p, v ); }
+	CW_SIMD_TARGET static type zero() { return _mm512_setzero_ps(); }
+	CW_SIMD_TARGET static type set1( float x ) { return _mm512_set1_ps(x); }
+	CW_SIMD_TARGET static mask_type eq( type a, type b ) { return _mm512_cmp_ps_mask( a, b, _CMP_EQ_OQ ); }
+	CW_SIMD_TARGET static uint64_t bits( mask_type m ) { return uint64_t(m); }
+	CW_SIMD_TARGET static type select( mask_type m, type a, type b ) { return _mm512_mask_blend_ps( m, b, a ); }
+	CW_SIMD_TARGET static type add( type a, type b ) { return _mm512_add_ps( a, b ); }
+	CW_SIMD_TARGET static type min( type a, type b ) { return _mm512_min_ps( a, b ); }
+	CW_SIMD_TARGET static type max( type a, type b ) { return _mm512_max_ps( a, b ); }
+};
+
+template<>
+struct fvec<double> {
+	using type = __m512d;
+	using mask_type = __mmask8;
+	static const size_t lanes = 8;
+	static const size_t bits_per_lane = 1;
+	static const bool has_minmax = true;
+
+	CW_SIMD_TARGET static type load( const void* p ) { return _mm512_loadu_pd( p ); }
+	CW_SIMD_TARGET static void store( void* p, type v ) { _mm512_storeu_pd( p, v ); }
+	CW_SIMD_TARGET static type zero() { return _mm512_setzero_pd(); }
+	CW_SIMD_TARGET static type set1( double x ) { return _mm512_set1_pd(x); }
+	CW_SIMD_TARGET static mask_type eq( type a, type b ) { return _mm512_cmp_pd_mask( a, b, _CMP_EQ_OQ ); }
+	CW_SIMD_TARGET static uint64_t bits( mask_type m ) { return uint64_t(m); }
+	CW_SIMD_TARGET static type select( mask_type m, type a, type b ) { return _mm512_mask_blend_pd( m, b, a ); }
+	CW_SIMD_TARGET static type add( type a, type b ) { return _mm512_add_pd( a, b ); }
+	CW_SIMD_TARGET static type min( type a, type b ) { return _mm512_min_pd( a, b ); }
+	CW_SIMD_TARGET static type max( type a, type b ) { return _mm512_max_pd( a, b ); }
+};
+
+template<typename T>
+using vec = typename std::conditional< std::is_floating_point<T>::value, fvec<T>, ivec<sizeof(T),std::is_signed<T>::value> >::type;
+
+#define CW_SIMD_POPCOUNT(x) CW_SIMD_POPCOUNT_HW(x)
+#include "simd_kernels.inl"
+#undef CW_SIMD_POPCOUNT
+#undef CW_SIMD_TARGET
+
+}
+#endif
+
+#undef CW_SIMD_POPCOUNT_HW
+
+#endif
+
+// Dispatch -- T is the value type, which must satisfy has_kernels<T>
+
+#ifdef CW_SIMD_X86
+#ifdef CW_SIMD_AVX512
+#define CW_SIMD_DISPATCH( call, fallback ) \
+	switch( active_isa() ) { \
+	case isa::avx512: return avx512::call; \
+	case isa::avx2: return avx2::call; \
+	case isa::sse2: return sse2::call; \
+	default: return fallback; \
+	}
+#else
+#define CW_SIMD_DISPATCH( call, fallback ) \
+	switch( active_isa() ) { \
+	case isa::avx2: return avx2::call; \
+	case isa::sse2: return sse2::call; \
+	default: return fallback; \
+	}
+#endif
+#else
+#define CW_SIMD_DISPATCH( call, fallback ) return fallback;
+#endif
+
+// the index of the first value equal to x, or n
+template<typename T>
+size_t find( const T* p, size_t n, T x ) {
+	CW_SIMD_DISPATCH( find( p, n, x ), size_t( std::find( p, p + n, x ) - p ) )
+}
+
+template<typename T>
+size_t count( const T* p, size_t n, T x ) {
+	CW_SIMD_DISPATCH( count( p, n, x ), size_t( std::count( p, p + n, x ) ) )
+}
+
+template<typename T>
+void replace( T* p, size_t n, T old_val, T new_val ) {
+	CW_SIMD_DISPATCH( replace( p, n, old_val, new_val ), std::replace( p, p + n, old_val, new_val ) )
+}
+
+// the index of the first minimum, or n if empty. unspecified if floating-point values contain NaN.
+template<typename T>
+size_t min_index( const T* p, size_t n ) {
+	if( n == 0 ) return n;
+	CW_SIMD_DISPATCH( min_index( p, n ), size_t( std::min_element( p, p + n ) - p ) )
+}
+
+// the index of the first maximum, or n if empty. unspecified if floating-point values contain NaN.
+template<typename T>
+size_t max_index( const T* p, size_t n ) {
+	if( n == 0 ) return n;
+	CW_SIMD_DISPATCH( max_index( p, n ), size_t( std::max_element( p, p + n ) - p ) )
+}
+
+// integral values -- the sum modulo 2^64 of the values extended to 64 bits
+template<typename T>
+uint64_t sum( const T* p, size_t n, std::true_type ) {
+	CW_SIMD_DISPATCH( sum( p, n, std::true_type() ), std::accumulate( p, p + n, uint64_t(0) ) )
+}
+
+// floating-point values -- the summation order is unspecified
+template<typename T>
+T sum( const T* p, size_t n, std::false_type ) {
+	CW_SIMD_DISPATCH( sum( p, n, std::false_type() ), std::accumulate( p, p + n, T(0) ) )
+}
+
+template<typename T>
+typename std::conditional<std::is_integral<T>::value,uint64_t,T>::type sum( const T* p, size_t n ) {
+	return sum( p, n, std::is_integral<T>() );
+}
+
+#undef CW_SIMD_DISPATCH
+
+}
+}
+
+#endif
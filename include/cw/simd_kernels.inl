@@ -0,0 +1,159 @@
+// Value-scan kernels written once against the vec<T> traits of an instruction set.
+// Included by simd.h inside each instruction set's namespace, with
+//   CW_SIMD_TARGET    -- the function attribute enabling the instruction set
+//   CW_SIMD_POPCOUNT  -- a popcount usable under that instruction set
+// No include guard -- it is meant to be included more than once.
+
+template<typename T>
+CW_SIMD_TARGET size_t find( const T* p, size_t n, T x ) {
+	using V = vec<T>;
+	auto xv = V::set1( x );
+	size_t i = 0;
+	for( ; i + V::lanes <= n; i += V::lanes ) {
+		uint64_t b = V::bits( V::eq( V::load( p + i ), xv ) );
+		if( b ) return i + ctz64( b ) / V::bits_per_lane;
+	}
+	for( ; i < n; ++i ) {
+		if( p[i] == x ) return i;
+	}
+	return n;
+}
+
+template<typename T>
+CW_SIMD_TARGET size_t count( const T* p, size_t n, T x ) {
+	using V = vec<T>;
+	auto xv = V::set1( x );
+	size_t bits = 0;
+	size_t i = 0;
+	for( ; i + 2 * V::lanes <= n; i += 2 * V::lanes ) {
+		bits += CW_SIMD_POPCOUNT( V::bits( V::eq( V::load( p + i ), xv ) ) );
+		bits += CW_SIMD_POPCOUNT( V::bits( V::eq( V::load( p + i + V::lanes ), xv ) ) );
+	}
+	size_t N = bits / V::bits_per_lane;
+	for( ; i < n; ++i ) {
+		if( p[i] == x ) ++N;
+	}
+	return N;
+}
+
+template<typename T>
+CW_SIMD_TARGET void replace( T* p, size_t n, T old_val, T new_val ) {
+	using V = vec<T>;
+	auto ov = V::set1( old_val );
+	auto nv = V::set1( new_val );
+	size_t i = 0;
+	for( ; i + V::lanes <= n; i += V::lanes ) {
+		auto v = V::load( p + i );
+		V::store( p + i, V::select( V::eq( v, ov ), nv, v ) );
+	}
+	for( ; i < n; ++i ) {
+		if( p[i] == old_val ) p[i] = new_val;
+	}
+}
+
+// the extreme value is found with vector min/max, then located with find,
+// so ties resolve to the first in storage order
+
+template<typename T,typename Less>
+CW_SIMD_TARGET size_t extreme_index( const T* p, size_t n, Less less, std::false_type ) {
+	return size_t( std::min_element( p, p + n, less ) - p );
+}
+
+template<typename T,typename Less>
+CW_SIMD_TARGET size_t extreme_index( const T* p, size_t n, Less less, std::true_type ) {
+	using V = vec<T>;
+	if( n < V::lanes ) {
+		return extreme_index( p, n, less, std::false_type() );
+	}
+	auto m = V::load( p );
+	size_t i = V::lanes;
+	for( ; i + V::lanes <= n; i += V::lanes ) {
+		m = less.pick( m, V::load( p + i ) );
+	}
+	T lanes[ V::lanes ];
+	V::store( lanes, m );
+	T best = lanes[0];
+	for(size_t j=1;j<V::lanes;++j) {
+		if( less( lanes[j], best ) ) best = lanes[j];
+	}
+	for( ; i < n; ++i ) {
+		if( less( p[i], best ) ) best = p[i];
+	}
+	return find( p, n, best );
+}
+
+template<typename T>
+struct min_picker {
+	CW_SIMD_TARGET bool operator()( T x, T y ) const { return x < y; }
+	template<typename Vec>
+	CW_SIMD_TARGET Vec pick( Vec x, Vec y ) const { return vec<T>::min( x, y ); }
+};
+
+template<typename T>
+struct max_picker {
+	CW_SIMD_TARGET bool operator()( T x, T y ) const { return y < x; }
+	template<typename Vec>
+	CW_SIMD_TARGET Vec pick( Vec x, Vec y ) const { return vec<T>::max( x, y ); }
+};
+
+template<typename T>
+CW_SIMD_TARGET size_t min_index( const T* p, size_t n ) {
+	return extreme_index( p, n, min_picker<T>(), std::integral_constant<bool,vec<T>::has_minmax>() );
+}
+
+template<typename T>
+CW_SIMD_TARGET size_t max_index( const T* p, size_t n ) {
+	return extreme_index( p, n, max_picker<T>(), std::integral_constant<bool,vec<T>::has_minmax>() );
+}
+
+// integral values -- the sum modulo 2^64 of the values extended to 64 bits
+template<typename T>
+CW_SIMD_TARGET uint64_t sum( const T* p, size_t n, std::true_type ) {
+	using V = vec<T>;
+	static const size_t words = sizeof( typename V::type ) / sizeof(uint64_t);
+	auto a0 = V::zero();
+	auto a1 = V::zero();
+	size_t i = 0;
+	for( ; i + 2 * V::lanes <= n; i += 2 * V::lanes ) {
+		a0 = V::sum_step( a0, V::load( p + i ) );
+		a1 = V::sum_step( a1, V::load( p + i + V::lanes ) );
+	}
+	uint64_t w0[ words ], w1[ words ];
+	V::store( w0, a0 );
+	V::store( w1, a1 );
+	uint64_t s = uint64_t( V::sum_bias ) * uint64_t( i );
+	for(size_t j=0;j<words;++j) {
+		s += w0[j] + w1[j];
+	}
+	for( ; i < n; ++i ) {
+		s += uint64_t( p[i] );
+	}
+	return s;
+}
+
+// floating-point values -- reassociated across the lanes and accumulators
+template<typename T>
+CW_SIMD_TARGET T sum( const T* p, size_t n, std::false_type ) {
+	using V = vec<T>;
+	auto a0 = V::zero();
+	auto a1 = V::zero();
+	auto a2 = V::zero();
+	auto a3 = V::zero();
+	size_t i = 0;
+	for( ; i + 4 * V::lanes <= n; i += 4 * V::lanes ) {
+		a0 = V::add( a0, V::load( p + i ) );
+		a1 = V::add( a1, V::load( p + i + V::lanes ) );
+		a2 = V::add( a2, V::load( p + i + 2 * V::lanes ) );
+		a3 = V::add( a3, V::load( p + i + 3 * V::lanes ) );
+	}
+	T lanes[ V::lanes ];
+	V::store( lanes, V::add( V::add( a0, a1 ), V::add( a2, a3 ) ) );
+	T s = T(0);
+	for(size_t j=0;j<V::lanes;++j) {
+		s += lanes[j];
+	}
+	for( ; i < n; ++i ) {
+		s += p[i];
+	}
+	return s;
+}
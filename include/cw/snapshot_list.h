@@ -0,0 +1,213 @@
+#ifndef INCLUDED_CW_SNAPSHOT_LIST
+#define INCLUDED_CW_SNAPSHOT_LIST
+#include <cstdint>
+#include <algorithm>
+#include <functional>
+#include <vector>
+#include <memory>
+#include <utility>
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <exception>
+#include <limits>
+#include "list.h"
+
+#if _MSC_VER <= 1800
+#define noexcept throw()
+#endif
+
+namespace cw {
+
+// A cw::list for many readers and few writers. Readers take an immutable
+// snapshot of the list without locking or waiting; a writer copies the list,
+// applies a batch of changes to the copy and publishes it with one atomic
+// exchange. Writers are serialised by a mutex that readers never touch.
+//
+// Old versions are freed by epoch-based reclamation. A reader pins by storing
+// the global epoch in a slot of its own, then loads the current version. The
+// writer retires a replaced version with the epoch after its exchange and
+// frees it once no slot holds an earlier epoch. Both sides are sequentially
+// consistent, so a reader that the writer's scan missed must see the newer
+// version.
+
+// one reader's pinned epoch, on a cache line of its own
+struct alignas(64) snapshot_slot {
+	std::atomic<uint64_t> epoch;
+};
+
+// A pinned, immutable version of the list. The version is kept alive until
+// the snapshot is destroyed, so a snapshot should be short lived.
+template<typename L>
+struct snapshot {
+	using list_type              = L;
+	using value_type             = typename L::value_type;
+	using size_type              = typename L::size_type;
+	using const_iterator         = typename L::const_iterator;
+
+	static const uint64_t idle = std::numeric_limits<uint64_t>::max();
+
+	snapshot( snapshot_slot* slot, const L* p ) : slot(slot), p(p) {}
+
+	snapshot( snapshot&& rhs ) : slot(rhs.slot), p(rhs.p) {
+		rhs.slot = nullptr;
+	}
+
+	snapshot( const snapshot& ) = delete;
+
+	snapshot& operator=( const snapshot& ) = delete;
+
+	~snapshot() {
+		if( slot ) {
+			slot->epoch.store( idle, std::memory_order_release );
+		}
+	}
+
+	const L& operator*() const noexcept { return *p; }
+
+	const L* operator->() const noexcept { return p; }
+
+	const_iterator begin() const noexcept { return p->begin(); }
+
+	const_iterator end() const noexcept { return p->end(); }
+
+	size_type size() const noexcept { return p->size(); }
+
+	bool empty() const noexcept { return p->empty(); }
+
+	snapshot_slot* slot;
+	const L* p;
+};
+
+// T -- the value type
+// U -- the index type, an unsigned integer type
+// A -- the allocator of each version
+template<typename T,typename U = uint32_t,typename A = std::allocator<T>>
+struct snapshot_list {
+	using list_type              = list<T,U,A>;
+	using value_type             = T;
+	using size_type              = size_t;
+	using snapshot_type          = snapshot<list_type>;
+
+	static const uint64_t idle = snapshot_type::idle;
+
+	// the published version
+	std::atomic<list_type*> current;
+
+	std::atomic<uint64_t> epoch;
+
+	// a slot per concurrent reader
+	std::unique_ptr<snapshot_slot[]> slots;
+	size_type nSlots;
+
+	// replaced versions, with the epoch they were retired in. writer only.
+	std::vector<std::pair<list_type*,uint64_t>> retired;
+
+	std::mutex writer;
+
+	// readers -- the most snapshots alive at once, by default four per core
+	explicit snapshot_list( size_type readers = 4 * std::max( std::thread::hardware_concurrency(), 1u ) ) :
+		snapshot_list( list_type(), readers )
+	{}
+
+	explicit snapshot_list( list_type l, size_type readers = 4 * std::max( std::thread::hardware_concurrency(), 1u ) ) :
+		current( new list_type( std::move(l) ) ),
+		epoch( 1 ),
+		slots( new snapshot_slot[ readers ] ),
+		nSlots( readers )
+	{
+		for(size_type i=0;i<nSlots;++i) {
+			slots[i].epoch.store( idle, std::memory_order_relaxed );
+		}
+	}
+
+	snapshot_list( const snapshot_list& ) = delete;
+
+	snapshot_list& operator=( const snapshot_list& ) = delete;
+
+	// no snapshot may outlive the list
+	~snapshot_list() {
+		for( auto& r : retired ) {
+			delete r.first;
+		}
+		delete current.load();
+	}
+
+	// Readers
+
+	// Pin the current version. Claims a free slot, starting from one picked by
+	// the thread id so readers on different threads rarely meet, then loads
+	// the version. No locks, and no waiting on the writer.
+	snapshot_type read() const {
+		size_type start = std::hash<std::thread::id>()( std::this_thread::get_id() ) % nSlots;
+		for(size_type k=0;k<nSlots;++k) {
+			snapshot_slot& slot = slots[ ( start + k ) % nSlots ];
+			uint64_t expected = idle;
+			if( slot.epoch.load( std::memory_order_relaxed ) == idle &&
+			    slot.epoch.compare_exchange_strong( expected, epoch.load() ) ) {
+				return snapshot_type( &slot, current.load() );
+			}
+		}
+		throw std::exception("cw::snapshot_list::read() -- more snapshots than reader slots");
+	}
+
+	// Writers
+
+	// Copy the current version, apply f to the copy, and publish it. A batch of
+	// changes in one f costs one copy.
+	template<typename F>
+	void update( F&& f ) {
+		std::lock_guard<std::mutex> lock( writer );
+		std::unique_ptr<list_type> next( new list_type( *current.load() ) );
+		std::forward<F>(f)( *next );
+		publish_locked( next.release() );
+	}
+
+	// Publish l as the new version
+	void assign( list_type l ) {
+		std::lock_guard<std::mutex> lock( writer );
+		publish_locked( new list_type( std::move(l) ) );
+	}
+
+	// Free the retired versions no reader can still hold, returning the number
+	// left. Called after every publish.
+	size_type reclaim() {
+		std::lock_guard<std::mutex> lock( writer );
+		return reclaim_locked();
+	}
+
+protected:
+
+	void publish_locked( list_type* next ) {
+		list_type* old = current.exchange( next );
+		// readers that pin from here on load next or later
+		uint64_t e = epoch.fetch_add( 1 ) + 1;
+		retired.emplace_back( old, e );
+		reclaim_locked();
+	}
+
+	size_type reclaim_locked() {
+		uint64_t oldest = idle;
+		for(size_type i=0;i<nSlots;++i) {
+			oldest = std::min( oldest, slots[i].epoch.load() );
+		}
+		// a reader pinned with an epoch before e may hold a version retired at e
+		auto kept = std::partition( std::begin(retired), std::end(retired), [oldest]( const std::pair<list_type*,uint64_t>& r ) {
+			return r.second > oldest;
+		});
+		for( auto it = kept; it != std::end(retired); ++it ) {
+			delete it->first;
+		}
+		retired.erase( kept, std::end(retired) );
+		return retired.size();
+	}
+
+};
+
+}
+
+#if _MSC_VER <= 1800
+#undef noexcept
+#endif
+
+#endif
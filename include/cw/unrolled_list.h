@@ -0,0 +1,945 @@
+#ifndef INCLUDED_CW_UNROLLED_LIST
+#define INCLUDED_CW_UNROLLED_LIST
+#include <cstdint>
+#include <algorithm>
+#include <functional>
+#include <vector>
+#include <memory>
+#include <utility>
+#include <exception>
+#include <limits>
+#include <iterator>
+#include <type_traits>
+
+#if _MSC_VER <= 1800
+#define noexcept throw()
+#endif
+
+namespace cw {
+
+// A doubly linked list of blocks, each holding up to K values in order. The
+// values of block b live in slots [b*K,b*K+K) of one vector, and the block
+// links in another, so a walk reads K values for each link it follows.
+//
+// Inserting into a full block splits it in two, or opens a new block when
+// inserting at a block boundary, so pushing at either end fills blocks
+// completely. Erasing merges a block that falls below half full into its
+// neighbour when the two fit in one block.
+//
+// Slots past the count of a block hold default-constructed or moved-from
+// values, so T must be default constructible.
+
+template<typename U>
+struct unrolled_block {
+	U prev;
+	U next;
+	U count;
+};
+
+template<typename L,bool is_const>
+struct unrolled_list_iterator {
+	using value_type             = typename L::value_type;
+	using index_type             = typename L::index_type;
+	using size_type              = size_t;
+	using difference_type        = std::ptrdiff_t;
+	using reference              = typename std::conditional<is_const,const value_type&,value_type&>::type;
+	using pointer                = typename std::conditional<is_const,const value_type*,value_type*>::type;
+	using iterator_category      = std::bidirectional_iterator_tag;
+	using list_type              = typename std::conditional<is_const,const L,L>::type;
+
+	unrolled_list_iterator() = default;
+
+	unrolled_list_iterator( list_type* p, index_type block, index_type offset ) : p(p), block(block), offset(offset) {}
+
+	// iterator to const_iterator
+	template<bool rhs_const,typename = typename std::enable_if<is_const && !rhs_const>::type>
+	unrolled_list_iterator( const unrolled_list_iterator<L,rhs_const>& it ) : p(it.p), block(it.block), offset(it.offset) {}
+
+	reference operator*() const {
+		return p->values[ p->slot( block, offset ) ];
+	}
+
+	pointer operator->() const {
+		return &p->values[ p->slot( block, offset ) ];
+	}
+
+	unrolled_list_iterator& operator++() {
+		p->step_forward( block, offset );
+		return *this;
+	}
+
+	unrolled_list_iterator& operator--() {
+		p->step_back( block, offset );
+		return *this;
+	}
+
+	unrolled_list_iterator operator++(int) {
+		auto old = *this;
+		++(*this);
+		return old;
+	}
+
+	unrolled_list_iterator operator--(int) {
+		auto old = *this;
+		--(*this);
+		return old;
+	}
+
+	bool operator==( const unrolled_list_iterator& rhs ) const {
+		return (p == rhs.p) && (block == rhs.block) && (offset == rhs.offset);
+	}
+
+	bool operator!=( const unrolled_list_iterator& rhs ) const {
+		return !( *this == rhs );
+	}
+
+	list_type* p;
+	index_type block;
+	index_type offset;
+};
+
+// T -- the value type
+// U -- the index type of the blocks, an unsigned integer type
+// K -- the values per block
+// A -- the allocator, rebound separately for the values and the blocks
+template<typename T,typename U = uint32_t,size_t K = 16,typename A = std::allocator<T>>
+struct unrolled_list {
+	using value_type             = T;
+	using index_type             = U;
+	using size_type              = size_t;
+	using difference_type        = std::ptrdiff_t;
+	using reference              = T&;
+	using const_reference        = const T&;
+	using pointer                = T*;
+	using const_pointer          = const T*;
+	using list_type              = unrolled_list<T,U,K,A>;
+	using iterator               = unrolled_list_iterator<list_type,false>;
+	using const_iterator         = unrolled_list_iterator<list_type,true>;
+	using reverse_iterator       = std::reverse_iterator<iterator>;
+	using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+	using allocator_type         = A;
+
+	static_assert( K >= 2 && K < size_t( std::numeric_limits<U>::max() ), "cw::unrolled_list -- K must be at least 2 and fit in index_type" );
+
+	// SFINAE guard for the iterator-pair overloads
+	template<typename It>
+	using is_input_iterator = typename std::enable_if<std::is_convertible<typename std::iterator_traits<It>::iterator_category,std::input_iterator_tag>::value>::type;
+
+	using block_type             = unrolled_block<index_type>;
+	using value_allocator_type   = typename std::allocator_traits<A>::template rebind_alloc<value_type>;
+	using block_allocator_type   = typename std::allocator_traits<A>::template rebind_alloc<block_type>;
+	using values_type            = std::vector<value_type,value_allocator_type>;
+	using blocks_type            = std::vector<block_type,block_allocator_type>;
+
+	static const index_type terminator = index_type(-1);
+
+	static const size_type block_size = K;
+
+	// K slots per block
+	values_type values;
+
+	// free blocks hold the next free block
+	blocks_type blocks;
+
+	index_type head = terminator,
+	           tail = terminator;
+
+	index_type free_head = terminator;
+	size_type length = 0;
+
+	unrolled_list() = default;
+
+	explicit unrolled_list( const allocator_type& alloc ) :
+		values( value_allocator_type(alloc) ),
+		blocks( block_allocator_type(alloc) )
+	{}
+
+	unrolled_list( const list_type& rhs, const allocator_type& alloc ) :
+		values( rhs.values, value_allocator_type(alloc) ),
+		blocks( rhs.blocks, block_allocator_type(alloc) ),
+		head( rhs.head ),
+		tail( rhs.tail ),
+		free_head( rhs.free_head ),
+		length( rhs.length )
+	{}
+
+	unrolled_list( const std::initializer_list<value_type>& rhs, const allocator_type& alloc = allocator_type() ) : unrolled_list(alloc) {
+		assign( rhs );
+	}
+
+	explicit unrolled_list( size_type N, const allocator_type& alloc = allocator_type() ) : unrolled_list(alloc) {
+		resize(N);
+	}
+
+	template<typename InputIt,typename = is_input_iterator<InputIt>>
+	unrolled_list( InputIt first, InputIt last, const allocator_type& alloc = allocator_type() ) : unrolled_list(alloc) {
+		assign( first, last );
+	}
+
+	allocator_type get_allocator() const noexcept {
+		return allocator_type( values.get_allocator() );
+	}
+
+	// Assignment
+
+	list_type& operator=( const std::initializer_list<value_type>& rhs ) {
+		assign( rhs );
+		return *this;
+	}
+
+	void assign( size_type count, const T& value ) {
+		clear();
+		reserve( count );
+		for(size_type i=0;i<count;++i) {
+			emplace_back( value );
+		}
+	}
+
+	template<typename InputIt,typename = is_input_iterator<InputIt>>
+	void assign( InputIt first, InputIt last ) {
+		clear();
+		for( ; first != last; ++first ) {
+			emplace_back( *first );
+		}
+	}
+
+	void assign( const std::initializer_list<T>& rhs ) {
+		clear();
+		reserve( rhs.size() );
+		assign( std::begin(rhs), std::end(rhs) );
+	}
+
+	// Element Access
+
+	value_type& front() { return values[ slot( head, 0 ) ]; }
+
+	const value_type& front() const { return values[ slot( head, 0 ) ]; }
+
+	value_type& back() { return values[ slot( tail, blocks[tail].count - 1 ) ]; }
+
+	const value_type& back() const { return values[ slot( tail, blocks[tail].count - 1 ) ]; }
+
+	// Capacity
+
+	bool empty() const noexcept { return length == 0; }
+
+	size_type size() const noexcept { return length; }
+
+	size_type max_size() const noexcept {
+		size_type max_blocks = size_type( std::numeric_limits<index_type>::max() );
+		return ( max_blocks < std::numeric_limits<size_type>::max() / K ) ? max_blocks * K : std::numeric_limits<size_type>::max();
+	}
+
+	void reserve( size_type N ) {
+		size_type nBlocks = ( N + K - 1 ) / K;
+		values.reserve( nBlocks * K );
+		blocks.reserve( nBlocks );
+	}
+
+	size_type capacity() const noexcept { return values.capacity(); }
+
+	void shrink_to_fit() {
+		values.shrink_to_fit();
+		blocks.shrink_to_fit();
+	}
+
+	// Modifiers
+
+	void clear() noexcept {
+		values.clear();
+		blocks.clear();
+		head = tail = terminator;
+		free_head = terminator;
+		length = 0;
+	}
+
+	// insert before pos, returning an iterator to the new element.
+	// invalidates iterators to elements in the block inserted into, and in the
+	// new block if it was split.
+	iterator insert( const_iterator pos, const value_type& x ) {
+		return emplace( pos, x );
+	}
+
+	iterator insert( const_iterator pos, value_type&& x ) {
+		return emplace( pos, std::move(x) );
+	}
+
+	template<typename InputIt,typename = is_input_iterator<InputIt>>
+	iterator insert( const_iterator pos, InputIt first, InputIt last ) {
+		if( first == last ) return iterator( this, pos.block, pos.offset );
+		iterator result = insert( pos, *first );
+		size_type n = 1;
+		iterator it = result;
+		for( ++first; first != last; ++first, ++n ) {
+			it = insert( std::next(it), *first );
+		}
+		// a later insertion may have split the block holding the first
+		return std::prev( std::next(it), difference_type(n) );
+	}
+
+	iterator insert( const_iterator pos, const std::initializer_list<value_type>& rhs ) {
+		return insert( pos, std::begin(rhs), std::end(rhs) );
+	}
+
+	template<typename... Ts>
+	iterator emplace( const_iterator pos, Ts&&... xs ) {
+		// constructed first, as xs may refer into the storage a new block reallocates
+		value_type x( std::forward<Ts>(xs)... );
+		index_type b = pos.block;
+		index_type i = pos.offset;
+		if( b == terminator ) {
+			// at the end, append to the tail block
+			b = tail;
+			if( b == terminator || blocks[b].count == K ) {
+				b = link_new_block( tail, terminator );
+			}
+			i = blocks[b].count;
+		} else if( i == 0 && blocks[b].prev != terminator && blocks[ blocks[b].prev ].count < K ) {
+			// at the front of a block, append to the block before it
+			b = blocks[b].prev;
+			i = blocks[b].count;
+		} else if( blocks[b].count == K ) {
+			if( i == 0 ) {
+				b = link_new_block( blocks[b].prev, b );
+			} else {
+				split( b );
+				if( i > index_type(K / 2) ) {
+					i = index_type( i - K / 2 );
+					b = blocks[b].next;
+				}
+			}
+		}
+		insert_at( b, i, std::move(x) );
+		return iterator( this, b, i );
+	}
+
+	// erase the element at pos, returning an iterator to the element that followed it.
+	// invalidates iterators to elements in the block erased from and any block merged with it.
+	iterator erase( const_iterator pos ) {
+		index_type b = pos.block;
+		index_type i = pos.offset;
+		size_type s = slot( b, 0 );
+		index_type n = blocks[b].count;
+		std::move( std::begin(values) + s + i + 1, std::begin(values) + s + n, std::begin(values) + s + i );
+		--n;
+		blocks[b].count = n;
+		--length;
+
+		// release any resources held by the erased value
+		static_cast<void>( value_type( std::move( values[ s + n ] ) ) );
+
+		if( n == 0 ) {
+			index_type next = blocks[b].next;
+			release_block( b );
+			return iterator( this, next, 0 );
+		}
+
+		// merge a block below half full with a neighbour that fits alongside it
+		if( n < index_type(K / 2) ) {
+			index_type next = blocks[b].next;
+			index_type prev = blocks[b].prev;
+			if( next != terminator && n + blocks[next].count <= K ) {
+				merge_next( b );
+			} else if( prev != terminator && n + blocks[prev].count <= K ) {
+				i = index_type( i + blocks[prev].count );
+				b = prev;
+				merge_next( b );
+			}
+		}
+		return position( b, i );
+	}
+
+	iterator erase( const_iterator first, const_iterator last ) {
+		size_type n = size_type( std::distance( first, last ) );
+		iterator it( this, first.block, first.offset );
+		for(size_type j=0;j<n;++j) {
+			it = erase( it );
+		}
+		return it;
+	}
+
+	void push_front( const value_type& x ) {
+		emplace( begin(), x );
+	}
+
+	void push_front( value_type&& x ) {
+		emplace( begin(), std::move(x) );
+	}
+
+	void push_back( const value_type& x ) {
+		emplace( end(), x );
+	}
+
+	void push_back( value_type&& x ) {
+		emplace( end(), std::move(x) );
+	}
+
+	template<typename... Ts>
+	void emplace_front( Ts&&... xs ) {
+		emplace( begin(), std::forward<Ts>(xs)... );
+	}
+
+	template<typename... Ts>
+	void emplace_back( Ts&&... xs ) {
+		emplace( end(), std::forward<Ts>(xs)... );
+	}
+
+	void pop_front() {
+		erase( begin() );
+	}
+
+	void pop_back() {
+		erase( const_iterator( this, tail, index_type( blocks[tail].count - 1 ) ) );
+	}
+
+	void resize( size_type N ) {
+		if( N > max_size() ) {
+			throw std::exception("cw::unrolled_list::resize() -- size too big for index_type");
+		}
+		while( size() < N ) {
+			emplace_back();
+		}
+		while( size() > N ) {
+			pop_back();
+		}
+	}
+
+	void resize( size_type N, const value_type& x ) {
+		if( N > max_size() ) {
+			throw std::exception("cw::unrolled_list::resize() -- size too big for index_type");
+		}
+		while( size() < N ) {
+			emplace_back( x );
+		}
+		while( size() > N ) {
+			pop_back();
+		}
+	}
+
+	void swap( unrolled_list& rhs ) {
+		values.swap( rhs.values );
+		blocks.swap( rhs.blocks );
+		std::swap( head, rhs.head );
+		std::swap( tail, rhs.tail );
+		std::swap( free_head, rhs.free_head );
+		std::swap( length, rhs.length );
+	}
+
+	// Iterators
+
+	iterator begin() noexcept {
+		return iterator( this, head, 0 );
+	}
+
+	iterator end() noexcept {
+		return iterator( this, terminator, 0 );
+	}
+
+	const_iterator begin() const noexcept {
+		return const_iterator( this, head, 0 );
+	}
+
+	const_iterator end() const noexcept {
+		return const_iterator( this, terminator, 0 );
+	}
+
+	const_iterator cbegin() const noexcept {
+		return begin();
+	}
+
+	const_iterator cend() const noexcept {
+		return end();
+	}
+
+	reverse_iterator rbegin() noexcept {
+		return reverse_iterator( end() );
+	}
+
+	reverse_iterator rend() noexcept {
+		return reverse_iterator( begin() );
+	}
+
+	const_reverse_iterator rbegin() const noexcept {
+		return const_reverse_iterator( end() );
+	}
+
+	const_reverse_iterator rend() const noexcept {
+		return const_reverse_iterator( begin() );
+	}
+
+	const_reverse_iterator crbegin() const noexcept {
+		return rbegin();
+	}
+
+	const_reverse_iterator crend() const noexcept {
+		return rend();
+	}
+
+	// Operations
+
+	// reverse the values within each block, and the order of the blocks. O(N).
+	void reverse() noexcept {
+		for( index_type b = head; b != terminator; ) {
+			block_type& block = blocks[b];
+			auto first = std::begin(values) + slot( b, 0 );
+			std::reverse( first, first + block.count );
+			std::swap( block.prev, block.next );
+			b = block.prev;
+		}
+		std::swap( head, tail );
+	}
+
+	// Remove the matching elements, returning the number removed. Each block is
+	// filtered in place, then the sparse blocks are merged. O(N).
+	// Invalidates all iterators.
+	size_type remove( const T& value ) {
+		return remove_if( [&]( const value_type& x ){ return x == value; } );
+	}
+
+	template<typename Pred>
+	size_type remove_if( Pred pred ) {
+		size_type N = 0;
+		for( index_type b = head; b != terminator; ) {
+			index_type next = blocks[b].next;
+			auto first = std::begin(values) + slot( b, 0 );
+			auto last = first + blocks[b].count;
+			auto kept = std::remove_if( first, last, pred );
+			N += size_type( last - kept );
+			shrink_block( b, index_type( kept - first ) );
+			b = next;
+		}
+		coalesce();
+		return N;
+	}
+
+	// Delete consecutive repeated values, keeping the first of each run. The
+	// last value kept is never moved by a later block, so it is compared in place.
+	// Invalidates all iterators.
+	template<typename Comp>
+	size_type unique( Comp comp ) {
+		size_type N = 0;
+		const value_type* last = nullptr;
+		for( index_type b = head; b != terminator; ) {
+			index_type next = blocks[b].next;
+			size_type s = slot( b, 0 );
+			index_type n = blocks[b].count;
+			index_type kept = 0;
+			for(index_type i=0;i<n;++i) {
+				if( last && comp( *last, values[ s + i ] ) ) {
+					++N;
+					continue;
+				}
+				if( kept != i ) {
+					values[ s + kept ] = std::move( values[ s + i ] );
+				}
+				last = &values[ s + kept ];
+				++kept;
+			}
+			shrink_block( b, kept );
+			b = next;
+		}
+		coalesce();
+		return N;
+	}
+
+	size_type unique() {
+		return unique( std::equal_to<>() );
+	}
+
+	// gather the values into list order, sort them, then refill the blocks. stable.
+	// invalidates all iterators.
+	template<typename Comp>
+	void sort( Comp comp ) {
+		values_type ordered = gather();
+		std::stable_sort( std::begin(ordered), std::end(ordered), comp );
+		pack( std::move(ordered) );
+	}
+
+	void sort() {
+		sort( std::less<>() );
+	}
+
+	template<typename Comp>
+	void merge( list_type& rhs, Comp comp ) {
+		merge( std::move(rhs), comp );
+
+		// rhs is now empty
+		rhs.clear();
+	}
+
+	// merge two sorted lists into full blocks. stable. invalidates all iterators.
+	template<typename Comp>
+	void merge( list_type&& rhs, Comp comp ) {
+		if( this == &rhs || rhs.empty() ) return;
+		if( size() + rhs.size() > max_size() ) {
+			throw std::exception("cw::unrolled_list merge -- too big for index_type");
+		}
+		values_type left = gather();
+		values_type right = rhs.gather();
+		values_type ordered( values.get_allocator() );
+		ordered.reserve( left.size() + right.size() );
+		std::merge( std::make_move_iterator( std::begin(left) ), std::make_move_iterator( std::end(left) ),
+		            std::make_move_iterator( std::begin(right) ), std::make_move_iterator( std::end(right) ),
+		            std::back_inserter( ordered ), comp );
+		pack( std::move(ordered) );
+	}
+
+	void merge( list_type& rhs ) {
+		merge( rhs, std::less<>() );
+	}
+
+	void merge( list_type&& rhs ) {
+		merge( std::move(rhs), std::less<>() );
+	}
+
+	void splice( const_iterator pos, list_type& rhs ) {
+		splice( pos, std::move(rhs) );
+		rhs.clear();
+	}
+
+	void splice( const_iterator pos, list_type&& rhs ) {
+		if( size() + rhs.size() > max_size() ) {
+			throw std::exception("cw::unrolled_list splice -- too big for index_type");
+		}
+		insert( pos, std::make_move_iterator( rhs.begin() ), std::make_move_iterator( rhs.end() ) );
+	}
+
+	void splice( const_iterator pos, list_type& rhs, const_iterator it ) {
+		if( this == &rhs ) {
+			move_within( pos, it, std::next(it) );
+			return;
+		}
+		splice( pos, std::move(rhs), it );
+		rhs.erase( it );
+	}
+
+	void splice( const_iterator pos, list_type&& rhs, const_iterator it ) {
+		if( this == &rhs ) {
+			move_within( pos, it, std::next(it) );
+			return;
+		}
+		insert( pos, std::move( rhs.values[ rhs.slot( it.block, it.offset ) ] ) );
+	}
+
+	void splice( const_iterator pos, list_type& rhs, const_iterator first, const_iterator last ) {
+		if( this == &rhs ) {
+			move_within( pos, first, last );
+			return;
+		}
+		splice( pos, std::move(rhs), first, last );
+		rhs.erase( first, last );
+	}
+
+	void splice( const_iterator pos, list_type&& rhs, const_iterator first, const_iterator last ) {
+		if( this == &rhs ) {
+			move_within( pos, first, last );
+			return;
+		}
+		insert( pos, std::make_move_iterator( iterator( &rhs, first.block, first.offset ) ),
+		             std::make_move_iterator( iterator( &rhs, last.block, last.offset ) ) );
+	}
+
+	// Compaction
+
+	// Rewrite the storage into list order with every block full, dropping the
+	// free blocks. O(N). Invalidates all iterators.
+	void compact() {
+		pack( gather() );
+	}
+
+	friend iterator;
+	friend const_iterator;
+
+protected:
+
+	// Iteration
+
+	static size_type slot( index_type b, index_type i ) noexcept {
+		return size_type(b) * K + i;
+	}
+
+	// stepping from the end wraps to the head, or back to the tail
+	void step_forward( index_type& b, index_type& i ) const {
+		if( b == terminator ) {
+			b = head;
+			i = 0;
+		} else if( ++i == blocks[b].count ) {
+			b = blocks[b].next;
+			i = 0;
+		}
+	}
+
+	void step_back( index_type& b, index_type& i ) const {
+		if( i > 0 ) {
+			--i;
+			return;
+		}
+		b = ( b == terminator ) ? tail : blocks[b].prev;
+		i = ( b == terminator ) ? index_type(0) : index_type( blocks[b].count - 1 );
+	}
+
+	// the position of the element at it, or size() for end(). O(N/K).
+	size_type position_of( const_iterator it ) const {
+		if( it.block == terminator ) return length;
+		size_type n = 0;
+		for( index_type b = head; b != it.block; b = blocks[b].next ) {
+			n += blocks[b].count;
+		}
+		return n + it.offset;
+	}
+
+	// an iterator to the element at position n, or end() if n == size(). O(N/K).
+	iterator nth( size_type n ) {
+		index_type b = head;
+		for( ; b != terminator && n >= blocks[b].count; b = blocks[b].next ) {
+			n -= blocks[b].count;
+		}
+		return iterator( this, b, index_type( b == terminator ? 0 : n ) );
+	}
+
+	// Splice within the list -- the insertions and erasures reshape the blocks
+	// under the iterators, so the elements in [first,last) are moved out, erased,
+	// and inserted again at the position pos had. pos must not be in [first,last).
+	void move_within( const_iterator pos, const_iterator first, const_iterator last ) {
+		size_type from = position_of( first );
+		size_type to = position_of( last );
+		size_type at = position_of( pos );
+		if( from == to || at == to ) return;
+		values_type moved( std::make_move_iterator( iterator( this, first.block, first.offset ) ),
+		                   std::make_move_iterator( iterator( this, last.block, last.offset ) ),
+		                   values.get_allocator() );
+		erase( first, last );
+		if( at > from ) {
+			at -= to - from;
+		}
+		insert( nth( at ), std::make_move_iterator( std::begin(moved) ), std::make_move_iterator( std::end(moved) ) );
+	}
+
+	// an iterator to offset i of block b, where i may be one past its last value
+	iterator position( index_type b, index_type i ) {
+		if( i == blocks[b].count ) {
+			return iterator( this, blocks[b].next, 0 );
+		}
+		return iterator( this, b, i );
+	}
+
+	// Blocks
+
+	// an empty block from the free list, or from the back of the storage, linked
+	// in between the adjacent prev and next
+	index_type link_new_block( index_type prev, index_type next ) {
+		index_type b = free_head;
+		if( b == terminator ) {
+			if( blocks.size() >= size_type( std::numeric_limits<index_type>::max() ) ) {
+				throw std::exception("cw::unrolled_list -- too many blocks for index_type");
+			}
+			b = index_type( blocks.size() );
+			values.resize( values.size() + K );
+			blocks.push_back( block_type{ terminator, terminator, 0 } );
+		} else {
+			free_head = blocks[b].next;
+		}
+		blocks[b] = block_type{ prev, next, 0 };
+		if( prev == terminator ) {
+			head = b;
+		} else {
+			blocks[prev].next = b;
+		}
+		if( next == terminator ) {
+			tail = b;
+		} else {
+			blocks[next].prev = b;
+		}
+		return b;
+	}
+
+	// unlink the empty block b. a block at the back of the storage is dropped.
+	void release_block( index_type b ) {
+		index_type prev = blocks[b].prev;
+		index_type next = blocks[b].next;
+		if( prev == terminator ) {
+			head = next;
+		} else {
+			blocks[prev].next = next;
+		}
+		if( next == terminator ) {
+			tail = prev;
+		} else {
+			blocks[next].prev = prev;
+		}
+
+		if( b == index_type( blocks.size() - 1 ) ) {
+			blocks.pop_back();
+			values.resize( values.size() - K );
+			return;
+		}
+		blocks[b] = block_type{ terminator, free_head, 0 };
+		free_head = b;
+	}
+
+	// put x at offset i of block b, which has room
+	void insert_at( index_type b, index_type i, value_type&& x ) {
+		size_type s = slot( b, 0 );
+		index_type n = blocks[b].count;
+		std::move_backward( std::begin(values) + s + i, std::begin(values) + s + n, std::begin(values) + s + n + 1 );
+		values[ s + i ] = std::move(x);
+		blocks[b].count = index_type( n + 1 );
+		++length;
+	}
+
+	// move the upper half of the full block b into a new block after it
+	void split( index_type b ) {
+		index_type c = link_new_block( b, blocks[b].next );
+		index_type half = index_type( K / 2 );
+		auto first = std::begin(values) + slot( b, half );
+		std::move( first, first + ( K - half ), std::begin(values) + slot( c, 0 ) );
+		blocks[b].count = half;
+		blocks[c].count = index_type( K - half );
+	}
+
+	// move the values of the block after b to the end of b, and release it
+	void merge_next( index_type b ) {
+		index_type c = blocks[b].next;
+		index_type n = blocks[b].count;
+		index_type m = blocks[c].count;
+		auto first = std::begin(values) + slot( c, 0 );
+		std::move( first, first + m, std::begin(values) + slot( b, n ) );
+		for(index_type i=0;i<m;++i) {
+			static_cast<void>( value_type( std::move( values[ slot( c, i ) ] ) ) );
+		}
+		blocks[b].count = index_type( n + m );
+		blocks[c].count = 0;
+		release_block( c );
+	}
+
+	// cut block b down to its first n values, releasing it if empty
+	void shrink_block( index_type b, index_type n ) {
+		for(index_type i=n;i<blocks[b].count;++i) {
+			static_cast<void>( value_type( std::move( values[ slot( b, i ) ] ) ) );
+		}
+		length -= blocks[b].count - n;
+		blocks[b].count = n;
+		if( n == 0 ) {
+			release_block( b );
+		}
+	}
+
+	// merge each block with those after it while they fit together. O(N).
+	void coalesce() {
+		for( index_type b = head; b != terminator; b = blocks[b].next ) {
+			while( blocks[b].next != terminator && blocks[b].count + blocks[ blocks[b].next ].count <= K ) {
+				merge_next( b );
+			}
+		}
+	}
+
+	// Compaction
+
+	// move the values out in list order
+	values_type gather() {
+		values_type ordered( values.get_allocator() );
+		ordered.reserve( length );
+		for( index_type b = head; b != terminator; b = blocks[b].next ) {
+			auto first = std::begin(values) + slot( b, 0 );
+			ordered.insert( std::end(ordered), std::make_move_iterator( first ), std::make_move_iterator( first + blocks[b].count ) );
+		}
+		return ordered;
+	}
+
+	// take the ordered values as the storage, in full blocks linked in storage order
+	void pack( values_type&& ordered ) {
+		size_type N = ordered.size();
+		size_type nBlocks = ( N + K - 1 ) / K;
+		if( nBlocks > size_type( std::numeric_limits<index_type>::max() ) ) {
+			throw std::exception("cw::unrolled_list -- too many blocks for index_type");
+		}
+		ordered.resize( nBlocks * K );
+		values.swap( ordered );
+		blocks.resize( nBlocks );
+		for(size_type b=0;b<nBlocks;++b) {
+			index_type prev = ( b == 0 ) ? terminator : index_type(b - 1);
+			index_type next = ( b + 1 == nBlocks ) ? terminator : index_type(b + 1);
+			index_type count = ( b + 1 == nBlocks ) ? index_type( N - b * K ) : index_type(K);
+			blocks[b] = block_type{ prev, next, count };
+		}
+		head = ( nBlocks > 0 ) ? index_type(0) : terminator;
+		tail = ( nBlocks > 0 ) ? index_type(nBlocks - 1) : terminator;
+		free_head = terminator;
+		length = N;
+	}
+
+};
+
+template<typename T,size_t K = 16>
+using unrolled_list8 = unrolled_list<T,uint8_t,K>;
+
+template<typename T,size_t K = 16>
+using unrolled_list16 = unrolled_list<T,uint16_t,K>;
+
+template<typename T,size_t K = 16>
+using unrolled_list32 = unrolled_list<T,uint32_t,K>;
+
+template<typename T,size_t K = 16>
+using unrolled_list64 = unrolled_list<T,uint64_t,K>;
+
+// Erasure
+
+template<typename T, typename U, size_t K, typename A, typename Pred>
+size_t erase_if( cw::unrolled_list<T,U,K,A>& c, Pred pred ) {
+	return c.remove_if( pred );
+}
+
+template<typename T, typename U, size_t K, typename A, typename V>
+size_t erase( cw::unrolled_list<T,U,K,A>& c, const V& value ) {
+	return c.remove_if( [&]( const T& x ){ return x == value; } );
+}
+
+// Operators
+
+template<typename T, typename U, size_t K, typename A>
+bool operator==( const cw::unrolled_list<T,U,K,A>& lhs, const cw::unrolled_list<T,U,K,A>& rhs ) {
+	if( lhs.size() != rhs.size() ) return false;
+	return std::equal( lhs.begin(), lhs.end(), rhs.begin() );
+}
+
+template<typename T, typename U, size_t K, typename A>
+bool operator!=( const cw::unrolled_list<T,U,K,A>& lhs, const cw::unrolled_list<T,U,K,A>& rhs ) {
+	return !(lhs == rhs);
+}
+
+template<typename T, typename U, size_t K, typename A>
+bool operator<( const cw::unrolled_list<T,U,K,A>& lhs, const cw::unrolled_list<T,U,K,A>& rhs ) {
+	return std::lexicographical_compare( lhs.begin(), lhs.end(), rhs.begin(), rhs.end() );
+}
+
+template<typename T, typename U, size_t K, typename A>
+bool operator>( const cw::unrolled_list<T,U,K,A>& lhs, const cw::unrolled_list<T,U,K,A>& rhs ) {
+	return rhs < lhs;
+}
+
+template<typename T, typename U, size_t K, typename A>
+bool operator<=( const cw::unrolled_list<T,U,K,A>& lhs, const cw::unrolled_list<T,U,K,A>& rhs ) {
+	return !(rhs < lhs);
+}
+
+template<typename T, typename U, size_t K, typename A>
+bool operator>=( const cw::unrolled_list<T,U,K,A>& lhs, const cw::unrolled_list<T,U,K,A>& rhs ) {
+	return !(lhs < rhs);
+}
+
+}
+
+namespace std {
+
+template<typename T, typename U, size_t K, typename A>
+void swap( cw::unrolled_list<T,U,K,A>& lhs, cw::unrolled_list<T,U,K,A>& rhs ) {
+	lhs.swap(rhs);
+}
+
+}
+
+#if _MSC_VER <= 1800
+#undef noexcept
+#endif
+
+#endif
@@ -0,0 +1,667 @@
+#ifndef INCLUDED_CW_XOR_LIST
+#define INCLUDED_CW_XOR_LIST
+#include <cstdint>
+#include <algorithm>
+#include <functional>
+#include <vector>
+#include <memory>
+#include <utility>
+#include <exception>
+#include <limits>
+#include <iterator>
+#include <type_traits>
+
+#if _MSC_VER <= 1800
+#define noexcept throw()
+#endif
+
+namespace cw {
+
+// A doubly linked list stored in two vectors -- the values, and one link per
+// slot holding prev ^ next. Half the link memory of cw::list.
+//
+// A slot's neighbours can only be recovered from one of them, so iterators
+// carry the index of the previous element along with their own. Inserting or
+// erasing an element invalidates iterators to its neighbours, as their
+// carried prev index goes stale.
+//
+// Erased slots go on a free list and are reused by later insertions. Once more
+// than half the storage is free, the list is walked from the head and gathered
+// into list order, which needs no neighbour of any single slot.
+
+template<typename L,bool is_const>
+struct xor_list_iterator {
+	using value_type             = typename L::value_type;
+	using index_type             = typename L::index_type;
+	using size_type              = size_t;
+	using difference_type        = std::ptrdiff_t;
+	using reference              = typename std::conditional<is_const,const value_type&,value_type&>::type;
+	using pointer                = typename std::conditional<is_const,const value_type*,value_type*>::type;
+	using iterator_category      = std::bidirectional_iterator_tag;
+	using list_type              = typename std::conditional<is_const,const L,L>::type;
+
+	xor_list_iterator() = default;
+
+	xor_list_iterator( list_type* p, index_type prev, index_type index ) : p(p), prev(prev), index(index) {}
+
+	// iterator to const_iterator
+	template<bool rhs_const,typename = typename std::enable_if<is_const && !rhs_const>::type>
+	xor_list_iterator( const xor_list_iterator<L,rhs_const>& it ) : p(it.p), prev(it.prev), index(it.index) {}
+
+	reference operator*() const {
+		return p->values[index];
+	}
+
+	pointer operator->() const {
+		return &p->values[index];
+	}
+
+	// the end iterator carries the tail as its prev, so it can step back
+	xor_list_iterator& operator++() {
+		index_type next = p->next_index( prev, index );
+		prev = index;
+		index = next;
+		return *this;
+	}
+
+	xor_list_iterator& operator--() {
+		index_type before = p->prev_index( prev, index );
+		index = prev;
+		prev = before;
+		return *this;
+	}
+
+	xor_list_iterator operator++(int) {
+		auto old = *this;
+		++(*this);
+		return old;
+	}
+
+	xor_list_iterator operator--(int) {
+		auto old = *this;
+		--(*this);
+		return old;
+	}
+
+	bool operator==( const xor_list_iterator& rhs ) const {
+		return (p == rhs.p) && (index == rhs.index);
+	}
+
+	bool operator!=( const xor_list_iterator& rhs ) const {
+		return !( *this == rhs );
+	}
+
+	list_type* p;
+	index_type prev;
+	index_type index;
+};
+
+// T -- the value type
+// U -- the index type, an unsigned integer type
+// A -- the allocator, rebound separately for the values and the links
+template<typename T,typename U = uint32_t,typename A = std::allocator<T>>
+struct xor_list {
+	using value_type             = T;
+	using index_type             = U;
+	using size_type              = size_t;
+	using difference_type        = std::ptrdiff_t;
+	using reference              = T&;
+	using const_reference        = const T&;
+	using pointer                = T*;
+	using const_pointer          = const T*;
+	using list_type              = xor_list<T,U,A>;
+	using iterator               = xor_list_iterator<list_type,false>;
+	using const_iterator         = xor_list_iterator<list_type,true>;
+	using reverse_iterator       = std::reverse_iterator<iterator>;
+	using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+	using allocator_type         = A;
+
+	// SFINAE guard for the iterator-pair overloads
+	template<typename It>
+	using is_input_iterator = typename std::enable_if<std::is_convertible<typename std::iterator_traits<It>::iterator_category,std::input_iterator_tag>::value>::type;
+
+	using value_allocator_type   = typename std::allocator_traits<A>::template rebind_alloc<value_type>;
+	using link_allocator_type    = typename std::allocator_traits<A>::template rebind_alloc<index_type>;
+	using values_type            = std::vector<value_type,value_allocator_type>;
+	using links_type             = std::vector<index_type,link_allocator_type>;
+
+	static const index_type terminator = index_type(-1);
+
+	values_type values;
+
+	// prev ^ next, with the terminator standing in for a missing neighbour.
+	// free slots hold the next free slot.
+	links_type links;
+
+	index_type head = terminator,
+	           tail = terminator;
+
+	index_type free_head = terminator;
+	size_type free_count = 0;
+
+	xor_list() = default;
+
+	explicit xor_list( const allocator_type& alloc ) :
+		values( value_allocator_type(alloc) ),
+		links( link_allocator_type(alloc) )
+	{}
+
+	xor_list( const list_type& rhs, const allocator_type& alloc ) :
+		values( rhs.values, value_allocator_type(alloc) ),
+		links( rhs.links, link_allocator_type(alloc) ),
+		head( rhs.head ),
+		tail( rhs.tail ),
+		free_head( rhs.free_head ),
+		free_count( rhs.free_count )
+	{}
+
+	xor_list( const std::initializer_list<value_type>& rhs, const allocator_type& alloc = allocator_type() ) : xor_list(alloc) {
+		assign( rhs );
+	}
+
+	explicit xor_list( size_type N, const allocator_type& alloc = allocator_type() ) : xor_list(alloc) {
+		resize(N);
+	}
+
+	template<typename InputIt,typename = is_input_iterator<InputIt>>
+	xor_list( InputIt first, InputIt last, const allocator_type& alloc = allocator_type() ) : xor_list(alloc) {
+		assign( first, last );
+	}
+
+	allocator_type get_allocator() const noexcept {
+		return allocator_type( values.get_allocator() );
+	}
+
+	// Assignment
+
+	list_type& operator=( const std::initializer_list<value_type>& rhs ) {
+		assign( rhs );
+		return *this;
+	}
+
+	void assign( size_type count, const T& value ) {
+		if( count > max_size() ) {
+			throw std::exception("cw::xor_list::assign() -- size too big for index_type");
+		}
+		values.assign( count, value );
+		set_default_links();
+	}
+
+	template<typename InputIt,typename = is_input_iterator<InputIt>>
+	void assign( InputIt first, InputIt last ) {
+		values.assign( first, last );
+		if( values.size() > max_size() ) {
+			clear();
+			throw std::exception("cw::xor_list::assign() -- size too big for index_type");
+		}
+		set_default_links();
+	}
+
+	void assign( const std::initializer_list<T>& rhs ) {
+		assign( std::begin(rhs), std::end(rhs) );
+	}
+
+	// Element Access
+
+	value_type& front() { return values[head]; }
+
+	const value_type& front() const { return values[head]; }
+
+	value_type& back() { return values[tail]; }
+
+	const value_type& back() const { return values[tail]; }
+
+	// Capacity
+
+	bool empty() const noexcept { return head == terminator; }
+
+	size_type size() const noexcept { return links.size() - free_count; }
+
+	size_type max_size() const noexcept { return std::numeric_limits<index_type>::max(); }
+
+	void reserve( size_type N ) {
+		values.reserve(N);
+		links.reserve(N);
+	}
+
+	size_type capacity() const noexcept { return values.capacity(); }
+
+	void shrink_to_fit() {
+		values.shrink_to_fit();
+		links.shrink_to_fit();
+	}
+
+	// Modifiers
+
+	void clear() noexcept {
+		values.clear();
+		links.clear();
+		head = tail = terminator;
+		free_head = terminator;
+		free_count = 0;
+	}
+
+	// insert before pos, returning an iterator to the new element.
+	// invalidates pos and any other iterator to the element at pos.
+	iterator insert( const_iterator pos, const value_type& x ) {
+		return link_between( pos.prev, pos.index, new_slot( x ) );
+	}
+
+	iterator insert( const_iterator pos, value_type&& x ) {
+		return link_between( pos.prev, pos.index, new_slot( std::move(x) ) );
+	}
+
+	template<typename InputIt,typename = is_input_iterator<InputIt>>
+	iterator insert( const_iterator pos, InputIt first, InputIt last ) {
+		if( first == last ) return iterator( this, pos.prev, pos.index );
+		iterator it = insert( pos, *first );
+		iterator result = it;
+		for( ++first; first != last; ++first ) {
+			it = link_between( it.index, pos.index, new_slot( *first ) );
+		}
+		return iterator( this, pos.prev, result.index );
+	}
+
+	iterator insert( const_iterator pos, const std::initializer_list<value_type>& rhs ) {
+		return insert( pos, std::begin(rhs), std::end(rhs) );
+	}
+
+	template<typename... Ts>
+	iterator emplace( const_iterator pos, Ts&&... xs ) {
+		return link_between( pos.prev, pos.index, new_slot( std::forward<Ts>(xs)... ) );
+	}
+
+	// erase the element at pos, returning an iterator to the element that followed it.
+	// invalidates iterators to the erased element and its neighbours, and all
+	// iterators if the free slots are reclaimed.
+	iterator erase( const_iterator pos ) {
+		index_type next = unlink( pos.prev, pos.index );
+		if( should_reclaim() ) {
+			return compact_at( next );
+		}
+		return iterator( this, pos.prev, next );
+	}
+
+	iterator erase( const_iterator first, const_iterator last ) {
+		index_type prev = first.prev;
+		index_type index = first.index;
+		while( index != last.index ) {
+			index = unlink( prev, index );
+		}
+		if( should_reclaim() ) {
+			return compact_at( index );
+		}
+		return iterator( this, prev, index );
+	}
+
+	void push_front( const value_type& x ) {
+		link_between( terminator, head, new_slot( x ) );
+	}
+
+	void push_front( value_type&& x ) {
+		link_between( terminator, head, new_slot( std::move(x) ) );
+	}
+
+	void push_back( const value_type& x ) {
+		link_between( tail, terminator, new_slot( x ) );
+	}
+
+	void push_back( value_type&& x ) {
+		link_between( tail, terminator, new_slot( std::move(x) ) );
+	}
+
+	template<typename... Ts>
+	void emplace_front( Ts&&... xs ) {
+		link_between( terminator, head, new_slot( std::forward<Ts>(xs)... ) );
+	}
+
+	template<typename... Ts>
+	void emplace_back( Ts&&... xs ) {
+		link_between( tail, terminator, new_slot( std::forward<Ts>(xs)... ) );
+	}
+
+	void pop_front() {
+		unlink( terminator, head );
+		apply_reclaim();
+	}
+
+	void pop_back() {
+		unlink( index_type( links[tail] ^ terminator ), tail );
+		apply_reclaim();
+	}
+
+	void resize( size_type N ) {
+		if( N > max_size() ) {
+			throw std::exception("cw::xor_list::resize() -- size too big for index_type");
+		}
+		while( size() < N ) {
+			emplace_back();
+		}
+		while( size() > N ) {
+			unlink( index_type( links[tail] ^ terminator ), tail );
+		}
+		apply_reclaim();
+	}
+
+	void swap( xor_list& rhs ) {
+		values.swap( rhs.values );
+		links.swap( rhs.links );
+		std::swap( head, rhs.head );
+		std::swap( tail, rhs.tail );
+		std::swap( free_head, rhs.free_head );
+		std::swap( free_count, rhs.free_count );
+	}
+
+	// Iterators
+
+	iterator begin() noexcept {
+		return iterator( this, terminator, head );
+	}
+
+	iterator end() noexcept {
+		return iterator( this, tail, terminator );
+	}
+
+	const_iterator begin() const noexcept {
+		return const_iterator( this, terminator, head );
+	}
+
+	const_iterator end() const noexcept {
+		return const_iterator( this, tail, terminator );
+	}
+
+	const_iterator cbegin() const noexcept {
+		return begin();
+	}
+
+	const_iterator cend() const noexcept {
+		return end();
+	}
+
+	reverse_iterator rbegin() noexcept {
+		return reverse_iterator( end() );
+	}
+
+	reverse_iterator rend() noexcept {
+		return reverse_iterator( begin() );
+	}
+
+	const_reverse_iterator rbegin() const noexcept {
+		return const_reverse_iterator( end() );
+	}
+
+	const_reverse_iterator rend() const noexcept {
+		return const_reverse_iterator( begin() );
+	}
+
+	const_reverse_iterator crbegin() const noexcept {
+		return rbegin();
+	}
+
+	const_reverse_iterator crend() const noexcept {
+		return rend();
+	}
+
+	// Operations
+
+	// O(1) -- a link reads the same in both directions
+	void reverse() noexcept {
+		std::swap( head, tail );
+	}
+
+	// Remove the matching elements, returning the number removed. O(N).
+	size_type remove( const T& value ) {
+		return remove_if( [&]( const value_type& x ){ return x == value; } );
+	}
+
+	template<typename Pred>
+	size_type remove_if( Pred pred ) {
+		size_type N = 0;
+		index_type prev = terminator;
+		for( index_type i = head; i != terminator; ) {
+			if( pred( values[i] ) ) {
+				i = unlink( prev, i );
+				++N;
+			} else {
+				index_type next = next_index( prev, i );
+				prev = i;
+				i = next;
+			}
+		}
+		apply_reclaim();
+		return N;
+	}
+
+	// gather the values into list order, then sort them in place. stable.
+	// invalidates all iterators.
+	template<typename Comp>
+	void sort( Comp comp ) {
+		compact();
+		std::stable_sort( std::begin(values), std::end(values), comp );
+	}
+
+	void sort() {
+		sort( std::less<>() );
+	}
+
+	// Compaction
+
+	// Rewrite the storage into list order, dropping the free slots.
+	// O(N). Invalidates all iterators.
+	void compact() {
+		values_type ordered( values.get_allocator() );
+		ordered.reserve( size() );
+		for( index_type prev = terminator, i = head; i != terminator; ) {
+			ordered.push_back( std::move( values[i] ) );
+			index_type next = next_index( prev, i );
+			prev = i;
+			i = next;
+		}
+		values.swap( ordered );
+		set_default_links();
+	}
+
+	friend iterator;
+	friend const_iterator;
+
+protected:
+
+	// Assignment
+
+	// link the values as a straight chain
+	void set_default_links() {
+		size_type N = values.size();
+		links.resize( N );
+		for(size_type i=0;i<N;++i) {
+			index_type prev = ( i == 0 ) ? terminator : index_type(i - 1);
+			index_type next = ( i + 1 == N ) ? terminator : index_type(i + 1);
+			links[i] = index_type( prev ^ next );
+		}
+		head = ( N > 0 ) ? index_type(0) : terminator;
+		tail = ( N > 0 ) ? index_type(N - 1) : terminator;
+		free_head = terminator;
+		free_count = 0;
+	}
+
+	// Iteration
+
+	// the neighbour of index on the other side from prev.
+	// stepping from the terminator wraps to the head, or back to the tail.
+	index_type next_index( index_type prev, index_type index ) const {
+		if( index == terminator ) return head;
+		return index_type( links[index] ^ prev );
+	}
+
+	index_type prev_index( index_type prev, index_type index ) const {
+		if( prev == terminator ) return tail;
+		return index_type( links[prev] ^ index );
+	}
+
+	// compact, returning an iterator to the element that was at index.
+	// compaction relabels the slots, so the element is found by its position.
+	iterator compact_at( index_type index ) {
+		size_type n = 0;
+		for( index_type prev = terminator, i = head; i != index; ++n ) {
+			index_type next = next_index( prev, i );
+			prev = i;
+			i = next;
+		}
+		compact();
+		index_type prev = ( n == 0 ) ? terminator : index_type(n - 1);
+		return iterator( this, prev, ( n == size() ) ? terminator : index_type(n) );
+	}
+
+	// Modifiers
+
+	// construct a value in a free slot, or at the back of the storage. the slot is unlinked.
+	template<typename... Ts>
+	index_type new_slot( Ts&&... xs ) {
+		if( free_head == terminator ) {
+			index_type N = index_type(links.size());
+			if( links.size() >= max_size() ) {
+				throw std::exception("cw::xor_list -- size too big for index_type");
+			}
+			values.emplace_back( std::forward<Ts>(xs)... );
+			links.push_back( index_type(terminator) );
+			return N;
+		}
+		index_type index = free_head;
+		values[ index ] = value_type( std::forward<Ts>(xs)... );
+		free_head = links[ index ];
+		--free_count;
+		return index;
+	}
+
+	// link the unlinked slot N in between the adjacent prev and next
+	iterator link_between( index_type prev, index_type next, index_type N ) {
+		links[N] = index_type( prev ^ next );
+		if( prev == terminator ) {
+			head = N;
+		} else {
+			links[prev] ^= index_type( next ^ N );
+		}
+		if( next == terminator ) {
+			tail = N;
+		} else {
+			links[next] ^= index_type( prev ^ N );
+		}
+		return iterator( this, prev, N );
+	}
+
+	// unlink and free the element at index, whose predecessor is prev,
+	// returning the element that followed it. an element in the back slot is
+	// dropped from the storage instead.
+	index_type unlink( index_type prev, index_type index ) {
+		index_type next = index_type( links[index] ^ prev );
+		if( prev == terminator ) {
+			head = next;
+		} else {
+			links[prev] ^= index_type( index ^ next );
+		}
+		if( next == terminator ) {
+			tail = prev;
+		} else {
+			links[next] ^= index_type( index ^ prev );
+		}
+
+		if( index == index_type(links.size() - 1) ) {
+			values.pop_back();
+			links.pop_back();
+			return next;
+		}
+
+		// release any resources held by the erased value
+		static_cast<void>( value_type( std::move( values[index] ) ) );
+
+		links[index] = free_head;
+		free_head = index;
+		++free_count;
+		return next;
+	}
+
+	// compact once the free slots are more than half the storage
+	bool should_reclaim() const {
+		return 2 * free_count > links.size();
+	}
+
+	void apply_reclaim() {
+		if( should_reclaim() ) {
+			compact();
+		}
+	}
+
+};
+
+template<typename T>
+using xor_list8 = xor_list<T,uint8_t>;
+
+template<typename T>
+using xor_list16 = xor_list<T,uint16_t>;
+
+template<typename T>
+using xor_list32 = xor_list<T,uint32_t>;
+
+template<typename T>
+using xor_list64 = xor_list<T,uint64_t>;
+
+// Erasure
+
+template<typename T, typename U, typename A, typename Pred>
+size_t erase_if( cw::xor_list<T,U,A>& c, Pred pred ) {
+	return c.remove_if( pred );
+}
+
+template<typename T, typename U, typename A, typename V>
+size_t erase( cw::xor_list<T,U,A>& c, const V& value ) {
+	return c.remove_if( [&]( const T& x ){ return x == value; } );
+}
+
+// Operators
+
+template<typename T, typename U, typename A>
+bool operator==( const cw::xor_list<T,U,A>& lhs, const cw::xor_list<T,U,A>& rhs ) {
+	if( lhs.size() != rhs.size() ) return false;
+	return std::equal( lhs.begin(), lhs.end(), rhs.begin() );
+}
+
+template<typename T, typename U, typename A>
+bool operator!=( const cw::xor_list<T,U,A>& lhs, const cw::xor_list<T,U,A>& rhs ) {
+	return !(lhs == rhs);
+}
+
+template<typename T, typename U, typename A>
+bool operator<( const cw::xor_list<T,U,A>& lhs, const cw::xor_list<T,U,A>& rhs ) {
+	return std::lexicographical_compare( lhs.begin(), lhs.end(), rhs.begin(), rhs.end() );
+}
+
+template<typename T, typename U, typename A>
+bool operator>( const cw::xor_list<T,U,A>& lhs, const cw::xor_list<T,U,A>& rhs ) {
+	return rhs < lhs;
+}
+
+template<typename T, typename U, typename A>
+bool operator<=( const cw::xor_list<T,U,A>& lhs, const cw::xor_list<T,U,A>& rhs ) {
+	return !(rhs < lhs);
+}
+
+template<typename T, typename U, typename A>
+bool operator>=( const cw::xor_list<T,U,A>& lhs, const cw::xor_list<T,U,A>& rhs ) {
+	return !(lhs < rhs);
+}
+
+}
+
+namespace std {
+
+template<typename T, typename U, typename A>
+void swap( cw::xor_list<T,U,A>& lhs, cw::xor_list<T,U,A>& rhs ) {
+	lhs.swap(rhs);
+}
+
+}
+
+#if _MSC_VER <= 1800
+#undef noexcept
+#endif
+
+#endif
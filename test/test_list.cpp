@@ -1,9 +1,25 @@
 #include <iostream>
+#include <cstdio>
+#include <cstddef>
+#include <cstring>
 #include <algorithm>
 #include <numeric>
 #include <list>
+#include <forward_list>
 #include <random>
+#include <string>
+#include <sstream>
+#include <thread>
 #include <cw/list.h>
+#include <cw/list_algorithm.h>
+#include <cw/forward_list.h>
+#include <cw/xor_list.h>
+#include <cw/adaptive_list.h>
+#include <cw/unrolled_list.h>
+#include <cw/concurrent_queue.h>
+#include <cw/snapshot_list.h>
+#include <cw/mapped_list.h>
+#include <cw/list_io.h>
 
 using namespace std;
 using namespace cw;
@@ -196,10 +212,1719 @@ void test_sort() {
 		cout << "PASS: sort" << endl;
 }
 
+void test_sort_stable() {
+
+	using T = pair<uint16_t,uint16_t>;
+	size_t N = 32000;
+
+	mt19937 mt;
+	uniform_int_distribution<uint32_t> dist( 0, 255 );
+	cw::list32<T> c;
+	std::list<T> s;
+	for(size_t i=0;i<N;++i) {
+		T x( uint16_t(dist(mt)), uint16_t(i) );
+		c.push_back( x );
+		s.push_back( x );
+	}
+
+	auto comp = []( const T& a, const T& b ){ return a.first < b.first; };
+	c.sort( comp );
+	s.sort( comp );
+
+	if( !compare( c, s ) || !compare( s, c ) )
+		cout << "FAIL: sort stable" << endl;
+	else
+		cout << "PASS: sort stable" << endl;
+}
+
+void test_sort_by_key() {
+
+	using T = pair<int16_t,uint16_t>;
+	size_t N = 32000;
+
+	mt19937 mt;
+	uniform_int_distribution<int32_t> dist( -1000, 1000 );
+	cw::list32<T> c;
+	std::list<T> s;
+	for(size_t i=0;i<N;++i) {
+		T x( int16_t(dist(mt)), uint16_t(i) );
+		c.push_front( x );
+		s.push_front( x );
+	}
+
+	c.sort_by_key( []( const T& x ){ return x.first; } );
+	s.sort( []( const T& a, const T& b ){ return a.first < b.first; } );
+
+	if( !compare( c, s ) || !compare( s, c ) )
+		cout << "FAIL: sort by key" << endl;
+	else
+		cout << "PASS: sort by key" << endl;
+}
+
+void test_sort_compact() {
+
+	using T = pair<int16_t,uint16_t>;
+	size_t N = 32000;
+
+	mt19937 mt;
+	uniform_int_distribution<int32_t> dist( -1000, 1000 );
+	cw::list32<T> c1;
+	std::list<T> s;
+	for(size_t i=0;i<N;++i) {
+		T x( int16_t(dist(mt)), uint16_t(i) );
+		if( i % 2 ) {
+			c1.push_front( x );
+			s.push_front( x );
+		} else {
+			c1.push_back( x );
+			s.push_back( x );
+		}
+	}
+	auto c2 = c1;
+	auto c3 = c1;
+
+	auto comp = []( const T& a, const T& b ){ return a.first < b.first; };
+	c1.sort_compact( comp );
+	c2.sort_compact_by_key( []( const T& x ){ return x.first; } );
+	c3.sort_compact_by_key( []( const T& x ){ return double(x.first); } );
+	s.sort( comp );
+
+	bool pass = true;
+	for( auto c : { &c1, &c2, &c3 } ) {
+		pass = pass && c->size() == s.size() && compare( *c, s );
+		pass = pass && equal( begin(c->values), end(c->values), begin(s) );
+		pass = pass && c->head == 0 && c->tail == N - 1 && c->nodes[1].prev == 0 && c->nodes[1].next == 2;
+	}
+
+	if( !pass )
+		cout << "FAIL: sort compact" << endl;
+	else
+		cout << "PASS: sort compact" << endl;
+}
+
+// Counting allocator -- tracks the bytes currently allocated through it.
+
+template<typename T>
+struct counting_allocator {
+	using value_type = T;
+
+	size_t* bytes;
+
+	explicit counting_allocator( size_t* bytes ) : bytes(bytes) {}
+
+	template<typename T2>
+	counting_allocator( const counting_allocator<T2>& rhs ) : bytes(rhs.bytes) {}
+
+	T* allocate( size_t n ) {
+		*bytes += n * sizeof(T);
+		return std::allocator<T>().allocate(n);
+	}
+
+	void deallocate( T* p, size_t n ) {
+		*bytes -= n * sizeof(T);
+		std::allocator<T>().deallocate(p,n);
+	}
+};
+
+template<typename T1,typename T2>
+bool operator==( const counting_allocator<T1>& lhs, const counting_allocator<T2>& rhs ) {
+	return lhs.bytes == rhs.bytes;
+}
+
+template<typename T1,typename T2>
+bool operator!=( const counting_allocator<T1>& lhs, const counting_allocator<T2>& rhs ) {
+	return !(lhs == rhs);
+}
+
+void test_allocator() {
+
+	using T = uint32_t;
+	size_t N = 20000;
+
+	size_t bytes = 0;
+	bool pass = true;
+	{
+		using A = counting_allocator<T>;
+		cw::list<T,uint32_t,A> c{ A(&bytes) };
+		std::list<T> s;
+		mt19937 mt;
+		for(size_t i=0;i<N;++i) {
+			auto r = T(mt());
+			c.push_front( r );
+			s.push_front( r );
+		}
+		pass = pass && bytes >= N * ( sizeof(T) + 2 * sizeof(uint32_t) );
+
+		c.sort_compact();
+		s.sort();
+		pass = pass && compare( c, s ) && c.size() == s.size();
+	}
+	pass = pass && bytes == 0;
+
+#ifdef CW_LIST_PMR
+	{
+		std::pmr::monotonic_buffer_resource arena;
+		cw::pmr::list<T> c{ &arena };
+		auto s = create<std::list<T>,fill_back_random>( N );
+		c.assign( begin(s), end(s) );
+		c.sort();
+		s.sort();
+		pass = pass && compare( c, s ) && c.size() == s.size() && c.get_allocator().resource() == &arena;
+	}
+#endif
+
+	if( !pass )
+		cout << "FAIL: allocator" << endl;
+	else
+		cout << "PASS: allocator" << endl;
+}
+
+// Scatter -- insert and erase at random positions.
+
+template<typename L>
+void scatter( L& v, size_t N ) {
+	using T = typename L::value_type;
+	mt19937 mt;
+	for(size_t i=0;i<N;++i) {
+		auto pos = begin(v);
+		advance( pos, mt() % ( v.size() + 1 ) );
+		v.insert( pos, T(i) );
+		if( i % 3 == 0 ) {
+			pos = begin(v);
+			advance( pos, mt() % v.size() );
+			v.erase( pos );
+		}
+	}
+}
+
+void test_compact() {
+
+	using T = uint32_t;
+	size_t N = 4000;
+
+	cw::list32<T> c;
+	std::list<T> s;
+	scatter( c, N );
+	scatter( s, N );
+
+	c.compact();
+
+	bool linear = ( c.head == 0 ) && ( c.tail == c.size() - 1 );
+	for(size_t i=0;i<c.size();++i) {
+		linear = linear && ( c.nodes[i].prev == T(i-1) ) && ( c.nodes[i].next == ( i + 1 < c.size() ? T(i+1) : c.terminator ) );
+	}
+
+	cw::list32<T> a;
+	a.compact_ratio = 0.25;
+	scatter( a, N );
+
+	if( !linear || !compare( c, s ) || c.size() != s.size() || !compare( a, s ) || a.size() != s.size() )
+		cout << "FAIL: compact" << endl;
+	else
+		cout << "PASS: compact" << endl;
+}
+
+void test_stable_erase() {
+
+	using T = uint32_t;
+	size_t N = 4000;
+
+	cw::stable_list<T> c;
+	std::list<T> s;
+	scatter( c, N );
+	scatter( s, N );
+	bool reused = c.nodes.size() < N;
+
+	// erasing other elements leaves iterators and handles valid
+	auto it = std::next( begin(c), c.size() / 2 );
+	auto h = c.handle( it );
+	T x = *it;
+	c.remove_if( [=]( T y ){ return y % 2 == 1 && y != x; } );
+	s.remove_if( [=]( T y ){ return y % 2 == 1 && y != x; } );
+	bool stable = c.valid( h ) && c.iterator_to( h ) == it && *it == x;
+
+	// erasing the element invalidates its handle, even once the slot is reused
+	c.erase( it );
+	s.remove( x );
+	c.push_back( T(N) );
+	s.push_back( T(N) );
+	stable = stable && !c.valid( h ) && c.iterator_to( h ) == end(c);
+
+	cw::stable_list<T> r;
+	std::list<T> rs;
+	scatter( r, N / 4 );
+	scatter( rs, N / 4 );
+	c.sort();
+	s.sort();
+	r.sort();
+	rs.sort();
+	c.merge( r );
+	s.merge( rs );
+
+	bool ok = compare( c, s ) && c.size() == s.size();
+
+	c.compact();
+	ok = ok && compare( c, s ) && c.num_free() == 0 && c.nodes.size() == s.size();
+
+	if( !reused || !stable || !ok )
+		cout << "FAIL: stable erase" << endl;
+	else
+		cout << "PASS: stable erase" << endl;
+}
+
+void test_linear() {
+
+	using T = uint32_t;
+	size_t N = 1000;
+
+	vector<T> x( N );
+	iota( begin(x), end(x), T(0) );
+
+	cw::list32<T> a( x ), b;
+	b = x;
+	std::list<T> s( begin(x), end(x) );
+
+	bool ok = a.linear() && compare( a, s ) && equal( a.rbegin(), a.rend(), s.rbegin() );
+	ok = ok && ( a == b ) && !( a < b );
+
+	b.push_back( T(N) );
+	ok = ok && b.linear() && ( a < b ) && ( a != b );
+
+	b.push_front( T(N) );
+	ok = ok && !b.linear() && ( b != a ) && ( a < b );
+
+	b.compact();
+	ok = ok && b.linear() && std::equal( b.data(), b.data() + b.size(), begin(b) );
+
+	a.reverse();
+	s.reverse();
+	ok = ok && !a.linear() && compare( a, s );
+
+	if( !ok )
+		cout << "FAIL: linear" << endl;
+	else
+		cout << "PASS: linear" << endl;
+}
+
+template<typename L>
+bool check_ordered( L& c ) {
+	using T = typename L::value_type;
+	vector<T> x( begin(c), end(c) );
+	for( size_t d : { 0, 1, 16 } ) {
+		vector<T> y;
+		cw::for_each_ordered( c, [&]( const T& z ){ y.push_back(z); }, d );
+		if( x != y ) return false;
+	}
+	return true;
+}
+
+template<typename L>
+bool test_ordered_list( L& c ) {
+	using T = typename L::value_type;
+	mt19937 mt;
+	bool ok = check_ordered( c );
+
+	// linear, then scattered across pages by a relinking sort
+	for(size_t i=0;i<100000;++i) {
+		c.push_back( T( mt() ) );
+	}
+	ok = ok && check_ordered( c );
+	c.sort();
+	ok = ok && check_ordered( c );
+
+	// holes, and a few elements out of place
+	c.remove_if( []( T y ){ return y % 5 == 0; } );
+	c.push_front( T(1) );
+	c.insert( std::next( begin(c), 1000 ), T(2) );
+	ok = ok && check_ordered( c );
+
+	// values can be modified in place
+	cw::for_each_ordered( c, []( T& y ){ y = y / 2; } );
+	vector<T> x( begin(c), end(c) );
+	cw::for_each_ordered( c, []( T& y ){ y = y * 2; } );
+	return ok && std::equal( begin(c), end(c), begin(x), []( T a, T b ){ return a == b * 2; } );
+}
+
+void test_ordered() {
+
+	using T = uint32_t;
+
+	cw::list<T> a;
+	cw::stable_list<T> b;
+	bool ok = test_ordered_list( a ) && test_ordered_list( b );
+
+	cw::list32<T> c;
+	scatter( c, 1000 );
+	ok = ok && check_ordered( c );
+
+	if( !ok )
+		cout << "FAIL: ordered" << endl;
+	else
+		cout << "PASS: ordered" << endl;
+}
+
+template<typename L>
+bool test_insert_range_list( L& c ) {
+	using T = typename L::value_type;
+	mt19937 mt;
+	std::list<T> s;
+	bool ok = true;
+	for(int i=0;i<200 && ok;++i) {
+		size_t k = mt() % ( s.size() + 1 );
+		vector<T> x( mt() % 20 );
+		iota( begin(x), end(x), T(i * 100) );
+		switch( i % 4 ) {
+		case 0: {
+			auto r = c.insert( std::next( begin(c), k ), begin(x), end(x) );
+			auto q = s.insert( std::next( begin(s), k ), begin(x), end(x) );
+			ok = ( r == end(c) ) == ( q == end(s) ) && ( q == end(s) || *r == *q );
+			break;
+		}
+		case 1:
+			c.insert( std::next( begin(c), k ), x.size(), T(i) );
+			s.insert( std::next( begin(s), k ), x.size(), T(i) );
+			break;
+		case 2:
+			c.append_range( x );
+			s.insert( end(s), begin(x), end(x) );
+			break;
+		default:
+			c.erase( std::next( begin(c), k / 2 ), std::next( begin(c), k ) );
+			s.erase( std::next( begin(s), k / 2 ), std::next( begin(s), k ) );
+		}
+		ok = ok && compare( c, s );
+	}
+	return ok;
+}
+
+void test_insert_range() {
+
+	using T = int;
+
+	cw::list<T> a, b;
+	b.index_positions( true );
+	cw::stable_list<T> c;
+	bool ok = test_insert_range_list( a ) && test_insert_range_list( b ) && test_insert_range_list( c );
+
+	// appending to a linear list keeps it linear
+	cw::list<T> d;
+	d.assign( 3, 7 );
+	d.append_range( vector<T>{ 1, 2, 3 } );
+	d.insert( end(d), { 4, 5 } );
+	d.insert( end(d), 2, 6 );
+	ok = ok && d.linear() && compare( d, std::list<T>{ 7, 7, 7, 1, 2, 3, 4, 5, 6, 6 } );
+
+	// a range spliced from another list goes before pos
+	cw::list<T> e = { 10, 11, 12, 13 };
+	d.splice( std::next( begin(d), 2 ), e, std::next( begin(e) ), std::prev( end(e) ) );
+	ok = ok && compare( d, std::list<T>{ 7, 7, 11, 12, 7, 1, 2, 3, 4, 5, 6, 6 } ) && compare( e, std::list<T>{ 10, 13 } );
+
+	if( !ok )
+		cout << "FAIL: insert range" << endl;
+	else
+		cout << "PASS: insert range" << endl;
+}
+
+template<typename L>
+bool test_erase_range_list( L& c ) {
+	using T = typename L::value_type;
+	mt19937 mt;
+	std::list<T> s;
+	bool ok = true;
+	for(int i=0;i<300 && ok;++i) {
+		for(int j=0;j<20;++j) {
+			size_t k = mt() % ( s.size() + 1 );
+			c.insert( std::next( begin(c), k ), T(i * 20 + j) );
+			s.insert( std::next( begin(s), k ), T(i * 20 + j) );
+		}
+		size_t a = mt() % ( s.size() + 1 );
+		size_t b = a + mt() % ( s.size() - a + 1 );
+		auto r = c.erase( std::next( begin(c), a ), std::next( begin(c), b ) );
+		auto q = s.erase( std::next( begin(s), a ), std::next( begin(s), b ) );
+		ok = ( r == end(c) ) == ( q == end(s) ) && ( q == end(s) || *r == *q ) && compare( c, s );
+		if( i % 10 == 0 ) {
+			size_t n = mt() % ( s.size() + 1 );
+			c.resize( n );
+			s.resize( n );
+			ok = ok && compare( c, s );
+		}
+	}
+	c.erase( begin(c), end(c) );
+	return ok && c.empty();
+}
+
+void test_erase_range() {
+
+	using T = int;
+
+	cw::list<T> a, b;
+	b.index_positions( true );
+	b.compact_ratio = 0.5;
+	cw::stable_list<T> c;
+	bool ok = test_erase_range_list( a ) && test_erase_range_list( b ) && test_erase_range_list( c );
+
+	// truncating a linear list pops the back of the storage
+	cw::list<T> d = { 0, 1, 2, 3, 4, 5, 6, 7 };
+	d.resize( 5 );
+	d.erase( std::next( begin(d), 3 ), end(d) );
+	ok = ok && d.linear() && compare( d, std::list<T>{ 0, 1, 2 } );
+
+	if( !ok )
+		cout << "FAIL: erase range" << endl;
+	else
+		cout << "PASS: erase range" << endl;
+}
+
+template<typename L>
+bool test_remove_list( L& c ) {
+	using T = typename L::value_type;
+	mt19937 mt;
+	std::list<T> s;
+	for(int i=0;i<2000;++i) {
+		T x = T( mt() % 10 );
+		auto ci = begin(c);
+		auto si = begin(s);
+		size_t k = mt() % ( s.size() + 1 );
+		std::advance( ci, k );
+		std::advance( si, k );
+		c.insert( ci, x );
+		s.insert( si, x );
+	}
+	c.erase( std::next( begin(c), 10 ) );
+	s.erase( std::next( begin(s), 10 ) );
+
+	auto odd = []( T y ){ return y % 2 == 1; };
+	size_t n = s.size();
+	s.remove_if( odd );
+	bool ok = cw::erase_if( c, odd ) == n - s.size() && compare( c, s );
+
+	n = s.size();
+	s.remove( T(4) );
+	ok = ok && c.remove( T(4) ) == n - s.size() && compare( c, s );
+	ok = ok && cw::erase( c, T(5) ) == 0 && c.remove_if( odd ) == 0;
+
+	// the survivors are still usable
+	c.push_front( T(1) );
+	s.push_front( T(1) );
+	c.insert( std::next( begin(c), 3 ), T(3) );
+	s.insert( std::next( begin(s), 3 ), T(3) );
+	return ok && compare( c, s );
+}
+
+void test_remove() {
+
+	using T = int;
+
+	cw::list<T> a;
+	cw::stable_list<T> b;
+	bool ok = test_remove_list( a ) && test_remove_list( b );
+
+	// a linear list stays linear
+	cw::list<T> c = { 1, 2, 3, 4, 5, 6 };
+	cw::erase_if( c, []( T y ){ return y % 2 == 0; } );
+	ok = ok && c.linear() && compare( c, std::list<T>{ 1, 3, 5 } );
+
+	if( !ok )
+		cout << "FAIL: remove" << endl;
+	else
+		cout << "PASS: remove" << endl;
+}
+
+template<typename L>
+bool test_unique_list( L& c ) {
+	using T = typename L::value_type;
+	mt19937 mt;
+	std::list<T> s;
+	for(int i=0;i<2000;++i) {
+		T x = T( mt() % 4 );
+		if( i % 2 ) {
+			c.push_back( x );
+			s.push_back( x );
+		} else {
+			c.push_front( x );
+			s.push_front( x );
+		}
+	}
+	c.erase( std::next( begin(c), 10 ) );
+	s.erase( std::next( begin(s), 10 ) );
+
+	size_t n = s.size();
+	s.unique();
+	bool ok = c.unique() == n - s.size() && compare( c, s );
+
+	// runs of values within 1 of the first of the run
+	for( auto&& x : c ) x = T( mt() % 4 );
+	s.assign( begin(c), end(c) );
+	auto near = []( T x, T y ){ return y - x + 1 <= 2; };
+	c.unique( near );
+	s.unique( near );
+	return ok && compare( c, s );
+}
+
+void test_unique() {
+
+	using T = int;
+
+	cw::list<T> a;
+	cw::stable_list<T> b;
+	bool ok = test_unique_list( a ) && test_unique_list( b );
+
+	// a linear list stays linear
+	cw::list<T> c = { 1, 1, 2, 3, 3, 3, 1 };
+	c.unique();
+	ok = ok && c.linear() && compare( c, std::list<T>{ 1, 2, 3, 1 } );
+
+	if( !ok )
+		cout << "FAIL: unique" << endl;
+	else
+		cout << "PASS: unique" << endl;
+}
+
+// every position agrees with x, both ways
+template<typename L,typename T>
+bool check_positions( const L& c, const vector<T>& x ) {
+	if( c.size() != x.size() ) return false;
+	for(size_t i=0;i<x.size();++i) {
+		if( c[i] != x[i] || c.position_of( c.nth(i) ) != i ) return false;
+	}
+	// stepping by n agrees with the walk
+	for(size_t i=0;i<x.size();i+=7) {
+		auto it = c.nth(i);
+		auto n = std::ptrdiff_t( ( i * 13 ) % ( x.size() - i + 1 ) );
+		if( c.next( it, n ) != std::next( it, n ) || c.prev( std::next( it, n ), n ) != it ) return false;
+	}
+	return c.nth( x.size() ) == c.end() && c.position_of( c.end() ) == x.size() && c.prev( c.end(), std::ptrdiff_t( x.size() ) ) == c.begin();
+}
+
+template<typename L>
+bool test_positions_random( L& c ) {
+	using T = typename L::value_type;
+	mt19937 mt;
+	vector<T> x;
+	c.index_positions( true );
+	bool ok = true;
+
+	for(int i=0;i<3000 && ok;++i) {
+		size_t k = mt() % ( x.size() + 1 );
+		switch( mt() % 8 ) {
+		case 0: case 1: case 2:
+			c.insert( c.nth(k), T(i) );
+			x.insert( begin(x) + k, T(i) );
+			break;
+		case 3: case 4:
+			if( k < x.size() ) {
+				c.erase( c.nth(k) );
+				x.erase( begin(x) + k );
+			}
+			break;
+		case 5:
+			if( k + 1 < x.size() ) {
+				auto a = c.nth(k), b = c.nth(k + 1);
+				a.iter_swap( b );
+				swap( x[k], x[k + 1] );
+			}
+			break;
+		case 6:
+			if( i % 50 == 0 ) {
+				c.reverse();
+				reverse( begin(x), end(x) );
+			}
+			break;
+		default:
+			c.push_front( T(i) );
+			x.insert( begin(x), T(i) );
+		}
+		if( i % 100 == 0 ) {
+			ok = check_positions( c, x );
+		}
+	}
+
+	c.sort();
+	sort( begin(x), end(x) );
+	ok = ok && check_positions( c, x );
+
+	c.remove_if( []( T y ){ return y % 3 == 0; } );
+	x.erase( remove_if( begin(x), end(x), []( T y ){ return y % 3 == 0; } ), end(x) );
+	return ok && check_positions( c, x );
+}
+
+void test_positions() {
+
+	using T = uint32_t;
+	size_t N = 1000;
+
+	cw::list32<T> c;
+	scatter( c, N );
+	vector<T> x( begin(c), end(c) );
+
+	// unindexed, indexed and linear
+	bool ok = check_positions( c, x );
+	c.index_positions( true );
+	ok = ok && c.positions_indexed() && check_positions( c, x );
+	c.compact();
+	ok = ok && c.linear() && check_positions( c, x );
+
+	try {
+		c.at( N );
+		ok = false;
+	} catch( ... ) {}
+
+	cw::list32<T> a;
+	cw::stable_list<T> b;
+	ok = ok && test_positions_random( a ) && test_positions_random( b );
+
+	if( !ok )
+		cout << "FAIL: positions" << endl;
+	else
+		cout << "PASS: positions" << endl;
+}
+
+void test_parallel() {
+
+	using T = uint32_t;
+	size_t N = 100000;
+
+	cw::list32<T> c;
+	scatter( c, N );
+	vector<T> x( begin(c), end(c) );
+
+	// small grain so the test list is split across several threads
+	cw::parallel_policy p( 4, 1000 );
+	auto odd = []( T y ){ return y % 2 == 1; };
+
+	bool ok = cw::accumulate( p, c, uint64_t(0) ) == std::accumulate( begin(x), end(x), uint64_t(0) );
+	ok = ok && cw::reduce( p, c, T(0), []( T a, T b ){ return a ^ b; } ) == cw::reduce( c, T(0), []( T a, T b ){ return a ^ b; } );
+	ok = ok && cw::count_if( p, c, odd ) == std::count_if( begin(x), end(x), odd );
+	ok = ok && cw::count( p, c, x[N / 2] ) == std::count( begin(x), end(x), x[N / 2] );
+	ok = ok && cw::any_of( p, c, odd ) && !cw::all_of( p, c, odd ) && !cw::none_of( p, c, odd );
+	ok = ok && cw::all_of( p, c, [=]( T y ){ return y < T(N); } );
+	ok = ok && *cw::min_element( p, c ) == *std::min_element( begin(x), end(x) );
+	ok = ok && *cw::max_element( p, c ) == *std::max_element( begin(x), end(x) );
+	ok = ok && cw::max_element( p, c ) == cw::max_element( c );
+
+	cw::transform( p, c, []( T y ){ return y * 3; } );
+	cw::replace_if( p, c, odd, T(1) );
+	std::transform( begin(x), end(x), begin(x), []( T y ){ return y * 3; } );
+	std::replace_if( begin(x), end(x), odd, T(1) );
+	ok = ok && compare( c, x );
+
+	cw::fill( p, c, T(7) );
+	ok = ok && cw::count( c, T(7) ) == std::ptrdiff_t(c.size());
+
+	bool caught = false;
+	try {
+		cw::for_each( p, c, []( T ){ throw std::exception("test_parallel -- chunk failed"); } );
+	} catch( const std::exception& ) {
+		caught = true;
+	}
+
+	if( !ok || !caught )
+		cout << "FAIL: parallel" << endl;
+	else
+		cout << "PASS: parallel" << endl;
+}
+
+template<typename T>
+bool check_simd( size_t N ) {
+	mt19937 mt;
+	vector<T> x( N );
+	for( auto&& y : x ) {
+		y = T( mt() % 5 );
+		if( mt() % 7 == 0 ) y = T( mt() );
+	}
+	cw::list<T> c( x );
+	T key = x[ N / 3 ];
+
+	bool ok = cw::count( c, key ) == std::count( begin(x), end(x), key );
+	ok = ok && cw::count( c, 300 ) == std::count( begin(x), end(x), 300 );
+	ok = ok && std::distance( c.cbegin(), cw::find( c, key ) ) == std::distance( begin(x), std::find( begin(x), end(x), key ) );
+	ok = ok && std::distance( c.cbegin(), cw::find( c, T(99) ) ) == std::distance( begin(x), std::find( begin(x), end(x), T(99) ) );
+	ok = ok && *cw::min_element( c ) == *std::min_element( begin(x), end(x) );
+	ok = ok && *cw::max_element( c ) == *std::max_element( begin(x), end(x) );
+	ok = ok && cw::max_element( c ) == cw::max_element( cw::parallel_policy( 4, 100 ), c );
+	ok = ok && cw::accumulate( c, uint64_t(1) ) == std::accumulate( begin(x), end(x), uint64_t(1) );
+	ok = ok && cw::accumulate( c, T(0) ) == T( std::accumulate( begin(x), end(x), uint64_t(0) ) );
+
+	cw::replace( c, key, T(3) );
+	std::replace( begin(x), end(x), key, T(3) );
+	return ok && compare( c, x );
+}
+
+void test_simd() {
+
+	size_t N = 1001;
+	bool ok = true;
+
+	// every instruction set this machine supports, down to none
+	for( int i = int( cw::simd::isa::avx512 ); i >= 0; --i ) {
+		cw::simd::set_isa( cw::simd::isa(i) );
+		ok = ok && check_simd<uint8_t>( N ) && check_simd<int8_t>( N );
+		ok = ok && check_simd<uint16_t>( N ) && check_simd<int16_t>( N );
+		ok = ok && check_simd<uint32_t>( N ) && check_simd<int32_t>( N );
+		ok = ok && check_simd<uint64_t>( N ) && check_simd<int64_t>( N );
+	}
+	cw::simd::set_isa( cw::simd::supported_isa() );
+
+	// values without kernels take the standard algorithms
+	cw::list<std::string> w = { "pear", "apple", "quince", "apple" };
+	ok = ok && *cw::min_element( w ) == "apple" && *cw::max_element( w ) == "quince";
+	ok = ok && cw::min_element( w ) == cw::min_element( cw::parallel_policy( 2, 1 ), w );
+
+	if( !ok )
+		cout << "FAIL: simd" << endl;
+	else
+		cout << "PASS: simd" << endl;
+}
+
+template<typename L>
+bool test_layout_list( L& c ) {
+	using T = typename L::value_type;
+	mt19937 mt;
+	std::list<T> s;
+	for(int i=0;i<500;++i) {
+		T x = T( mt() % 100 );
+		size_t k = mt() % ( s.size() + 1 );
+		c.insert( std::next( begin(c), k ), x );
+		s.insert( std::next( begin(s), k ), x );
+	}
+	bool ok = compare( c, s );
+
+	c.sort();
+	s.sort();
+	c.unique();
+	s.unique();
+	ok = ok && compare( c, s );
+
+	L d = { T(5), T(50), T(500) };
+	std::list<T> t = { T(5), T(50), T(500) };
+	c.merge( d );
+	s.merge( t );
+	ok = ok && compare( c, s ) && d.empty();
+
+	L e = { T(1), T(2) };
+	c.splice( std::next( begin(c), 10 ), e );
+	s.splice( std::next( begin(s), 10 ), std::list<T>{ T(1), T(2) } );
+	c.reverse();
+	s.reverse();
+	ok = ok && compare( c, s );
+
+	c.erase( std::next( begin(c), 3 ), std::next( begin(c), 30 ) );
+	s.erase( std::next( begin(s), 3 ), std::next( begin(s), 30 ) );
+	c.pop_front();
+	s.pop_front();
+	ok = ok && compare( c, s );
+
+	L f( c );
+	c.compact();
+	ok = ok && c.linear() && compare( c, s ) && f == c && !( f < c );
+
+	c.sort_compact( greater<>() );
+	s.sort( greater<>() );
+	ok = ok && c.linear() && compare( c, s );
+
+	c.resize( 10 );
+	s.resize( 10 );
+	f.swap( c );
+	return ok && compare( f, s ) && f != c;
+}
+
+void test_layout() {
+
+	using T = int;
+
+	cw::aos_list<T> a;
+	cw::split_list<T> b;
+	cw::list<T,uint32_t,std::allocator<T>,cw::erase_stable,cw::layout_aos> c;
+	cw::list<std::string,uint16_t,std::allocator<std::string>,cw::erase_swap,cw::layout_aos> d;
+	bool ok = test_layout_list( a ) && test_layout_list( b ) && test_layout_list( c );
+
+	for(int i=0;i<100;++i) {
+		d.push_front( std::to_string(i) );
+	}
+	d.sort();
+	ok = ok && std::is_sorted( begin(d), end(d) ) && d.size() == 100;
+
+	cw::aos_list<T> e;
+	cw::split_list<T> f;
+	ok = ok && test_erase_range_list( e ) && test_erase_range_list( f );
+
+	cw::aos_list<T> g;
+	cw::split_list<T> h;
+	ok = ok && test_positions_random( g ) && test_positions_random( h );
+
+	cw::aos_list<uint32_t> x;
+	cw::split_list<uint32_t> y;
+	ok = ok && test_ordered_list( x ) && test_ordered_list( y );
+
+	if( !ok )
+		cout << "FAIL: layout" << endl;
+	else
+		cout << "PASS: layout" << endl;
+}
+
+void test_packed() {
+
+	using T = int;
+
+	bool ok = sizeof( cw::list_node<cw::uint24_index> ) == 6 &&
+	          sizeof( cw::list_node<cw::uint40_index> ) == 10 &&
+	          sizeof( cw::list_node<cw::uint48_index> ) == 12;
+
+	// the terminator and the largest index survive the round trip
+	cw::uint24_index p = uint32_t(-1), q = uint32_t(0xfffffe);
+	cw::uint48_index r = uint64_t(-1), t = uint64_t(0x123456789abc);
+	ok = ok && uint32_t(p) == uint32_t(-1) && uint32_t(q) == 0xfffffe;
+	ok = ok && uint64_t(r) == uint64_t(-1) && uint64_t(t) == 0x123456789abc;
+
+	cw::list24<T> a;
+	cw::list40<T> b;
+	cw::list48<T> c;
+	cw::list<T,cw::uint24_index,std::allocator<T>,cw::erase_stable,cw::layout_aos> d;
+	cw::list<T,cw::uint24_index,std::allocator<T>,cw::erase_swap,cw::layout_split> e;
+	ok = ok && test_layout_list( a ) && test_layout_list( b ) && test_layout_list( c );
+	ok = ok && test_layout_list( d ) && test_layout_list( e );
+	ok = ok && a.max_size() == 0xffffff && b.max_size() == 0xffffffffffull;
+
+	cw::list24<T> f;
+	cw::list48<T> g;
+	ok = ok && test_erase_range_list( f ) && test_positions_random( g );
+
+	cw::list24<uint32_t> h;
+	ok = ok && test_ordered_list( h );
+
+	// past the range of 16-bit links, scattered by front insertion
+	cw::list24<T> x;
+	std::list<T> y;
+	for(int i=0;i<70000;++i) {
+		if( i % 3 == 0 ) {
+			x.push_front(i);
+			y.push_front(i);
+		} else {
+			x.push_back(i);
+			y.push_back(i);
+		}
+	}
+	ok = ok && x.size() == y.size() && compare( x, y ) && std::equal( x.rbegin(), x.rend(), y.rbegin() );
+	ok = ok && cw::accumulate( x, int64_t(0) ) == std::accumulate( begin(y), end(y), int64_t(0) );
+
+	if( !ok )
+		cout << "FAIL: packed" << endl;
+	else
+		cout << "PASS: packed" << endl;
+}
+
+template<typename L1,typename L2>
+bool compare_forward( const L1& v1, const L2& v2 ) {
+	return v1.size() == size_t( std::distance( begin(v2), end(v2) ) ) && std::equal( begin(v1), end(v1), begin(v2) );
+}
+
+// How the random edits are spelled for a kind of list, and for the standard
+// list it is checked against. Position k is before the k-th element.
+struct list_edits {
+	template<typename C> static auto at( C& c, size_t k ) { return std::next( begin(c), k ); }
+	template<typename C,typename T> static auto insert( C& c, size_t k, T x ) { return c.insert( at( c, k ), x ); }
+	template<typename C> static auto erase( C& c, size_t k ) { return c.erase( at( c, k ) ); }
+	template<typename C,typename T> static void push_back( C& c, size_t, T x ) { c.push_back( x ); }
+	template<typename C> static void pop_back( C& c, size_t ) { c.pop_back(); }
+
+	// move the element at j of d, or the m elements from j, to position k of c
+	template<typename C> static void splice( C& c, size_t k, C& d, size_t j ) { c.splice( at( c, k ), d, at( d, j ) ); }
+	template<typename C> static void splice( C& c, size_t k, C& d, size_t j, size_t m ) { c.splice( at( c, k ), d, at( d, j ), at( d, j + m ) ); }
+
+	template<typename C,typename S> static bool same( const C& c, const S& s ) {
+		return c.size() == s.size() && compare( c, s ) && std::equal( c.rbegin(), c.rend(), s.rbegin() );
+	}
+
+	// a list without splice and merge leaves them out
+	template<typename C,typename S> static bool move( C&, S&, C&, S&, size_t, mt19937& ) { return true; }
+	template<typename C,typename S> static bool merge( C&, S&, C&, S& ) { return true; }
+};
+
+// a forward list edits after the element before position k
+struct forward_edits : list_edits {
+	template<typename C> static auto at( C& c, size_t k ) { return std::next( c.before_begin(), k ); }
+	template<typename C,typename T> static auto insert( C& c, size_t k, T x ) { return c.insert_after( at( c, k ), x ); }
+	template<typename C> static auto erase( C& c, size_t k ) { return c.erase_after( at( c, k ) ); }
+	template<typename C,typename T> static void push_back( C& c, size_t n, T x ) { c.insert_after( at( c, n ), x ); }
+	template<typename C> static void pop_back( C& c, size_t n ) { c.erase_after( at( c, n - 1 ) ); }
+
+	template<typename C> static void splice( C& c, size_t k, C& d, size_t j ) { c.splice_after( at( c, k ), d, at( d, j ) ); }
+	template<typename C> static void splice( C& c, size_t k, C& d, size_t j, size_t m ) { c.splice_after( at( c, k ), d, at( d, j ), at( d, j + m + 1 ) ); }
+
+	template<typename C,typename S> static bool same( const C& c, const S& s ) { return compare_forward( c, s ); }
+};
+
+// splices within the list, including onto itself and its neighbours, and from
+// a second list, which is merged in at the end
+template<typename Edits>
+struct with_splices : Edits {
+	template<typename C,typename S>
+	static void top_up( C& d, S& t ) {
+		for(int x=0;x<20;++x) {
+			d.push_front( typename C::value_type( -x ) );
+			t.push_front( typename C::value_type( -x ) );
+		}
+	}
+
+	template<typename C,typename S>
+	static bool move( C& c, S& s, C& d, S& t, size_t k, mt19937& mt ) {
+		size_t n = c.size();
+		if( mt() % 2 && n > 0 ) {
+			size_t j = mt() % n;
+			Edits::splice( c, k, c, j );
+			Edits::splice( s, k, s, j );
+			return true;
+		}
+		// a range in from d, or within c to a position outside it
+		bool within = mt() % 2 != 0;
+		if( !within && d.empty() ) {
+			top_up( d, t );
+		}
+		size_t N = within ? n : d.size();
+		size_t j = mt() % ( N + 1 );
+		size_t m = mt() % ( N - j + 1 );
+		if( within && k >= j && k <= j + m ) {
+			return true;
+		}
+		Edits::splice( c, k, within ? c : d, j, m );
+		Edits::splice( s, k, within ? s : t, j, m );
+		return Edits::same( d, t );
+	}
+
+	template<typename C,typename S>
+	static bool merge( C& c, S& s, C& d, S& t ) {
+		top_up( d, t );
+		d.sort();
+		t.sort();
+		c.merge( d );
+		s.merge( t );
+		return d.empty() && Edits::same( c, s );
+	}
+};
+
+// Random edits of c, mirrored on the standard list s and compared every 100
+// steps -- insertion and erasure at random positions, pushes and pops at either
+// end, splices where Edits has them, and a reversal every 1000 steps. Then
+// remove_if(), sort() and a merge.
+template<typename Edits,typename L,typename S>
+bool test_random_edits( L& c, S& s ) {
+	using T = typename L::value_type;
+	mt19937 mt;
+	L d;
+	S t;
+	bool ok = true;
+	for(int i=0;i<5000 && ok;++i) {
+		size_t n = c.size();
+		size_t k = mt() % ( n + 1 );
+		switch( mt() % 11 ) {
+		case 0: case 1: case 2:
+			ok = *Edits::insert( c, k, T(i) ) == T(i);
+			Edits::insert( s, k, T(i) );
+			break;
+		case 3: case 4:
+			if( k < n ) {
+				auto cn = Edits::erase( c, k );
+				auto sn = Edits::erase( s, k );
+				ok = ( cn == end(c) ) == ( sn == end(s) ) && ( cn == end(c) || *cn == *sn );
+			}
+			break;
+		case 5:
+			c.push_front( T(i) );
+			s.push_front( T(i) );
+			break;
+		case 6:
+			Edits::push_back( c, n, T(i) );
+			Edits::push_back( s, n, T(i) );
+			break;
+		case 7:
+			if( n > 0 ) {
+				c.pop_front();
+				s.pop_front();
+			}
+			break;
+		case 8:
+			if( n > 0 ) {
+				Edits::pop_back( c, n );
+				Edits::pop_back( s, n );
+			}
+			break;
+		default:
+			ok = Edits::move( c, s, d, t, k, mt );
+		}
+		if( i % 100 == 0 ) {
+			ok = ok && Edits::same( c, s );
+		}
+		if( i % 1000 == 0 ) {
+			c.reverse();
+			s.reverse();
+		}
+	}
+	ok = ok && Edits::same( c, s );
+
+	auto odd = []( T y ){ return y % 2 == 1; };
+	size_t removed = c.remove_if( odd );
+	s.remove_if( odd );
+	ok = ok && removed > 0 && Edits::same( c, s );
+
+	c.sort();
+	s.sort();
+	return ok && Edits::same( c, s ) && Edits::merge( c, s, d, t );
+}
+
+void test_forward_list() {
+
+	using T = int;
+
+	cw::forward_list<T> a;
+	cw::forward_list16<T> b;
+	std::forward_list<T> r, q;
+	bool ok = test_random_edits<with_splices<forward_edits>>( a, r ) && test_random_edits<with_splices<forward_edits>>( b, q );
+	a.unique();
+	r.unique();
+	a.reclaim();
+	ok = ok && a.free_count == 0 && a.nexts.size() == a.size() && compare_forward( a, r );
+
+	// merge and splice_after
+	cw::forward_list<T> c = { 1, 4, 7 }, d = { 2, 3, 8 };
+	std::forward_list<T> s = { 1, 4, 7 }, t = { 2, 3, 8 };
+	c.merge( d );
+	s.merge( t );
+	ok = ok && compare_forward( c, s ) && d.empty();
+	c.merge( c );
+	ok = ok && compare_forward( c, s ) && c.size() == 6;
+
+	cw::forward_list<T> e = { 10, 11, 12, 13 };
+	std::forward_list<T> u = { 10, 11, 12, 13 };
+	c.splice_after( c.begin(), e, e.begin() );
+	s.splice_after( s.begin(), u, u.begin() );
+	ok = ok && compare_forward( c, s ) && compare_forward( e, u );
+	c.splice_after( c.before_begin(), e, e.before_begin(), e.end() );
+	s.splice_after( s.before_begin(), u, u.before_begin(), u.end() );
+	ok = ok && compare_forward( c, s ) && e.empty();
+	cw::forward_list<T> f = { 20, 21 };
+	c.splice_after( std::next( c.begin(), 2 ), f );
+	s.splice_after( std::next( s.begin(), 2 ), std::forward_list<T>{ 20, 21 } );
+	ok = ok && compare_forward( c, s ) && f.empty();
+
+	// splice_after within the list moves the links, and is a no-op onto itself
+	cw::forward_list<std::string> w = { "a", "b", "c" };
+	w.splice_after( w.begin(), w, w.begin() );
+	w.splice_after( std::next( w.begin() ), w, w.begin() );
+	ok = ok && w == cw::forward_list<std::string>( { "a", "b", "c" } );
+	w.splice_after( w.before_begin(), w, w.begin() );
+	w.splice_after( std::next( w.begin(), 2 ), w, w.before_begin(), std::next( w.begin(), 2 ) );
+	ok = ok && w == cw::forward_list<std::string>( { "c", "b", "a" } ) && w.nexts.size() == 3;
+
+	// resize, range erase and insert
+	c.resize( 4 );
+	s.resize( 4 );
+	c.resize( 7, 5 );
+	s.resize( 7, 5 );
+	ok = ok && compare_forward( c, s );
+	c.erase_after( c.begin(), std::next( c.begin(), 4 ) );
+	s.erase_after( s.begin(), std::next( s.begin(), 4 ) );
+	c.insert_after( c.before_begin(), { 7, 8, 9 } );
+	s.insert_after( s.before_begin(), { 7, 8, 9 } );
+	ok = ok && compare_forward( c, s );
+
+	// a stack of pushes and pops at the front never leaves free slots
+	cw::forward_list<T> g;
+	for(int i=0;i<100;++i) g.push_front(i);
+	for(int i=0;i<60;++i) g.pop_front();
+	ok = ok && g.size() == 40 && g.free_count == 0 && g.front() == 39;
+
+	cw::forward_list<T> h( c );
+	ok = ok && h == c && !( h < c ) && h.size() == c.size();
+
+	if( !ok )
+		cout << "FAIL: forward list" << endl;
+	else
+		cout << "PASS: forward list" << endl;
+}
+
+void test_xor_list() {
+
+	using T = int;
+
+	cw::xor_list<T> a;
+	cw::xor_list16<T> b;
+	std::list<T> r, q;
+	bool ok = test_random_edits<list_edits>( a, r ) && test_random_edits<list_edits>( b, q );
+	ok = ok && a.free_count == 0 && a.links.size() == a.size() && b.free_count == 0;
+
+	// stepping back from end, and across a reversal
+	cw::xor_list<T> c = { 1, 2, 3, 4 };
+	auto it = c.end();
+	--it;
+	ok = ok && *it == 4 && *--it == 3 && *++it == 4;
+	c.reverse();
+	std::list<T> s = { 4, 3, 2, 1 };
+	ok = ok && compare( c, s ) && c.front() == 4 && c.back() == 1;
+
+	// range insert and erase, resize
+	c.insert( std::next( c.begin() ), { 7, 8, 9 } );
+	s.insert( std::next( s.begin() ), { 7, 8, 9 } );
+	ok = ok && compare( c, s );
+	c.erase( std::next( c.begin() ), std::next( c.begin(), 4 ) );
+	s.erase( std::next( s.begin() ), std::next( s.begin(), 4 ) );
+	ok = ok && compare( c, s );
+	c.resize( 2 );
+	s.resize( 2 );
+	c.resize( 5 );
+	s.resize( 5 );
+	ok = ok && compare( c, s );
+
+	// a deque of pushes and pops at the back never leaves free slots
+	cw::xor_list<T> g;
+	for(int i=0;i<100;++i) g.push_back(i);
+	for(int i=0;i<60;++i) g.pop_back();
+	ok = ok && g.size() == 40 && g.free_count == 0 && g.back() == 39;
+
+	// small values, where the links dominate the footprint
+	cw::xor_list<uint8_t,uint16_t> h;
+	for(int i=0;i<300;++i) h.push_front( uint8_t(i) );
+	ok = ok && h.size() == 300 && h.front() == uint8_t(299) && h.back() == 0;
+
+	cw::xor_list<T> e( c );
+	ok = ok && e == c && !( e < c ) && e.size() == c.size();
+
+	if( !ok )
+		cout << "FAIL: xor list" << endl;
+	else
+		cout << "PASS: xor list" << endl;
+}
+
+void test_adaptive_list() {
+
+	using T = int;
+
+	// random edits across the 8 to 16-bit boundary
+	cw::adaptive_list<T> a;
+	std::list<T> s;
+	bool ok = a.index_bytes() == 1 && test_random_edits<list_edits>( a, s ) && a.index_bytes() == 2;
+
+	// iterators survive a re-encode
+	auto it = std::next( begin(a), 10 );
+	T x = *it;
+	while( a.size() < 70000 ) {
+		a.push_back( T(a.size()) );
+		s.push_back( T(s.size()) );
+	}
+	ok = ok && a.index_bytes() == 4 && *it == x && compare( a, s );
+
+	// shrinking narrows the links again
+	a.erase( std::next( begin(a), 100 ), end(a) );
+	s.erase( std::next( begin(s), 100 ), end(s) );
+	a.shrink_to_fit();
+	ok = ok && a.index_bytes() == 1 && a.size() == 100 && compare( a, s );
+
+	a.sort();
+	s.sort();
+	a.reverse();
+	s.reverse();
+	ok = ok && compare( a, s ) && a.front() == s.front() && a.back() == s.back();
+
+	// the active list runs the list algorithms
+	T sum = a.visit( []( const auto& l ) { return std::accumulate( l.begin(), l.end(), T(0) ); } );
+	ok = ok && sum == std::accumulate( begin(s), end(s), T(0) );
+
+	// reserving widens up front
+	cw::adaptive_list<T> b = { 1, 2, 3 };
+	b.reserve( 1000 );
+	ok = ok && b.index_bytes() == 2 && b.size() == 3 && b.front() == 1;
+
+	cw::adaptive_list<T> c( a ), d;
+	ok = ok && c == a && !( c < a );
+	d = std::move( c );
+	ok = ok && d == a && c.empty();
+	std::swap( b, d );
+	ok = ok && b == a && d.size() == 3 && d.index_bytes() == 2;
+
+	if( !ok )
+		cout << "FAIL: adaptive list" << endl;
+	else
+		cout << "PASS: adaptive list" << endl;
+}
+
+void test_unrolled_list() {
+
+	using T = int;
+
+	cw::unrolled_list<T> a;
+	cw::unrolled_list<T,uint32_t,4> b;
+	cw::unrolled_list8<T,3> c8;
+	std::list<T> r, q;
+	bool ok = test_random_edits<with_splices<list_edits>>( a, r ) && test_random_edits<with_splices<list_edits>>( b, q );
+	ok = ok && b.blocks.size() == ( b.size() + 3 ) / 4;
+
+	// pushing at either end fills every block
+	cw::unrolled_list<T,uint32_t,4> c;
+	std::list<T> s;
+	for(int i=0;i<40;++i) {
+		c.push_front( i );
+		s.push_front( i );
+	}
+	for(int i=0;i<40;++i) {
+		c.push_back( -1 - i );
+		s.push_back( -1 - i );
+	}
+	ok = ok && c.blocks.size() == 20 && compare( c, s );
+
+	// midpoint insertion splits the blocks
+	for(int i=0;i<100;++i) {
+		c8.insert( std::next( c8.begin(), c8.size() / 2 ), i );
+	}
+	ok = ok && c8.size() == 100 && c8.max_size() == 255 * 3;
+
+	// range insert and erase, unique, resize
+	c.insert( std::next( c.begin(), 3 ), { 7, 7, 8, 9 } );
+	s.insert( std::next( s.begin(), 3 ), { 7, 7, 8, 9 } );
+	ok = ok && compare( c, s );
+	ok = ok && c.unique() == 1;
+	s.unique();
+	ok = ok && compare( c, s );
+	c.erase( std::next( c.begin() ), std::next( c.begin(), 30 ) );
+	s.erase( std::next( s.begin() ), std::next( s.begin(), 30 ) );
+	ok = ok && compare( c, s );
+	c.resize( 5 );
+	s.resize( 5 );
+	c.resize( 9, 4 );
+	s.resize( 9, 4 );
+	ok = ok && c.size() == 9 && compare( c, s ) && c.back() == 4;
+
+	// splice and merge move the values across
+	cw::unrolled_list<T,uint32_t,4> d = { 1, 3, 5, 7, 9 }, e = { 2, 4, 6 };
+	d.merge( e );
+	ok = ok && e.empty() && d == cw::unrolled_list<T,uint32_t,4>( { 1, 2, 3, 4, 5, 6, 7, 9 } );
+	e = { 10, 11 };
+	d.splice( d.begin(), e );
+	ok = ok && e.empty() && d.size() == 10 && d.front() == 10;
+
+	// splicing within the list, a value and a range, either way
+	cw::unrolled_list<T,uint32_t,4> g = { 1, 2, 3 };
+	g.splice( g.begin(), g, std::next( g.begin(), 2 ) );
+	ok = ok && g == cw::unrolled_list<T,uint32_t,4>( { 3, 1, 2 } );
+	g.splice( g.begin(), g, g.begin() );
+	g.splice( g.end(), g, g.begin() );
+	ok = ok && g == cw::unrolled_list<T,uint32_t,4>( { 1, 2, 3 } );
+	g.insert( g.end(), { 4, 5, 6, 7, 8, 9 } );
+	g.splice( std::next( g.begin() ), g, std::next( g.begin(), 4 ), std::next( g.begin(), 8 ) );
+	g.splice( g.end(), g, g.begin(), std::next( g.begin(), 3 ) );
+	ok = ok && g == cw::unrolled_list<T,uint32_t,4>( { 7, 8, 2, 3, 4, 9, 1, 5, 6 } );
+
+	// stepping back from end
+	auto it = d.end();
+	--it;
+	ok = ok && *it == 9 && *--it == 7 && *++it == 9;
+
+	cw::unrolled_list<T,uint32_t,4> f( d );
+	d.compact();
+	ok = ok && f == d && !( f < d ) && d.blocks.size() == 3;
+
+	if( !ok )
+		cout << "FAIL: unrolled list" << endl;
+	else
+		cout << "PASS: unrolled list" << endl;
+}
+
+void test_concurrent_queue() {
+
+	// first in, first out, bounded by the capacity
+	cw::concurrent_queue<std::string> q( 3 );
+	bool ok = q.empty() && q.capacity() == 3;
+	ok = ok && q.push_back( "a" ) && q.push_back( "b" ) && q.emplace_back( 2, 'c' ) && !q.push_back( "d" );
+	std::string x;
+	ok = ok && q.pop_front( x ) && x == "a" && q.push_back( "e" );
+	ok = ok && q.pop_front( x ) && x == "b" && q.pop_front( x ) && x == "cc" && q.pop_front( x ) && x == "e";
+	ok = ok && !q.pop_front( x ) && q.empty();
+
+	// the slots cycle through the free list many times over
+	cw::concurrent_queue<int,uint16_t> r( 5 );
+	std::list<int> s;
+	mt19937 mt;
+	for(int i=0;i<10000 && ok;++i) {
+		if( mt() % 2 ) {
+			ok = r.push_back( i ) == ( s.size() < 5 );
+			if( s.size() < 5 ) s.push_back( i );
+		} else {
+			int y = 0;
+			ok = r.pop_front( y ) == !s.empty() && ( s.empty() || y == s.front() );
+			if( !s.empty() ) s.pop_front();
+		}
+	}
+
+	// several producers and consumers. every value arrives once, and each
+	// consumer sees the values of one producer in the order they were pushed.
+	const int producers = 4, consumers = 4, n = 20000;
+	cw::concurrent_queue<uint32_t> c( 256 );
+	std::atomic<int> popped( 0 );
+	std::atomic<uint64_t> sum( 0 );
+	std::atomic<bool> ordered( true );
+	vector<std::thread> threads;
+	for(int p=0;p<producers;++p) {
+		threads.emplace_back( [&c,p]{
+			for(uint32_t i=0;i<n;++i) {
+				while( !c.push_back( ( uint32_t(p) << 24 ) | i ) ) {
+					std::this_thread::yield();
+				}
+			}
+		});
+	}
+	for(int k=0;k<consumers;++k) {
+		threads.emplace_back( [&]{
+			vector<int64_t> last( producers, -1 );
+			uint32_t y;
+			while( popped.load() < producers * n ) {
+				if( !c.pop_front( y ) ) {
+					std::this_thread::yield();
+					continue;
+				}
+				int64_t seq = y & 0xFFFFFF;
+				if( seq <= last[ y >> 24 ] ) ordered = false;
+				last[ y >> 24 ] = seq;
+				sum += y;
+				++popped;
+			}
+		});
+	}
+	for( auto& t : threads ) t.join();
+	uint64_t expected = 0;
+	for(int p=0;p<producers;++p)
+		for(uint32_t i=0;i<n;++i)
+			expected += ( uint32_t(p) << 24 ) | i;
+	ok = ok && popped == producers * n && sum == expected && ordered && c.empty();
+
+	if( !ok )
+		cout << "FAIL: concurrent queue" << endl;
+	else
+		cout << "PASS: concurrent queue" << endl;
+}
+
+void test_snapshot_list() {
+
+	// a snapshot keeps its version after an update, and pins it until it goes
+	cw::snapshot_list<int> s( cw::list<int>{ 1, 2, 3 }, 2 );
+	bool ok = true;
+	{
+		auto a = s.read();
+		s.update( []( cw::list<int>& l ) {
+			l.push_back( 4 );
+			l.pop_front();
+		});
+		auto b = s.read();
+		ok = ok && *a == cw::list<int>{ 1, 2, 3 } && *b == cw::list<int>{ 2, 3, 4 };
+		ok = ok && s.reclaim() == 1;
+
+		// both slots are taken
+		bool threw = false;
+		try {
+			s.read();
+		} catch( const std::exception& ) {
+			threw = true;
+		}
+		ok = ok && threw;
+	}
+	ok = ok && s.reclaim() == 0;
+	s.assign( cw::list<int>{ 5 } );
+	ok = ok && s.read()->front() == 5 && s.reclaim() == 0;
+
+	// readers never see a half-applied batch while a writer keeps rewriting it
+	const int readers = 4, n = 20000;
+	cw::snapshot_list<uint32_t> c( cw::list<uint32_t>( 100 ), readers );
+	std::atomic<bool> consistent( true );
+	std::atomic<int> finished( 0 );
+	vector<std::thread> threads;
+	for(int r=0;r<readers;++r) {
+		threads.emplace_back( [&]{
+			for(int i=0;i<n;++i) {
+				auto v = c.read();
+				if( v.size() != 100 || std::count( v.begin(), v.end(), *v.begin() ) != 100 ) {
+					consistent = false;
+				}
+			}
+			++finished;
+		});
+	}
+	for(uint32_t k=1;finished.load()<readers;++k) {
+		c.update( [k]( cw::list<uint32_t>& l ) {
+			for( auto& x : l ) x = k;
+		});
+	}
+	for( auto& t : threads ) t.join();
+	ok = ok && consistent && c.reclaim() == 0;
+
+	if( !ok )
+		cout << "FAIL: snapshot list" << endl;
+	else
+		cout << "PASS: snapshot list" << endl;
+}
+
+void test_mapped_list() {
+	const char* path = "test_mapped_list.bin";
+	std::remove( path );
+
+	// the list is where it was left when the file is reopened
+	bool ok = true;
+	{
+		cw::mapped_list<int> l( path );
+		ok = ok && l.empty() && l.capacity() == 0;
+		l.push_back( 2 );
+		l.push_back( 3 );
+		l.push_front( 1 );
+		auto it = l.insert( std::next( l.begin() ), 5 );
+		ok = ok && *it == 5;
+		l.erase( it );
+		l.sync();
+	}
+	std::list<int> s;
+	{
+		cw::mapped_list<int> l( path );
+		ok = ok && std::equal( l.begin(), l.end(), std::begin( { 1, 2, 3 } ) ) && l.size() == 3;
+		ok = ok && std::equal( l.rbegin(), l.rend(), std::begin( { 3, 2, 1 } ) );
+
+		// the file grows and is remapped many times over
+		s.assign( l.begin(), l.end() );
+		mt19937 mt;
+		for(int i=0;i<100000 && ok;++i) {
+			unsigned r = mt() % 10;
+			if( r < 4 ) {
+				l.push_back( i );
+				s.push_back( i );
+			} else if( r < 6 ) {
+				l.push_front( i );
+				s.push_front( i );
+			} else if( r < 7 && !s.empty() ) {
+				l.pop_front();
+				s.pop_front();
+			} else if( r < 8 && !s.empty() ) {
+				l.pop_back();
+				s.pop_back();
+			} else if( !s.empty() ) {
+				size_t k = mt() % s.size();
+				size_t n = std::min<size_t>( mt() % 4, s.size() - k );
+				auto a = std::next( l.begin(), k );
+				auto x = std::next( s.begin(), k );
+				auto b = l.erase( a, std::next( a, n ) );
+				auto y = s.erase( x, std::next( x, n ) );
+				ok = ok && ( ( y == s.end() ) ? b == l.end() : *b == *y );
+			}
+		}
+		ok = ok && l.size() == s.size() && std::equal( l.begin(), l.end(), s.begin() );
+	}
+	{
+		cw::mapped_list<int> l( path );
+		ok = ok && l.size() == s.size() && std::equal( l.begin(), l.end(), s.begin() );
+
+		// compacted and shrunk to fit, the file holds the values in list order
+		l.compact();
+		l.shrink_to_fit();
+		ok = ok && l.capacity() == l.size() && std::equal( s.begin(), s.end(), l.data() );
+
+		// a value of the list itself survives the remap as the full file grows
+		l.push_back( l.front() );
+		s.push_back( s.front() );
+		l.shrink_to_fit();
+		l.push_front( l.back() );
+		s.push_front( s.back() );
+		ok = ok && l.size() == s.size() && std::equal( l.begin(), l.end(), s.begin() );
+
+		// a file of another value type is refused
+		bool threw = false;
+		try {
+			cw::mapped_list<int64_t> w( path );
+		} catch( const std::exception& ) {
+			threw = true;
+		}
+		ok = ok && threw;
+	}
+	std::remove( path );
+
+	if( !ok )
+		cout << "FAIL: mapped list" << endl;
+	else
+		cout << "PASS: mapped list" << endl;
+}
+
+// length-prefixed strings, for a list_io codec
+struct string_codec {
+	void write( std::ostream& out, const std::string& x ) {
+		uint32_t n = uint32_t( x.size() );
+		out.write( reinterpret_cast<const char*>(&n), sizeof(n) );
+		out.write( x.data(), n );
+	}
+
+	std::string read( std::istream& in ) {
+		uint32_t n = 0;
+		in.read( reinterpret_cast<char*>(&n), sizeof(n) );
+		std::string x( n, ' ' );
+		in.read( &x[0], n );
+		return x;
+	}
+};
+
+template<typename L>
+bool test_save_load() {
+	// scattered, so a file in storage order carries the nodes
+	L l;
+	mt19937 mt;
+	for(int i=0;i<10000;++i) {
+		if( mt() % 3 ) {
+			l.push_back( i % 100 );
+		} else {
+			l.push_front( i % 100 );
+		}
+	}
+	bool ok = !l.linear();
+
+	// storage order keeps the layout as it was
+	{
+		stringstream ss;
+		cw::save( ss, l );
+		L m;
+		cw::load( ss, m );
+		ok = ok && m == l && !m.linear() && m.head == l.head && m.tail == l.tail;
+
+		// the scattered count comes from the links, not the header
+		std::string bytes = ss.str();
+		uint64_t scattered = 0;
+		std::memcpy( &bytes[ offsetof( cw::list_file_header, scattered ) ], &scattered, sizeof(scattered) );
+		stringstream unscattered( bytes );
+		cw::load( unscattered, m );
+		ok = ok && m == l && !m.linear();
+	}
+
+	// list order loads as a straight chain
+	{
+		stringstream ss;
+		cw::save( ss, l, cw::save_order::list );
+		L m;
+		m.push_back( 1 );
+		cw::load( ss, m );
+		ok = ok && m == l && m.linear();
+
+		// and streams back in list order, a chunk at a time
+		ss.clear();
+		ss.seekg( 0 );
+		vector<typename L::value_type> v;
+		size_t chunks = 0;
+		size_t n = cw::load_chunks<typename L::value_type>( ss, [&]( const typename L::value_type* first, const typename L::value_type* last ) {
+			v.insert( v.end(), first, last );
+			++chunks;
+		}, 1000 );
+		ok = ok && n == l.size() && chunks == 10 && std::equal( v.begin(), v.end(), l.begin() );
+	}
+
+	// a truncated file throws
+	{
+		stringstream ss;
+		cw::save( ss, l );
+		std::string bytes = ss.str();
+		stringstream truncated( bytes.substr( 0, bytes.size() - 1 ) );
+		L m;
+		bool threw = false;
+		try {
+			cw::load( truncated, m );
+		} catch( const std::exception& ) {
+			threw = true;
+		}
+		ok = ok && threw;
+	}
+
+	// a link or a head out of range, or links that don't form one chain, throw.
+	// a bad head is caught before the list is touched, the others leave it empty
+	{
+		stringstream ss;
+		cw::save( ss, l );
+		std::string bad_link = ss.str(), bad_head = ss.str(), bad_chain = ss.str();
+		bad_link.back() = char(0x7F);
+		uint64_t head = l.size();
+		std::memcpy( &bad_head[ offsetof( cw::list_file_header, head ) ], &head, sizeof(head) );
+		// the next link of the last slot to itself
+		typename L::link_type loop = typename L::index_type( l.size() - 1 );
+		std::memcpy( &bad_chain[ bad_chain.size() - sizeof(loop) ], &loop, sizeof(loop) );
+		for( const std::string& bytes : { bad_link, bad_head, bad_chain } ) {
+			stringstream corrupt( bytes );
+			L m;
+			m.push_back( 1 );
+			bool threw = false;
+			try {
+				cw::load( corrupt, m );
+			} catch( const std::exception& ) {
+				threw = true;
+			}
+			ok = ok && threw && m.size() == ( bytes == bad_head ? 1 : 0 );
+		}
+	}
+
+	return ok;
+}
+
+void test_list_io() {
+	bool ok = test_save_load<cw::list<int>>();
+	ok = ok && test_save_load<cw::aos_list<int,uint16_t>>();
+	ok = ok && test_save_load<cw::split_list<int>>();
+	ok = ok && test_save_load<cw::list24<int>>();
+
+	// a file of another value type is refused
+	{
+		stringstream ss;
+		cw::save( ss, cw::list<int>{ 1, 2, 3 } );
+		cw::list<int64_t> m;
+		bool threw = false;
+		try {
+			cw::load( ss, m );
+		} catch( const std::exception& ) {
+			threw = true;
+		}
+		ok = ok && threw;
+	}
+
+	// values that aren't trivially copyable go through a codec
+	{
+		cw::list<std::string> l{ "a", "", "hello" };
+		l.push_front( "first" );
+		stringstream ss;
+		cw::save( ss, l, string_codec() );
+		cw::list<std::string> m;
+		cw::load( ss, m, string_codec() );
+		ok = ok && m == l && m.linear();
+	}
+
+	if( !ok )
+		cout << "FAIL: list io" << endl;
+	else
+		cout << "PASS: list io" << endl;
+}
+
 int main() {
 	test_merge();
 	test_splice();
 	test_sort();
+	test_sort_stable();
+	test_sort_by_key();
+	test_sort_compact();
+	test_compact();
+	test_allocator();
+	test_stable_erase();
+	test_linear();
+	test_insert_range();
+	test_erase_range();
+	test_remove();
+	test_unique();
+	test_positions();
+	test_ordered();
+	test_layout();
+	test_packed();
+	test_forward_list();
+	test_xor_list();
+	test_adaptive_list();
+	test_unrolled_list();
+	test_concurrent_queue();
+	test_snapshot_list();
+	test_mapped_list();
+	test_list_io();
+	test_parallel();
+	test_simd();
 	cout << "Finished "; cin.get();
 }
 